@@ -12,6 +12,49 @@ struct Sentence
 	std::optional<std::vector<kiwi::TokenInfo>> tokens;
 };
 
+struct ColumnarTokens
+{
+	std::u16string forms;
+	std::vector<uint32_t> formOffsets;
+	std::vector<uint32_t> positions;
+	std::vector<uint32_t> wordPositions;
+	std::vector<uint32_t> sentPositions;
+	std::vector<uint32_t> lineNumbers;
+	std::vector<uint16_t> lengths;
+	std::vector<uint8_t> tags;
+	std::vector<uint8_t> senseIds;
+	std::vector<float> scores;
+	std::vector<float> typoCosts;
+	std::vector<uint32_t> typoFormIds;
+	std::vector<uint32_t> pairedTokens;
+	std::vector<uint32_t> subSentPositions;
+	std::vector<uint32_t> resultOffsets;
+	std::vector<float> resultScores;
+
+	ColumnarTokens() = default;
+
+	ColumnarTokens(kiwi::ColumnarTokenResult&& o)
+		: forms{ std::move(o.formPool) },
+		formOffsets{ std::move(o.formOffsets) },
+		positions{ std::move(o.positions) },
+		wordPositions{ std::move(o.wordPositions) },
+		sentPositions{ std::move(o.sentPositions) },
+		lineNumbers{ std::move(o.lineNumbers) },
+		lengths{ std::move(o.lengths) },
+		tags(o.tags.size()),
+		senseIds{ std::move(o.senseIds) },
+		scores{ std::move(o.scores) },
+		typoCosts{ std::move(o.typoCosts) },
+		typoFormIds{ std::move(o.typoFormIds) },
+		pairedTokens{ std::move(o.pairedTokens) },
+		subSentPositions{ std::move(o.subSentPositions) },
+		resultOffsets{ std::move(o.resultOffsets) },
+		resultScores{ std::move(o.resultScores) }
+	{
+		std::transform(o.tags.begin(), o.tags.end(), tags.begin(), [](kiwi::POSTag t) { return (uint8_t)t; });
+	}
+};
+
 struct JoinableToken
 {
 	std::u16string form;
@@ -46,6 +89,24 @@ static auto gClsTokenResult = jni::DataClassDefinition<kiwi::TokenResult>()
 	.template property<&kiwi::TokenResult::first>("tokens")
 	.template property<&kiwi::TokenResult::second>("score");
 
+static auto gClsColumnarTokens = jni::DataClassDefinition<ColumnarTokens>()
+	.template property<&ColumnarTokens::forms>("forms")
+	.template property<&ColumnarTokens::formOffsets>("formOffsets")
+	.template property<&ColumnarTokens::positions>("positions")
+	.template property<&ColumnarTokens::wordPositions>("wordPositions")
+	.template property<&ColumnarTokens::sentPositions>("sentPositions")
+	.template property<&ColumnarTokens::lineNumbers>("lineNumbers")
+	.template property<&ColumnarTokens::lengths>("lengths")
+	.template property<&ColumnarTokens::tags>("tags")
+	.template property<&ColumnarTokens::senseIds>("senseIds")
+	.template property<&ColumnarTokens::scores>("scores")
+	.template property<&ColumnarTokens::typoCosts>("typoCosts")
+	.template property<&ColumnarTokens::typoFormIds>("typoFormIds")
+	.template property<&ColumnarTokens::pairedTokens>("pairedTokens")
+	.template property<&ColumnarTokens::subSentPositions>("subSentPositions")
+	.template property<&ColumnarTokens::resultOffsets>("resultOffsets")
+	.template property<&ColumnarTokens::resultScores>("resultScores");
+
 static auto gClsSentence = jni::DataClassDefinition<Sentence>()
 	.template property<&Sentence::text>("text")
 	.template property<&Sentence::start>("start")
@@ -185,6 +246,17 @@ namespace jni
 	{
 	};
 
+	template<>
+	struct JClassName<ColumnarTokens>
+	{
+		static constexpr auto value = std::string_view{ "kr/pe/bab2min/Kiwi$ColumnarTokenResult" };
+	};
+
+	template<>
+	struct ValueBuilder<ColumnarTokens> : public ValueBuilder<decltype(gClsColumnarTokens)>
+	{
+	};
+
 	template<>
 	struct JClassName<Sentence>
 	{
@@ -354,6 +426,18 @@ public:
 		return Kiwi::analyze(text, topN, matchOption, blocklist ? &blocklist->morphSet : nullptr, pretokenizedSpans);
 	}
 
+	ColumnarTokens analyzeColumnar(const std::u16string& text, uint64_t topN, kiwi::Match matchOption, JMorphemeSet* blocklist, jni::JIterator<kiwi::PretokenizedSpan> pretokenized) const
+	{
+		std::vector<kiwi::PretokenizedSpan> pretokenizedSpans;
+		if (pretokenized)
+		{
+			while (pretokenized.hasNext()) pretokenizedSpans.emplace_back(pretokenized.next());
+		}
+		kiwi::ColumnarTokenResult ret;
+		Kiwi::analyze(text, ret, topN, matchOption, blocklist ? &blocklist->morphSet : nullptr, pretokenizedSpans);
+		return ColumnarTokens{ std::move(ret) };
+	}
+
 	JFutureTokenResult asyncAnalyze(jni::JRef<JKiwi> _ref, const std::u16string& text, uint64_t topN, kiwi::Match matchOption, JMorphemeSet* blocklist, jni::JIterator<kiwi::PretokenizedSpan> pretokenized) const
 	{
 		std::vector<kiwi::PretokenizedSpan> pretokenizedSpans;
@@ -587,12 +671,14 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved)
 			.template method<&JKiwi::getVersion>("getVersion")
 			.template method<&JKiwi::analyze>("analyze")
 			.template method<&JKiwi::analyze2>("analyze")
+			.template method<&JKiwi::analyzeColumnar>("analyzeColumnar")
 			.template method<&JKiwi::asyncAnalyze>("asyncAnalyze")
 			.template method<&JKiwi::splitIntoSents>("splitIntoSents")
 			.template method<&JKiwi::join>("join"),
 
 		gClsTokenInfo,
 		gClsTokenResult,
+		gClsColumnarTokens,
 		gClsSentence,
 		gClsJoinableToken,
 		gClsAnalyzedMorph,
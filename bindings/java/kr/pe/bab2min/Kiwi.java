@@ -173,6 +173,37 @@ public class Kiwi implements AutoCloseable  {
 		public float score;
 	}
 
+	public static class ColumnarTokenResult {
+		public String forms;
+		public int[] formOffsets;
+		public int[] positions;
+		public int[] wordPositions;
+		public int[] sentPositions;
+		public int[] lineNumbers;
+		public short[] lengths;
+		public byte[] tags;
+		public byte[] senseIds;
+		public float[] scores;
+		public float[] typoCosts;
+		public int[] typoFormIds;
+		public int[] pairedTokens;
+		public int[] subSentPositions;
+		public int[] resultOffsets;
+		public float[] resultScores;
+
+		public int size() {
+			return resultScores.length;
+		}
+
+		public int tokenSize() {
+			return positions.length;
+		}
+
+		public String form(int token) {
+			return forms.substring(formOffsets[token], formOffsets[token + 1]);
+		}
+	}
+
 	public static class FutureTokenResult implements Future<TokenResult[]>, AutoCloseable {
 		private long _inst;
 
@@ -381,6 +412,7 @@ public class Kiwi implements AutoCloseable  {
 	}
 
 	public native TokenResult[] analyze(String text, int topN, int matchOption, MorphemeSet blocklist, Iterator<PretokenizedSpan> pretokenized);
+	public native ColumnarTokenResult analyzeColumnar(String text, int topN, int matchOption, MorphemeSet blocklist, Iterator<PretokenizedSpan> pretokenized);
 	public native FutureTokenResult asyncAnalyze(String text, int topN, int matchOption, MorphemeSet blocklist, Iterator<PretokenizedSpan> pretokenized);
 	public native MultipleTokenResult analyze(Iterator<String> texts, int topN, int matchOption, MorphemeSet blocklist, Iterator<Iterator<PretokenizedSpan>> pretokenized);
 	public native Sentence[] splitIntoSents(String text, int matchOption, boolean returnTokens);
@@ -396,6 +428,14 @@ public class Kiwi implements AutoCloseable  {
 		return analyze(text, topN, matchOption, null);
 	}
 
+	public ColumnarTokenResult analyzeColumnar(String text, int topN, int matchOption, MorphemeSet blocklist) {
+		return analyzeColumnar(text, topN, matchOption, blocklist, null);
+	}
+
+	public ColumnarTokenResult analyzeColumnar(String text, int topN, int matchOption) {
+		return analyzeColumnar(text, topN, matchOption, null);
+	}
+
 	public FutureTokenResult asyncAnalyze(String text, int topN, int matchOption, MorphemeSet blocklist) {
 		return asyncAnalyze(text, topN, matchOption, blocklist, null);
 	}
@@ -20,6 +20,13 @@ namespace kiwi
 
 	ArchType getBestArch();
 
+	/**
+	 * @brief 현재 기기에서 사용 가능한 ArchType들의 탐색 커널 속도를 직접 측정하여 가장 빠른 ArchType을 반환한다.
+	 * @details 측정은 최초 호출 시에 한 번만 수행되며 이후에는 그 결과를 재사용한다.
+	 * 환경변수 `KIWI_ARCH_TYPE`을 `auto`로 설정하면 기본 ArchType 대신 이 함수의 결과가 사용된다.
+	 */
+	ArchType getTunedArch();
+
 	ArchType getSelectedArch(ArchType arch);
 
 	const char* archToStr(ArchType arch);
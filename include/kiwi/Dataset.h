@@ -46,7 +46,7 @@ namespace kiwi
 
 		HiddenMember<RaggedVector<uint32_t>, sizeof(Vector<size_t>) * 2> sents;
 		std::shared_ptr<lm::KnLangModelBase> knlm;
-		std::unique_ptr<utils::ThreadPool> workers;
+		std::shared_ptr<utils::ThreadPool> workers;
 		std::shared_ptr<KiwiBuilder> dummyBuilder;
 		std::discrete_distribution<> dropout;
 		std::bernoulli_distribution dropoutOnHistory;
@@ -6,6 +6,7 @@
 #include <memory>
 #include <algorithm>
 #include <numeric>
+#include <iosfwd>
 #include <kiwi/ArchUtils.h>
 #include <kiwi/Trie.hpp>
 
@@ -13,6 +14,8 @@ namespace kiwi
 {
 	namespace utils
 	{
+		class ThreadPool;
+
 		namespace detail
 		{
 			template<class Value, class = void>
@@ -64,6 +67,107 @@ namespace kiwi
 					return t.val;
 				}
 			};
+
+			/**
+			 * @brief 자식이 매우 많은 노드에 대해 키로 바로 자식을 찾을 수 있는 직접 참조 테이블.
+			 * @details 노드마다 키 구간 [first, first + size) 하나를 배열로 펼쳐두고 자식까지의 거리를 저장한다.
+			 * 구간 안의 키는 배열 한 번 참조로 탐색이 끝나며, 구간 밖의 키는 기존의 정렬된 키 탐색으로 처리한다.
+			 * 전체 배열의 크기는 빌드할 때 지정한 메모리 예산을 넘지 않는다.
+			 */
+			template<class Key, class Diff>
+			class DirectTransitions
+			{
+				struct Entry
+				{
+					size_t node;
+					size_t first;
+					size_t size;
+					size_t offset;
+				};
+
+				static constexpr size_t maxEntries = 16;
+				static constexpr size_t maxSpan = 16384; // 한글 음절 영역(11172자)을 모두 덮을 수 있는 크기
+				Vector<Entry> entries;
+				Vector<Diff> diffs;
+				size_t minFanout = -1;
+
+			public:
+				static constexpr size_t defaultMemoryBudget = 256 * 1024;
+				static constexpr size_t defaultMinFanout = 64;
+
+				void clear()
+				{
+					entries.clear();
+					diffs.clear();
+					minFanout = -1;
+				}
+
+				bool empty() const { return entries.empty(); }
+				size_t memorySize() const { return diffs.size() * sizeof(Diff) + entries.size() * sizeof(Entry); }
+
+				/**
+				 * @brief 노드 하나에 대한 테이블을 추가한다.
+				 * @details 남은 예산 안에서 가장 많은 키를 담을 수 있는 구간을 고른다. 
+				 * 구간에 담기는 키가 minKeys개보다 적으면 테이블을 만들지 않는다.
+				 * 
+				 * @param keys, values 노드의 키와 그에 대응하는 자식까지의 거리. 순서는 상관 없다.
+				 * @param budget 남은 메모리 예산(바이트). 사용한 만큼 줄어든다.
+				 */
+				bool add(size_t node, const Key* keys, const Diff* values, size_t n, size_t minKeys, size_t& budget)
+				{
+					if (entries.size() >= maxEntries || budget < sizeof(Diff) * minKeys) return false;
+					std::vector<std::pair<size_t, Diff>> pairs;
+					pairs.reserve(n);
+					for (size_t i = 0; i < n; ++i) pairs.emplace_back((size_t)keys[i], values[i]);
+					std::sort(pairs.begin(), pairs.end());
+
+					const size_t span = std::min(budget / sizeof(Diff), maxSpan);
+					size_t bestBegin = 0, bestEnd = 0;
+					for (size_t b = 0, e = 0; b < n; ++b)
+					{
+						if (e < b) e = b;
+						while (e < n && pairs[e].first - pairs[b].first < span) ++e;
+						if (e - b > bestEnd - bestBegin)
+						{
+							bestBegin = b;
+							bestEnd = e;
+						}
+					}
+					if (bestEnd - bestBegin < minKeys) return false;
+
+					Entry entry;
+					entry.node = node;
+					entry.first = pairs[bestBegin].first;
+					entry.size = pairs[bestEnd - 1].first - entry.first + 1;
+					entry.offset = diffs.size();
+					diffs.resize(diffs.size() + entry.size);
+					for (size_t i = bestBegin; i < bestEnd; ++i)
+					{
+						diffs[entry.offset + pairs[i].first - entry.first] = pairs[i].second;
+					}
+					budget -= entry.size * sizeof(Diff);
+					entries.emplace_back(entry);
+					minFanout = std::min(minFanout, n);
+					return true;
+				}
+
+				/**
+				 * @brief 테이블이 있는 노드이고 키가 구간 안에 있으면 자식까지의 거리(없으면 0)를 out에 쓰고 true를 반환한다.
+				 */
+				bool find(size_t node, size_t numNexts, Key c, Diff& out) const
+				{
+					if (numNexts < minFanout) return false;
+					for (auto& e : entries)
+					{
+						if (e.node != node) continue;
+						const size_t k = (size_t)c - e.first;
+						if (k >= e.size) return false;
+						out = diffs[e.offset + k];
+						return true;
+					}
+					return false;
+				}
+			};
 		}
 
 		template<class _Key, class _Value, class _Diff = int32_t, class _HasSubmatch = detail::HasSubmatch<_Value>>
@@ -96,6 +200,7 @@ namespace kiwi
 			std::unique_ptr<Value[]> values;
 			std::unique_ptr<Key[]> nextKeys;
 			std::unique_ptr<Diff[]> nextDiffs;
+			detail::DirectTransitions<Key, Diff> direct;
 
 			template<class Fn>
 			void traverse(Fn&& visitor, const Node* node, std::vector<Key>& prefix, size_t maxDepth) const
@@ -121,8 +226,12 @@ namespace kiwi
 
 			FrozenTrie() = default;
 
+			/**
+			 * @param pool nullptr이 아니면 노드 배열 구성과 실패 링크 계산을 pool의 작업자들이 나누어 수행한다. 
+			 * 이 경우 xform은 여러 스레드에서 동시에 호출될 수 있다. 결과는 pool 사용 여부와 관계없이 같다.
+			 */
 			template<class TrieNode, ArchType archType, class Xform = detail::NodeToVal>
-			FrozenTrie(const ContinuousTrie<TrieNode>& trie, ArchTypeHolder<archType>, Xform xform = {});
+			FrozenTrie(const ContinuousTrie<TrieNode>& trie, ArchTypeHolder<archType>, Xform xform = {}, ThreadPool* pool = nullptr);
 
 			FrozenTrie(const FrozenTrie& o);
 			FrozenTrie(FrozenTrie&&) noexcept = default;
@@ -144,6 +253,201 @@ namespace kiwi
 				std::vector<Key> prefix;
 				traverse(std::forward<Fn>(visitor), root(), prefix, maxDepth);
 			}
+
+			/**
+			 * @brief 트라이의 노드와 키 배열을 그대로 스트림에 쓴다.
+			 * 
+			 * @param valueToIdx 각 값을 uint32_t로 변환하는 함수. 포인터 값은 인덱스로 바꿔서 저장해야 한다.
+			 */
+			template<class Fn>
+			void writeRaw(std::ostream& ostr, Fn&& valueToIdx) const;
+
+			/**
+			 * @brief `writeRaw()`로 저장된 트라이를 읽어온다.
+			 * 
+			 * @param idxToValue `writeRaw()`에 사용한 변환의 역함수
+			 */
+			template<class Fn>
+			void readRaw(std::istream& istr, Fn&& idxToValue);
+
+			/**
+			 * @brief 다른 아키텍처용으로 정렬된 키 배열을 `archType`의 탐색 순서에 맞게 재배열한다.
+			 */
+			void rearrangeKeys(ArchType archType);
+
+			/**
+			 * @brief 자식 수가 `minFanout` 이상인 노드들에 대해 직접 참조 테이블을 만든다.
+			 * @details 자식이 많은 노드부터 `memoryBudget` 바이트를 다 쓸 때까지 만든다.
+			 * 생성자와 `readRaw()`에서 기본값으로 호출되며, 예산을 0으로 주면 테이블을 모두 제거한다.
+			 */
+			void buildDirectTransitions(size_t memoryBudget = detail::DirectTransitions<Key, Diff>::defaultMemoryBudget,
+				size_t minFanout = detail::DirectTransitions<Key, Diff>::defaultMinFanout);
+
+			/**
+			 * @brief 노드, 간선, 값 배열이 차지하는 메모리의 크기(바이트)
+			 */
+			size_t memorySize() const
+			{
+				return numNodes * (sizeof(Node) + sizeof(Value)) + numNexts * (sizeof(Key) + sizeof(Diff)) + direct.memorySize();
+			}
+		};
+
+		/**
+		 * @brief `FrozenTrie`와 같은 인터페이스를 가지면서 메모리를 덜 차지하는 트라이.
+		 * @details 노드를 너비 우선 순서로 배치하여 한 노드의 자식들이 연속해서 놓이도록 하고,
+		 * 자식 노드의 위치를 간선 번호로부터 계산한다. 덕분에 간선마다 32bit 오프셋 대신
+		 * 정렬된 키 내에서의 순위만 저장하면 되며, 노드는 간선 시작 위치와 실패 링크만 가진다(8바이트).
+		 * 값은 노드마다 32bit 번호로 저장하고 실제 값은 일치하는 노드 수만큼만 따로 보관한다.
+		 * 
+		 * 루트와 부모가 없는 노드들은 원래 순서대로 맨 앞에 놓이므로, `value(idx)`로 이런 노드들의 값을
+		 * 원래 번호로 조회할 수 있다. 원본 트라이는 트리 형태(모든 자식 오프셋이 양수)여야 한다.
+		 */
+		template<class _Key, class _Value, class _HasSubmatch = detail::HasSubmatch<_Value>>
+		class CompactFrozenTrie : public _HasSubmatch
+		{
+		public:
+			using Key = _Key;
+			using Value = _Value;
+			using Rank = typename std::conditional<(sizeof(Key) <= 2), uint16_t, uint32_t>::type;
+
+			struct Node
+			{
+				uint32_t nextOffset = 0;
+				int32_t lower = 0;
+
+				size_t numNexts() const { return this[1].nextOffset - nextOffset; }
+
+				template<ArchType arch>
+				const Node* nextOpt(const CompactFrozenTrie& ft, Key c) const;
+
+				template<ArchType arch>
+				const Node* findFail(const CompactFrozenTrie& ft, Key c) const;
+
+				const Node* fail() const;
+				const Value& val(const CompactFrozenTrie& ft) const;
+			};
+		private:
+			size_t numNodes = 0;
+			size_t childBase = 1;
+			Vector<Node> nodes; // 마지막 노드 뒤에 간선 수 계산을 위한 보초 노드가 하나 더 있음
+			Vector<uint32_t> valueIdx;
+			Vector<Value> values; // 0번은 빈 값, 1번은 submatch 표시 값
+			Vector<Key> nextKeys;
+			Vector<Rank> nextRanks;
+			detail::DirectTransitions<Key, int32_t> direct;
+
+			const Node* child(const Node* node, size_t rank) const
+			{
+				return &nodes[childBase + node->nextOffset + rank];
+			}
+
+			void initValues()
+			{
+				values.clear();
+				values.resize(2);
+				this->setHasSubmatch(values[1]);
+			}
+
+			uint32_t addValue(const Value& v)
+			{
+				if (this->isNull(v)) return 0;
+				if (this->hasSubmatch(v)) return 1;
+				values.emplace_back(v);
+				return (uint32_t)values.size() - 1;
+			}
+
+			template<class Fn>
+			void traverse(Fn&& visitor, const Node* node, std::vector<Key>& prefix, size_t maxDepth) const
+			{
+				auto* keys = &nextKeys[node->nextOffset];
+				auto* ranks = &nextRanks[node->nextOffset];
+				for (size_t i = 0; i < node->numNexts(); ++i)
+				{
+					const auto* c = child(node, ranks[i]);
+					const auto val = c->val(*this);
+					if (!hasMatch(val)) continue;
+					prefix.emplace_back(keys[i]);
+					visitor(val, prefix);
+					if (prefix.size() < maxDepth)
+					{
+						traverse(visitor, c, prefix, maxDepth);
+					}
+					prefix.pop_back();
+				}
+			}
+
+		public:
+
+			CompactFrozenTrie() = default;
+
+			/**
+			 * @param pool nullptr이 아니면 실패 링크 계산을 pool의 작업자들이 나누어 수행한다. 결과는 pool 사용 여부와 관계없이 같다.
+			 */
+			template<class TrieNode, ArchType archType, class Xform = detail::NodeToVal>
+			CompactFrozenTrie(const ContinuousTrie<TrieNode>& trie, ArchTypeHolder<archType>, Xform xform = {}, ThreadPool* pool = nullptr);
+
+			bool empty() const { return !numNodes; }
+			size_t size() const { return numNodes; }
+			const Node* root() const { return nodes.data(); }
+
+			const Value& value(size_t idx) const { return values[valueIdx[idx]]; };
+
+			bool hasMatch(_Value v) const { return !this->isNull(v) && !this->hasSubmatch(v); }
+
+			template<class Fn>
+			void traverse(Fn&& visitor, size_t maxDepth = -1) const
+			{
+				std::vector<Key> prefix;
+				traverse(std::forward<Fn>(visitor), root(), prefix, maxDepth);
+			}
+
+			/**
+			 * @brief 트라이를 스트림에 쓴다. 형식은 `FrozenTrie::writeRaw()`와 호환되지 않는다.
+			 * 
+			 * @param valueToIdx 각 값을 uint32_t로 변환하는 함수. 포인터 값은 인덱스로 바꿔서 저장해야 한다.
+			 */
+			template<class Fn>
+			void writeRaw(std::ostream& ostr, Fn&& valueToIdx) const;
+
+			/**
+			 * @brief `writeRaw()`로 저장된 트라이를 읽어온다.
+			 * 
+			 * @param idxToValue `writeRaw()`에 사용한 변환의 역함수
+			 */
+			template<class Fn>
+			void readRaw(std::istream& istr, Fn&& idxToValue);
+
+			/**
+			 * @brief 다른 아키텍처용으로 정렬된 키 배열을 `archType`의 탐색 순서에 맞게 재배열한다.
+			 */
+			void rearrangeKeys(ArchType archType);
+
+			/**
+			 * @brief `FrozenTrie::buildDirectTransitions()`와 같다.
+			 */
+			void buildDirectTransitions(size_t memoryBudget = detail::DirectTransitions<Key, int32_t>::defaultMemoryBudget,
+				size_t minFanout = detail::DirectTransitions<Key, int32_t>::defaultMinFanout);
+
+			/**
+			 * @brief 노드, 간선, 값 배열이 차지하는 메모리의 크기(바이트)
+			 */
+			size_t memorySize() const
+			{
+				return nodes.size() * sizeof(Node) + valueIdx.size() * sizeof(uint32_t) + values.size() * sizeof(Value)
+					+ nextKeys.size() * sizeof(Key) + nextRanks.size() * sizeof(Rank) + direct.memorySize();
+			}
 		};
 	}
+
+	struct Form;
+
+	/**
+	 * @brief `Kiwi::formTrie`에 사용하는 트라이 타입.
+	 * @details `KIWI_USE_COMPACT_TRIE`가 정의된 경우 메모리를 덜 차지하는 `CompactFrozenTrie`를 사용한다.
+	 */
+#ifdef KIWI_USE_COMPACT_TRIE
+	using FormTrie = utils::CompactFrozenTrie<kchar_t, const Form*>;
+#else
+	using FormTrie = utils::FrozenTrie<kchar_t, const Form*>;
+#endif
 }
@@ -12,6 +12,8 @@
 #include <iostream>
 #include <future>
 #include <string>
+#include <deque>
+#include <chrono>
 #include "Macro.h"
 #include "Types.h"
 #include "Form.h"
@@ -28,6 +30,7 @@
 #include "LmState.h"
 #include "Joiner.h"
 #include "TypoTransformer.h"
+#include "UserOverlay.h"
 
 namespace kiwi
 {
@@ -51,6 +54,86 @@ namespace kiwi
 		return (uint32_t)clearIrregular(tag) + 1;
 	}
 
+	/**
+	 * @brief `Kiwi::analyzeStream`의 동작을 설정하는 옵션
+	 */
+	struct StreamOptions
+	{
+		size_t maxInFlight = 0; /**< 읽었지만 아직 결과가 전달되지 않은 입력의 최대 개수. 0이면 스레드 개수의 2배를 사용한다. */
+		size_t chunkSize = 0; /**< 이보다 긴(UTF16 문자 기준) 입력은 문장 경계에서 잘라 여러 작업자가 나누어 분석한다. 0이면 자르지 않는다. */
+
+		StreamOptions(size_t _maxInFlight = 0, size_t _chunkSize = 0)
+			: maxInFlight{ _maxInFlight }, chunkSize{ _chunkSize }
+		{
+		}
+	};
+
+	/**
+	 * @brief `Kiwi::analyzeStream`의 처리량 통계
+	 */
+	struct StreamStats
+	{
+		size_t numInputs = 0; /**< 분석한 입력의 개수 */
+		size_t numChunks = 0; /**< 작업자에게 분배된 조각의 개수. 잘리지 않은 입력은 하나의 조각이 된다. */
+		size_t numChars = 0; /**< 분석한 전체 문자 수(UTF16 기준) */
+		size_t numStalls = 0; /**< 뒤의 입력은 끝났지만 가장 앞의 입력이 끝나지 않아 결과 전달을 기다린 횟수 */
+		size_t maxReordered = 0; /**< 순서를 맞추기 위해 전달을 기다린 완료된 입력 개수의 최댓값 */
+		double elapsed = 0; /**< 전체 소요 시간(초) */
+
+		double inputsPerSecond() const { return elapsed > 0 ? numInputs / elapsed : 0; }
+		double charsPerSecond() const { return elapsed > 0 ? numChars / elapsed : 0; }
+	};
+
+	/**
+	 * @brief `Kiwi`의 LM 전이 캐시 사용 통계
+	 */
+	struct LmCacheStats
+	{
+		size_t hits = 0; /**< 캐시에서 찾은 전이의 개수 */
+		size_t misses = 0; /**< 캐시에 없어서 LM을 탐색한 전이의 개수 */
+
+		double hitRate() const { return hits + misses ? hits / (double)(hits + misses) : 0; }
+	};
+
+	/**
+	 * @brief `Kiwi`의 분석 결과 캐시 사용 통계
+	 */
+	struct ResultCacheStats
+	{
+		size_t hits = 0; /**< 캐시에 저장된 결과를 그대로 반환한 횟수 */
+		size_t misses = 0; /**< 캐시에 결과가 없어서 새로 분석한 횟수 */
+		size_t evictions = 0; /**< 용량이 가득 차서 밀려난 항목의 개수 */
+		size_t size = 0; /**< 현재 캐시에 저장된 항목의 개수 */
+
+		double hitRate() const { return hits + misses ? hits / (double)(hits + misses) : 0; }
+	};
+
+	class ResultCache;
+
+	/**
+	 * @brief `Kiwi::analyze`의 단계별 수행 통계. `Kiwi::setCollectStats(true)`인 동안에만 집계된다.
+	 */
+	struct AnalyzeStats
+	{
+		size_t numAnalyzed = 0; /**< 분석한 텍스트의 개수 */
+		size_t numChars = 0; /**< 분석한 텍스트의 총 길이(UTF16 문자 기준) */
+		double normalizeTime = 0; /**< 한글 정규화(`normalizeHangulWithPosition`) 단계의 누적 소요 시간(초) */
+		double splitTime = 0; /**< 형태 그래프 생성(`splitByTrie`) 단계의 누적 소요 시간(초) */
+		double pathTime = 0; /**< 최적 경로 탐색(`findBestPath`) 단계의 누적 소요 시간(초) */
+		double insertTime = 0; /**< 결과 생성(`insertPathIntoResults`) 단계의 누적 소요 시간(초) */
+		size_t numSplits = 0; /**< `splitByTrie`가 생성한 그래프의 개수 */
+		size_t numNodes = 0; /**< `splitByTrie`가 생성한 그래프 노드의 총 개수 */
+		size_t numTypoNodes = 0; /**< 그 중 오타 교정 후보로 생성된 노드의 개수 */
+		size_t numPathsEvaluated = 0; /**< `findBestPath`에서 점수를 계산한 경로 후보의 개수 */
+		size_t numPathsPruned = 0; /**< `cutOffThreshold`에 의해 제거된 경로의 개수 */
+		size_t numLmCalls = 0; /**< 언어 모델 전이 계산 횟수 */
+		size_t numMemoHits = 0; /**< 경로 탐색 없이 `setChunkMemoSize`의 기억된 결과를 재사용한 그래프의 개수 */
+		LmCacheStats lmCache; /**< LM 전이 캐시 사용 통계 */
+		ResultCacheStats resultCache; /**< 분석 결과 캐시 사용 통계 */
+
+		double totalTime() const { return normalizeTime + splitTime + pathTime + insertTime; }
+	};
+
 	/**
 	 * @brief 실제 형태소 분석을 수행하는 클래스.
 	 * 
@@ -59,6 +142,7 @@ namespace kiwi
 	{
 		friend class KiwiBuilder;
 		friend class PathEvaluator;
+		friend class KiwiBenchmark;
 		friend class cmb::AutoJoiner;
 		template<template<ArchType> class LmState> friend struct NewAutoJoinerGetter;
 
@@ -72,18 +156,68 @@ namespace kiwi
 		float lengtheningTypoCost = INFINITY;
 		size_t maxUnkFormSize = 6;
 		size_t spaceTolerance = 0;
+		size_t parallelChunkSize = 0;
+		size_t lmCacheSize = 4096;
+		std::unique_ptr<std::atomic<size_t>[]> lmCacheCounters = std::unique_ptr<std::atomic<size_t>[]>{ new std::atomic<size_t>[2]{} };
+		bool collectStats = false;
+		size_t resultCacheSize = 0;
+		size_t chunkMemoSize = 0;
+		size_t configVersion = 0;
+		uint64_t instanceId = 0;
+		std::unique_ptr<ResultCache> resultCache;
+
+		enum StatCounter : size_t
+		{
+			statNumAnalyzed,
+			statNumChars,
+			statNormalizeTime,
+			statSplitTime,
+			statPathTime,
+			statInsertTime,
+			statNumSplits,
+			statNumNodes,
+			statNumTypoNodes,
+			statNumPathsEvaluated,
+			statNumPathsPruned,
+			statNumLmCalls,
+			statNumMemoHits,
+			numStatCounters,
+		};
+		std::unique_ptr<std::atomic<size_t>[]> statCounters = std::unique_ptr<std::atomic<size_t>[]>{ new std::atomic<size_t>[numStatCounters]{} };
+
+		/**
+		 * @brief 현재 스레드에서 집계 중인 통계. 분석이 끝날 때마다 `flushStats`로 `statCounters`에 합산된다.
+		 */
+		static std::array<size_t, numStatCounters>& localStats()
+		{
+			thread_local std::array<size_t, numStatCounters> stats = { { 0, } };
+			return stats;
+		}
+
+		void flushStats() const;
 
 		TagSequenceScorer tagScorer;
 
-		Vector<Form> forms;
-		Vector<Morpheme> morphemes;
-		KString typoPool;
-		Vector<size_t> typoPtrs;
-		Vector<TypoForm> typoForms;
-		utils::FrozenTrie<kchar_t, const Form*> formTrie;
+		/**
+		 * @brief 생성 이후 변경되지 않는 형태 및 형태소 사전과 형태 Trie.
+		 * @details 모델 데이터의 대부분을 차지하므로 `Kiwi::clone`으로 파생된 인스턴스끼리는 복사하지 않고 공유한다.
+		 * 인스턴스별로 달라지는 단어는 `UserOverlay`로 덧씌운다.
+		 */
+		struct Vocab
+		{
+			Vector<Form> forms;
+			Vector<Morpheme> morphemes;
+			KString typoPool;
+			Vector<size_t> typoPtrs;
+			Vector<TypoForm> typoForms;
+			FormTrie formTrie;
+		};
+
+		std::shared_ptr<const Vocab> vocab;
 		LangModel langMdl;
 		std::shared_ptr<cmb::CompiledRule> combiningRule;
-		std::unique_ptr<utils::ThreadPool> pool;
+		std::shared_ptr<utils::ThreadPool> pool;
+		std::shared_ptr<const UserOverlay> userOverlay; // std::atomic_load/atomic_store로만 접근한다
 		
 		inline const Morpheme* getDefaultMorpheme(POSTag tag) const;
 
@@ -112,14 +246,55 @@ namespace kiwi
 	private:
 		std::array<size_t, static_cast<size_t>(SpecialMorph::max)> specialMorphIds = { { 0, } };
 
+		/**
+		 * @brief 종결어미(ef)의 마지막 음절이 될 수 있는 한글 음절들의 비트셋. `splitIntoSentsFast`에서 문장 경계 후보를 고르는 데 쓰인다.
+		 */
+		Vector<uint64_t> sentEndingSyllables;
+
+		/**
+		 * @brief 현재 형태소 목록으로부터 sentEndingSyllables를 다시 계산한다.
+		 */
+		void updateSentEndingSyllables();
+
+		bool mayEndSentence(const std::u16string& str, size_t begin, size_t end) const;
+
 		template<class Str, class Pretokenized, class ...Rest>
 		auto _asyncAnalyze(Str&& str, Pretokenized&& pt, Rest&&... args) const;
 
 		template<class Str, class Pretokenized, class ...Rest>
 		auto _asyncAnalyzeEcho(Str&& str, Pretokenized&& pt, Rest&&... args) const;
 
+		template<class TokenTy, class FormPool>
+		void _analyze(std::vector<std::pair<std::vector<TokenTy>, float>>& ret, FormPool& formPool,
+			const std::u16string& str, size_t topN, Match matchOptions,
+			const std::unordered_set<const Morpheme*>* blocklist,
+			const std::vector<PretokenizedSpan>& pretokenized
+		) const;
+
 		static std::vector<PretokenizedSpan> mapPretokenizedSpansToU16(const std::vector<PretokenizedSpan>& orig, const std::vector<size_t>& bytePositions);
 
+		/**
+		 * @brief 긴 텍스트를 대략 chunkSize 길이의 조각으로 나눌 위치를 찾는다.
+		 * @return 각 조각의 시작 위치. 첫번째 값은 항상 0이다.
+		 * @note 문장 종결 부호 뒤의 공백이나 빈 줄을 우선하여 자르며, 그런 위치가 없으면 어절 경계에서 자른다.
+		 */
+		static std::vector<size_t> findSplitPoints(const std::u16string& str, size_t chunkSize);
+
+		/**
+		 * @brief findSplitPoints로 나누어 분석한 조각별 결과를 원래 텍스트에 대한 하나의 결과로 합친다.
+		 */
+		static void mergeSplitResults(std::vector<TokenResult>& out, std::vector<std::vector<TokenResult>>& parts, 
+			const std::u16string& str, const std::vector<size_t>& splitPoints);
+
+		/**
+		 * @brief 긴 텍스트를 문장 경계에서 나누어 스레드 풀에서 병렬로 분석한 뒤 결과를 합친다.
+		 * @return 나눌 수 있는 위치가 없어 분석을 수행하지 않은 경우 false
+		 */
+		bool analyzeSplitted(std::vector<TokenResult>& out, const std::u16string& str, size_t topN, Match matchOptions,
+			const std::unordered_set<const Morpheme*>* blocklist,
+			const std::vector<PretokenizedSpan>& pretokenized
+		) const;
+
 	public:
 
 		/**
@@ -152,7 +327,7 @@ namespace kiwi
 		 * @note 기본 생성자를 통해 생성된 경우 언제나 `ready() == false`이며,
 		 * `kiwi::KiwiBuilder`를 통해 생성된 경우 `ready() == true`이다.
 		 */
-		bool ready() const { return !forms.empty(); }
+		bool ready() const { return vocab && !vocab->forms.empty(); }
 
 		ArchType archType() const { return selectedArch; }
 
@@ -161,7 +336,30 @@ namespace kiwi
 		 * 
 		 * @return 오타 교정 기능이 켜진 경우 true를 반환한다.
 		 */
-		bool isTypoTolerant() const { return !typoForms.empty(); }
+		bool isTypoTolerant() const { return vocab && !vocab->typoForms.empty(); }
+
+		/**
+		 * @brief 빌드가 완료된 Kiwi 객체 전체를 하나의 파일로 저장한다.
+		 * 
+		 * @param path 저장할 파일 경로
+		 * 
+		 * @note 형태 및 형태소 목록, 형태 Trie, 오타 후보, 컴파일된 결합 규칙과 언어 모델이 모두 한 파일에 담기므로
+		 * 사용자 사전이나 오타 교정 설정도 그대로 보존된다. 저장된 파일은 `kiwi::Kiwi::loadBaked()`로 불러올 수 있다.
+		 */
+		void save(const std::string& path) const;
+
+		/**
+		 * @brief `kiwi::Kiwi::save()`로 저장된 파일로부터 Kiwi 객체를 생성한다.
+		 * 
+		 * @param path 불러올 파일 경로
+		 * @param arch 사용할 아키텍처. 저장할 때와 다른 경우 탐색용 키 배열을 재정렬한다.
+		 * @param numThreads 사용할 스레드 개수. 0인 경우 공용 스레드 풀(`utils::getSharedThreadPool`)을 사용한다.
+		 * @return 형태소 분석 준비가 완료된 Kiwi 객체
+		 * 
+		 * @note 파일은 메모리 맵으로 열리고 언어 모델은 복사 없이 매핑된 영역에서 바로 사용된다.
+		 * `kiwi::KiwiBuilder::build()`의 형태소 결합, 정렬, 오타 생성, 규칙 컴파일 과정을 모두 건너뛰므로 훨씬 빠르게 준비된다.
+		 */
+		static Kiwi loadBaked(const std::string& path, ArchType arch = ArchType::default_, size_t numThreads = 0);
 
 		/**
 		 * @brief 
@@ -225,6 +423,32 @@ namespace kiwi
 			return analyze(u16str, topN, matchOptions, blocklist, mapPretokenizedSpansToU16(pretokenized, bytePositions));
 		}
 
+		/**
+		 * @brief 텍스트를 분석하여 그 결과를 열 단위 결과의 뒤에 추가한다.
+		 * 
+		 * @param str 분석할 텍스트
+		 * @param out 결과를 추가할 ColumnarTokenResult. 입력 하나가 추가되며 기존 내용은 유지된다.
+		 * @param topN 
+		 * @param matchOptions 
+		 * @return out
+		 * 
+		 * @note 분석 중간 결과의 형태는 스레드별로 재사용되는 버퍼 안의 구간으로만 관리되며, 
+		 * 형태소마다 별도의 문자열을 할당하지 않는다. 같은 `out`을 반복해서 재사용하면 결과 생성에 드는 할당이 대부분 사라진다.
+		 */
+		ColumnarTokenResult& analyze(const std::u16string& str, ColumnarTokenResult& out, size_t topN, Match matchOptions,
+			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {}
+		) const;
+
+		ColumnarTokenResult& analyze(const std::string& str, ColumnarTokenResult& out, size_t topN, Match matchOptions,
+			const std::unordered_set<const Morpheme*>* blocklist = nullptr,
+			const std::vector<PretokenizedSpan>& pretokenized = {}) const
+		{
+			std::vector<size_t> bytePositions;
+			auto u16str = utf8To16(str, bytePositions);
+			return analyze(u16str, out, topN, matchOptions, blocklist, mapPretokenizedSpansToU16(pretokenized, bytePositions));
+		}
+
 		/**
 		 * @brief 
 		 * 
@@ -292,52 +516,172 @@ namespace kiwi
 			const std::unordered_set<const Morpheme*>* blocklist = nullptr
 		) const
 		{
-			if (pool)
+			analyzeStream(topN, std::forward<ReaderCallback>(reader), std::forward<ResultCallback>(resultCallback), matchOptions, StreamOptions{}, blocklist);
+		}
+
+		/**
+		 * @brief reader가 빈 문자열을 반환할 때까지 입력을 읽어 분석하고, 그 결과를 입력 순서대로 resultCallback에 전달한다.
+		 * 
+		 * @param topN 입력별로 반환할 분석 결과의 개수
+		 * @param reader 분석할 텍스트를 반환하는 콜백. 빈 문자열을 반환하면 입력이 끝난 것으로 간주한다.
+		 * @param resultCallback `std::vector<TokenResult>`를 인자로 받는 콜백. 항상 호출한 스레드에서 입력 순서대로 호출된다.
+		 * @param matchOptions 
+		 * @param options 동시에 처리할 입력의 개수와 긴 입력을 자르는 기준
+		 * @param blocklist 
+		 * @return 처리량 통계
+		 * 
+		 * @note 스레드 풀이 있는 경우 최대 options.maxInFlight개의 입력이 동시에 처리되며, 
+		 * 먼저 끝난 결과는 앞선 입력이 끝날 때까지 보관된다. 보관된 결과를 포함해 처리 중인 입력이 가득 차면 reader 호출을 멈춘다.
+		 * options.chunkSize보다 긴 입력은 문장 경계에서 잘라 여러 작업자가 나누어 분석한 뒤 하나의 결과로 합친다.
+		 * 이 경우 잘린 지점을 넘나드는 문맥은 고려되지 않으므로 전체를 한번에 분석한 결과와 다를 수 있다.
+		 */
+		template<class ReaderCallback, class ResultCallback>
+		StreamStats analyzeStream(size_t topN, ReaderCallback&& reader, ResultCallback&& resultCallback, Match matchOptions,
+			const StreamOptions& options = {},
+			const std::unordered_set<const Morpheme*>* blocklist = nullptr
+		) const
+		{
+			StreamStats stats;
+			const auto startTime = std::chrono::steady_clock::now();
+			if (!pool)
 			{
-				bool stop = false;
-				std::deque<std::future<std::vector<TokenResult>>> futures;
-				for (size_t i = 0; i < pool->size() * 2; ++i)
+				while (1)
 				{
 					auto ustr = reader();
-					if (ustr.empty())
-					{
-						stop = true;
-						break;
-					}
-					futures.emplace_back(pool->enqueue([=, ustr = std::move(ustr)](size_t tid)
-					{
-						return analyze(ustr, topN, matchOptions, blocklist);
-					}));
+					if (ustr.empty()) break;
+					stats.numInputs++;
+					stats.numChunks++;
+					stats.numChars += ustr.size();
+					resultCallback(analyze(ustr, topN, matchOptions, blocklist));
 				}
+				stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+				return stats;
+			}
 
-				while (!futures.empty())
+			struct Job
+			{
+				std::u16string str;
+				std::vector<size_t> splitPoints;
+				std::vector<std::vector<TokenResult>> parts;
+				size_t remaining = 0;
+				std::exception_ptr error;
+			};
+
+			const size_t window = options.maxInFlight ? options.maxInFlight : pool->size() * 2;
+			std::deque<std::unique_ptr<Job>> jobs;
+			std::mutex mtx;
+			std::condition_variable cnd;
+			size_t outstanding = 0, completed = 0;
+
+			auto runPart = [&](Job* job, size_t i)
+			{
+				std::vector<TokenResult> res;
+				std::exception_ptr error;
+				try
 				{
-					resultCallback(futures.front().get());
-					futures.pop_front();
-					if (!stop)
+					const size_t b = job->splitPoints[i];
+					const size_t e = i + 1 < job->splitPoints.size() ? job->splitPoints[i + 1] : job->str.size();
+					if (job->splitPoints.size() == 1) res = analyze(job->str, topN, matchOptions, blocklist);
+					else res = analyze(job->str.substr(b, e - b), topN, matchOptions, blocklist);
+				}
+				catch (...)
+				{
+					error = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock{ mtx };
+				job->parts[i] = std::move(res);
+				if (error && !job->error) job->error = error;
+				if (--job->remaining == 0) ++completed;
+				--outstanding;
+				cnd.notify_all();
+			};
+
+			try
+			{
+				bool eof = false;
+				while (1)
+				{
+					while (!eof && jobs.size() < window)
 					{
 						auto ustr = reader();
 						if (ustr.empty())
 						{
-							stop = true;
-							continue;
+							eof = true;
+							break;
+						}
+						jobs.emplace_back(new Job);
+						Job* job = jobs.back().get();
+						job->str = std::move(ustr);
+						job->splitPoints = findSplitPoints(job->str, options.chunkSize);
+						job->parts.resize(job->splitPoints.size());
+						job->remaining = job->splitPoints.size();
+						stats.numInputs++;
+						stats.numChunks += job->remaining;
+						stats.numChars += job->str.size();
+						{
+							std::lock_guard<std::mutex> lock{ mtx };
+							outstanding += job->remaining;
+						}
+						for (size_t i = 0; i < job->splitPoints.size(); ++i)
+						{
+							pool->submit([&runPart, job, i](size_t) { runPart(job, i); });
 						}
-						futures.emplace_back(pool->enqueue([=, ustr = std::move(ustr)](size_t tid)
+					}
+					if (jobs.empty()) break;
+
+					Job* head = jobs.front().get();
+					{
+						std::unique_lock<std::mutex> lock{ mtx };
+						if (head->remaining)
 						{
-							return analyze(ustr, topN, matchOptions, blocklist);
-						}));
+							if (completed) stats.numStalls++;
+							cnd.wait(lock, [&]() { return head->remaining == 0; });
+						}
+						stats.maxReordered = std::max(stats.maxReordered, completed - 1);
+						--completed;
 					}
+					if (head->error) std::rethrow_exception(head->error);
+
+					std::vector<TokenResult> res;
+					if (head->parts.size() == 1) res = std::move(head->parts[0]);
+					else mergeSplitResults(res, head->parts, head->str, head->splitPoints);
+					jobs.pop_front();
+					resultCallback(std::move(res));
 				}
 			}
-			else
+			catch (...)
 			{
-				while(1)
-				{
-					auto ustr = reader();
-					if (ustr.empty()) break;
-					resultCallback(analyze(ustr, topN, matchOptions, blocklist));
-				}
+				// 작업자들이 jobs를 참조하고 있으므로 모두 끝날 때까지 기다린 뒤에 예외를 전파한다.
+				std::unique_lock<std::mutex> lock{ mtx };
+				cnd.wait(lock, [&]() { return outstanding == 0; });
+				throw;
 			}
+			stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+			return stats;
+		}
+
+		/**
+		 * @brief 여러 개의 텍스트를 한꺼번에 분석하여 하나의 열 단위 결과로 돌려준다.
+		 * 
+		 * @param strs 분석할 텍스트 목록
+		 * @param topN 텍스트별로 반환할 분석 결과의 개수
+		 * @param matchOptions 
+		 * @param blocklist 
+		 * @return 입력 순서대로 결과가 담긴 ColumnarTokenResult
+		 * 
+		 * @note 스레드 풀이 있는 경우 입력은 연속된 조각으로 나뉘어 각 작업자에게 분배된다. 
+		 * 각 작업자는 자신의 스레드에 할당된 분석용 버퍼를 재사용하며, 조각별 결과는 입력 순서대로 합쳐진다.
+		 */
+		ColumnarTokenResult analyzeBatch(const std::vector<std::u16string>& strs, size_t topN, Match matchOptions,
+			const std::unordered_set<const Morpheme*>* blocklist = nullptr
+		) const;
+
+		ColumnarTokenResult analyzeBatch(const std::vector<std::u16string>& strs, Match matchOptions,
+			const std::unordered_set<const Morpheme*>* blocklist = nullptr
+		) const
+		{
+			return analyzeBatch(strs, 1, matchOptions, blocklist);
 		}
 
 		/**
@@ -368,6 +712,33 @@ namespace kiwi
 			TokenResult* tokenizedResultOut = nullptr
 		) const;
 
+		/**
+		 * @brief 전체 형태소 분석을 수행하지 않고 텍스트를 문장 단위로 빠르게 분할한다.
+		 * 
+		 * @param str 분할할 텍스트
+		 * @param matchOptions 문장 경계 후보 주변을 분석할 때 사용할 옵션
+		 * @return 각 문장의 시작 위치와 끝 위치
+		 * 
+		 * @note 종결 부호나 종결어미로 끝날 수 있는 어절만 경계 후보로 골라 그 앞뒤 어절만 분석하고,
+		 * 괄호 및 따옴표의 짝과 빈 줄은 문자 단위로 판단한다.
+		 * 따라서 분석량이 훨씬 적지만, 어절 중간에서 문장이 끝나는 경우처럼 넓은 문맥이 필요한 경계는
+		 * `splitIntoSents`와 다르게 나뉠 수 있다.
+		 */
+		std::vector<std::pair<size_t, size_t>> splitIntoSentsFast(
+			const std::u16string& str,
+			Match matchOptions = Match::allWithNormalizing
+		) const;
+
+		/**
+		 * @brief 전체 형태소 분석을 수행하지 않고 텍스트를 문장 단위로 빠르게 분할한다.
+		 * 
+		 * @sa splitIntoSentsFast(const std::u16string&, Match) const
+		 */
+		std::vector<std::pair<size_t, size_t>> splitIntoSentsFast(
+			const std::string& str,
+			Match matchOptions = Match::allWithNormalizing
+		) const;
+
 		/**
 		 * @brief 형태소들을 결합하여 텍스트로 복원해주는 작업을 수행하는 AutoJoiner를 반환한다.
 		 * 
@@ -393,8 +764,8 @@ namespace kiwi
 
 		size_t morphToId(const Morpheme* morph) const
 		{
-			if (!morph || morph < morphemes.data()) return -1;
-			return morph - morphemes.data();
+			if (!morph || morph < vocab->morphemes.data()) return -1;
+			return morph - vocab->morphemes.data();
 		}
 
 		size_t getSpecialMorphId(SpecialMorph type) const
@@ -411,12 +782,12 @@ namespace kiwi
 			return SpecialMorph::max;
 		}
 
-		size_t getMorphemeSize() const { return morphemes.size(); }
+		size_t getMorphemeSize() const { return vocab->morphemes.size(); }
 
 		const Morpheme* idToMorph(size_t morphId) const
 		{
-			if (morphId >= morphemes.size()) return nullptr;
-			return &morphemes[morphId];
+			if (morphId >= vocab->morphemes.size()) return nullptr;
+			return &vocab->morphemes[morphId];
 		}
 
 		size_t getNumThreads() const
@@ -429,6 +800,22 @@ namespace kiwi
 			return pool.get();
 		}
 
+		/**
+		 * @brief 분석에 사용할 스레드 풀을 교체한다.
+		 * @details 여러 Kiwi 인스턴스에 같은 풀을 설정하면 인스턴스 수와 상관없이 작업자 스레드 수가 일정하게 유지된다.
+		 * nullptr을 설정하면 단일 스레드 모드로 동작한다.
+		 * @note 진행 중인 비동기 분석이 있는 동안에는 호출해서는 안 된다.
+		 */
+		void setThreadPool(std::shared_ptr<utils::ThreadPool> newPool)
+		{
+			pool = std::move(newPool);
+		}
+
+		std::shared_ptr<utils::ThreadPool> shareThreadPool() const
+		{
+			return pool;
+		}
+
 		float getCutOffThreshold() const
 		{
 			return cutOffThreshold;
@@ -438,6 +825,7 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			cutOffThreshold = v;
+			++configVersion;
 		}
 
 		float getUnkScoreBias() const
@@ -449,6 +837,7 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			unkFormScoreBias = v;
+			++configVersion;
 		}
 
 		float getUnkScoreScale() const
@@ -460,6 +849,7 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			unkFormScoreScale = v;
+			++configVersion;
 		}
 
 		size_t getMaxUnkFormSize() const
@@ -470,6 +860,7 @@ namespace kiwi
 		void setMaxUnkFormSize(size_t v)
 		{
 			maxUnkFormSize = v;
+			++configVersion;
 		}
 
 		size_t getSpaceTolerance() const
@@ -480,6 +871,116 @@ namespace kiwi
 		void setSpaceTolerance(size_t v)
 		{
 			spaceTolerance = v;
+			++configVersion;
+		}
+
+		size_t getLmCacheSize() const
+		{
+			return lmCacheSize;
+		}
+
+		/**
+		 * @brief 경로 탐색 중 LM 전이를 기억해두는 스레드별 캐시의 크기를 설정한다.
+		 * @param v 스레드별 캐시의 최대 항목 수. 2의 거듭제곱으로 내림하며, 0이면 캐시를 사용하지 않는다.
+		 * @note 캐시를 사용하더라도 분석 결과는 달라지지 않는다.
+		 */
+		void setLmCacheSize(size_t v)
+		{
+			lmCacheSize = v;
+		}
+
+		/**
+		 * @brief 생성 혹은 마지막 `resetLmCacheStats` 호출 이후 LM 전이 캐시의 적중 통계를 반환한다.
+		 */
+		LmCacheStats getLmCacheStats() const
+		{
+			LmCacheStats ret;
+			if (!lmCacheCounters) return ret;
+			ret.hits = lmCacheCounters[0].load(std::memory_order_relaxed);
+			ret.misses = lmCacheCounters[1].load(std::memory_order_relaxed);
+			return ret;
+		}
+
+		void resetLmCacheStats()
+		{
+			if (!lmCacheCounters) return;
+			lmCacheCounters[0].store(0, std::memory_order_relaxed);
+			lmCacheCounters[1].store(0, std::memory_order_relaxed);
+		}
+
+		bool getCollectStats() const
+		{
+			return collectStats;
+		}
+
+		/**
+		 * @brief `analyze`의 단계별 소요 시간과 탐색량을 집계할지 설정한다. 기본값은 false이다.
+		 * @note 집계는 스레드별로 이뤄지며 분석 호출이 끝날 때 한 번씩만 합산된다.
+		 * 집계를 켜두면 단계마다 시간을 측정하므로 약간의 부하가 더해진다.
+		 */
+		void setCollectStats(bool v)
+		{
+			collectStats = v;
+		}
+
+		/**
+		 * @brief 생성 혹은 마지막 `resetStats` 호출 이후 집계된 단계별 통계를 반환한다.
+		 */
+		AnalyzeStats getStats() const;
+
+		void resetStats();
+
+		size_t getResultCacheSize() const
+		{
+			return resultCacheSize;
+		}
+
+		/**
+		 * @brief 같은 입력에 대한 `analyze` 결과를 기억해두는 캐시의 크기를 설정한다.
+		 * @param v 캐시에 저장할 최대 결과 개수. 0이면 캐시를 사용하지 않는다. 크기를 바꾸면 기존 캐시는 비워진다.
+		 * @note 입력 문자열, topN, matchOptions, blocklist에 담긴 형태소, pretokenized가 모두 같은 호출만 캐시된 결과를 받는다.
+		 * 분석에 영향을 주는 설정을 바꾸면 그 전에 저장된 결과는 더 이상 사용되지 않는다.
+		 */
+		void setResultCacheSize(size_t v);
+
+		/**
+		 * @brief 생성 혹은 마지막 `resetResultCacheStats` 호출 이후 결과 캐시의 적중 통계를 반환한다.
+		 */
+		ResultCacheStats getResultCacheStats() const;
+
+		void resetResultCacheStats();
+
+		size_t getChunkMemoSize() const
+		{
+			return chunkMemoSize;
+		}
+
+		/**
+		 * @brief 문장 단위로 나뉜 형태 그래프의 최적 경로 탐색 결과를 스레드별로 기억해두고, 같은 조각이 다시 나타나면 재사용한다.
+		 * @param v 스레드별로 기억할 최대 조각 수. 0이면 사용하지 않는다. 한도에 이르면 가장 오래 사용되지 않은 조각부터 밀어낸다.
+		 * @note 조각의 텍스트와 앞 조각에서 이어지는 상태가 모두 같을 때만 재사용하므로 분석 결과는 달라지지 않는다.
+		 * 머리말, 꼬리말처럼 같은 문장이 반복되는 긴 문서를 분석할 때 유용하다.
+		 */
+		void setChunkMemoSize(size_t v)
+		{
+			chunkMemoSize = v;
+		}
+
+		size_t getParallelChunkSize() const
+		{
+			return parallelChunkSize;
+		}
+
+		/**
+		 * @brief v보다 긴(UTF16 문자 기준) 텍스트를 `analyze`할 때 문장 경계에서 나누어 스레드 풀에서 병렬로 분석한다.
+		 * @param v 조각의 목표 길이. 0이면 나누지 않는다.
+		 * @note 스레드 풀이 없거나 스레드 풀의 작업자 스레드 안에서 호출된 `analyze`는 나누지 않고 분석한다.
+		 * 잘린 지점을 넘나드는 문맥은 고려되지 않으므로 전체를 한번에 분석한 결과와 다를 수 있다.
+		 */
+		void setParallelChunkSize(size_t v)
+		{
+			parallelChunkSize = v;
+			++configVersion;
 		}
 
 		float getSpacePenalty() const
@@ -491,6 +992,7 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			spacePenalty = v;
+			++configVersion;
 		}
 
 		float getTypoCostWeight() const
@@ -502,6 +1004,7 @@ namespace kiwi
 		{
 			if (v < 0) throw std::invalid_argument{ "`v` must >= 0" };
 			typoCostWeight = v;
+			++configVersion;
 		}
 
 		bool getIntegrateAllomorph() const
@@ -512,6 +1015,7 @@ namespace kiwi
 		void setIntegrateAllomorph(bool v)
 		{
 			integrateAllomorph = v;
+			++configVersion;
 		}
 
 		const lm::KnLangModelBase* getKnLM() const
@@ -521,6 +1025,52 @@ namespace kiwi
 
 		void findMorpheme(std::vector<const Morpheme*>& out, const std::u16string& s, POSTag tag = POSTag::unknown) const;
 		std::vector<const Morpheme*> findMorpheme(const std::u16string& s, POSTag tag = POSTag::unknown) const;
+
+		/**
+		 * @brief 주어진 단어들로 이 Kiwi 객체에 사용할 수 있는 사용자 사전 오버레이를 생성한다.
+		 * 
+		 * @param words 추가할 단어 목록. 같은 형태와 품사가 여러 번 등장하면 마지막 것의 점수가 사용된다.
+		 * @return 생성된 오버레이. `setUserOverlay`로 설정해야 분석에 반영된다.
+		 * @exception std::invalid_argument 형태가 비어 있거나 공백을 포함하는 경우, 또는 품사가 용언이거나 올바르지 않은 경우
+		 * @sa UserOverlay
+		 */
+		std::shared_ptr<const UserOverlay> makeUserOverlay(std::vector<UserOverlay::Word> words) const;
+
+		/**
+		 * @brief 분석에 사용할 사용자 사전 오버레이를 교체한다. nullptr을 설정하면 오버레이를 제거한다.
+		 * 
+		 * @note 다른 스레드에서 분석이 진행 중이어도 안전하게 호출할 수 있다. 
+		 * 진행 중인 분석은 이전 오버레이로 마무리되고, 이후 시작되는 분석부터 새 오버레이가 사용된다.
+		 * @exception std::invalid_argument 다른 ArchType으로 생성된 Kiwi 객체의 오버레이인 경우
+		 */
+		void setUserOverlay(std::shared_ptr<const UserOverlay> overlay);
+
+		std::shared_ptr<const UserOverlay> getUserOverlay() const;
+
+		/**
+		 * @brief 현재 오버레이에 단어들을 더한 새 오버레이를 만들어 교체한다.
+		 * 
+		 * @return 새로 추가된 단어의 개수. 이미 있던 형태와 품사의 단어는 점수만 갱신되며 개수에 포함되지 않는다.
+		 * @note 여러 스레드에서 동시에 호출되어도 추가된 단어가 유실되지 않는다.
+		 * 다만 호출할 때마다 오버레이 전체를 다시 생성하므로 단어가 많을 경우 한 번에 모아서 추가하는 것이 좋다.
+		 */
+		size_t addUserWords(const std::vector<UserOverlay::Word>& words);
+
+		/**
+		 * @brief 형태 및 형태소 사전, 형태 Trie, 언어 모델, 결합 규칙을 복사하지 않고 공유하는 새 Kiwi 객체를 생성한다.
+		 * 
+		 * @return 현재 객체와 같은 설정과 사용자 사전 오버레이를 가지는 Kiwi 객체.
+		 * 분석 결과 캐시와 통계는 비어 있는 상태로 시작하며, 이후의 설정 변경이나 오버레이 교체는 서로에게 영향을 주지 않는다.
+		 * @note 같은 모델에 서로 다른 사용자 단어를 추가한 여러 Kiwi 객체가 필요한 경우,
+		 * 하나를 `KiwiBuilder::build`로 생성한 뒤 나머지는 이 함수로 생성하고 `setUserOverlay`나 `addUserWords`로 단어를 추가하면
+		 * 인스턴스마다 늘어나는 메모리를 오버레이의 크기로 줄일 수 있다.
+		 */
+		Kiwi clone() const;
+
+		/**
+		 * @brief 두 Kiwi 객체가 형태 및 형태소 사전을 공유하고 있는지 확인한다.
+		 */
+		bool sharesVocabWith(const Kiwi& o) const { return vocab && vocab == o.vocab; }
 	};
 
 	/**
@@ -659,7 +1209,7 @@ namespace kiwi
 		 * @brief KiwiBuilder를 모델 파일로부터 생성한다.
 		 * 
 		 * @param modelPath 모델이 위치한 경로
-		 * @param numThreads 모델 및 형태소 분석에 사용할 스레드 개수
+		 * @param numThreads 모델 및 형태소 분석에 사용할 스레드 개수. 0인 경우 공용 스레드 풀(`utils::getSharedThreadPool`)을 사용한다.
 		 * @param options 생성 옵션. `kiwi::BuildOption`을 참조
 		 */
 		KiwiBuilder(const std::string& modelPath, size_t numThreads = 0, BuildOption options = BuildOption::default_, bool useSBG = false);
@@ -675,7 +1225,17 @@ namespace kiwi
 			return !!langMdl.knlm;
 		}
 
-		void saveModel(const std::string& modelPath) const;
+		/**
+		 * @brief 현재 모델을 `modelPath`에 저장한다.
+		 * 
+		 * @param modelPath 모델을 저장할 경로
+		 * @param mappableLm true인 경우 언어 모델을 메모리 맵으로 바로 사용 가능한 레이아웃으로 저장한다. 
+		 * 이렇게 저장된 모델은 로딩 시 복사 및 역양자화 과정이 생략되므로 시작 시간이 짧고, 
+		 * 같은 모델을 사용하는 여러 프로세스가 메모리를 공유할 수 있다. 대신 파일 크기는 더 커진다.
+		 * @param lmLayout mappableLm이 true일 때 언어 모델의 키 배열을 어느 아키텍처의 탐색 순서로 배치할지 지정한다.
+		 * 기본값은 현재 빌더의 아키텍처이며, 모델을 실제로 사용할 기기의 아키텍처와 일치해야 로딩 시 재정렬이 생략된다.
+		 */
+		void saveModel(const std::string& modelPath, bool mappableLm = false, ArchType lmLayout = ArchType::default_) const;
 
 		/**
 		 * @brief 사전에 새로운 형태소를 추가한다. 이미 동일한 형태소가 있는 경우는 무시된다.
@@ -25,6 +25,30 @@ namespace kiwi
 			uint32_t extra_buf_size;
 		};
 
+		/**
+		 * @brief `Header::quantized`에 이 비트가 설정된 모델은 `MappedHeader`가 뒤따르는 
+		 * 메모리 맵 전용 레이아웃으로 저장된 것이다.
+		 * 
+		 * @note 이 레이아웃은 노드/키/값 배열과 역양자화된 float 배열을 로딩 시점의 형태 그대로 담고 있으므로
+		 * `KnLangModelBase::create`가 별도의 복사 없이 매핑된 메모리를 바로 사용할 수 있다.
+		 */
+		static constexpr uint8_t mappedLayoutFlag = 0x40;
+		static constexpr uint32_t mappedLayoutVersion = 1;
+		static constexpr size_t mappedLayoutAlignment = 64;
+
+		struct MappedHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t arch;
+			uint32_t reserved;
+			uint64_t num_non_leaf_nodes, htx_vocab_size;
+			uint64_t node_offset, key_offset, value_offset, ll_offset, htx_offset, extra_offset;
+			int64_t bos_node_idx;
+			float unk_ll;
+			uint32_t padding;
+		};
+
 		template<class KeyType, class DiffType = int32_t>
 		struct Node
 		{
@@ -37,8 +61,11 @@ namespace kiwi
 		{
 		protected:
 			utils::MemoryObject base;
+			uint64_t instanceId = 0;
 
-			KnLangModelBase(utils::MemoryObject&& mem) : base{ std::move(mem) }
+			static uint64_t newInstanceId();
+
+			KnLangModelBase(utils::MemoryObject&& mem) : base{ std::move(mem) }, instanceId{ newInstanceId() }
 			{
 			}
 
@@ -53,6 +80,28 @@ namespace kiwi
 			virtual ~KnLangModelBase() {}
 			const Header& getHeader() const { return *reinterpret_cast<const Header*>(base.get()); }
 
+			/**
+			 * @brief 프로세스 안에서 모델 객체마다 고유한 번호. 해제된 모델의 주소가 재사용되더라도 겹치지 않는다.
+			 */
+			uint64_t getInstanceId() const { return instanceId; }
+
+			/**
+			 * @brief 모델이 메모리 맵 전용 레이아웃으로부터 복사 없이 로딩되었는지 여부
+			 */
+			virtual bool isMapped() const = 0;
+
+			/**
+			 * @brief 현재 모델을 메모리 맵 전용 레이아웃으로 변환한다.
+			 * 
+			 * @param layoutArch 각 노드의 키 배열을 어느 아키텍처의 탐색 순서로 배치할지 지정한다.
+			 * `ArchType::default_`인 경우 현재 모델이 사용하는 아키텍처를 따른다.
+			 * 예를 들어 `ArchType::none`은 Eytzinger(BST) 순서로, `ArchType::avx512bw`는 캐시 라인(64바이트) 단위의 B-tree 순서로 배치한다.
+			 * 
+			 * @note 반환된 데이터는 `MappedHeader::arch`에 배치 순서를 기록해둔다.
+			 * 같은 아키텍처에서 로딩하면 복사 없이 바로 사용되지만, 다른 아키텍처에서 로딩할 경우에는 키 배열을 재정렬하기 위해 복사가 발생한다.
+			 */
+			virtual utils::MemoryOwner exportMappedLayout(ArchType layoutArch = ArchType::default_) const = 0;
+
 			virtual ptrdiff_t getLowerNode(ptrdiff_t node_idx) const = 0;
 
 			virtual size_t nonLeafNodeSize() const = 0;
@@ -31,6 +31,7 @@ namespace kiwi
 		public:
 			virtual ~SkipBigramModelBase() {}
 			const Header& getHeader() const { return *reinterpret_cast<const Header*>(base.get()); }
+			const utils::MemoryObject& getMemory() const { return base; }
 
 			static std::unique_ptr<SkipBigramModelBase> create(utils::MemoryObject&& mem, ArchType archType = ArchType::none);
 		};
@@ -1,95 +1,424 @@
 ﻿#pragma once
 
 /*
-A simple C++11 Thread Pool implementation(https://github.com/progschj/ThreadPool)
-modified by bab2min to have additional parameter threadId
+A work-stealing thread pool for Kiwi.
+Originally based on a simple C++11 Thread Pool implementation(https://github.com/progschj/ThreadPool)
+modified by bab2min to have additional parameter threadId.
+Each worker owns a bounded lock-free task queue. Submitted tasks are spread over the worker queues
+and idle workers steal from the queues of their siblings, so no single lock is shared by all workers.
+The same pool also serves the barrier-synchronized jobs of sais and FmIndex (see `runParallel`),
+and one process-wide instance can be shared by every component (see `getSharedThreadPool`).
 */
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include <future>
 #include <functional>
+#include <iterator>
+#include <algorithm>
 #include <stdexcept>
 
 namespace kiwi
 {
 	namespace utils
 	{
+		namespace detail
+		{
+			struct PoolTask
+			{
+				virtual ~PoolTask() = default;
+				virtual void run(size_t threadId) = 0;
+			};
+
+			template<class Fn>
+			struct PoolTaskImpl : public PoolTask
+			{
+				Fn fn;
+
+				template<class F>
+				PoolTaskImpl(F&& f) : fn(std::forward<F>(f)) {}
+
+				void run(size_t threadId) override
+				{
+					fn(threadId);
+				}
+			};
+
+			/*
+			 * Bounded MPMC queue (Dmitry Vyukov).
+			 * The owning worker pops from it, sibling workers steal from it and submitters push to it without taking any lock.
+			 */
+			class PoolTaskQueue
+			{
+				struct Cell
+				{
+					std::atomic<size_t> seq;
+					PoolTask* task;
+				};
+
+				std::unique_ptr<Cell[]> cells;
+				size_t mask = 0;
+				char pad0[64];
+				std::atomic<size_t> head = { 0 };
+				char pad1[64];
+				std::atomic<size_t> tail = { 0 };
+				char pad2[64];
+
+			public:
+				PoolTaskQueue(size_t capacity = 256)
+					: cells{ new Cell[capacity] }, mask{ capacity - 1 }
+				{
+					for (size_t i = 0; i < capacity; ++i)
+					{
+						cells[i].seq.store(i, std::memory_order_relaxed);
+						cells[i].task = nullptr;
+					}
+				}
+
+				bool push(PoolTask* task)
+				{
+					size_t pos = tail.load(std::memory_order_relaxed);
+					for (;;)
+					{
+						Cell& cell = cells[pos & mask];
+						const size_t seq = cell.seq.load(std::memory_order_acquire);
+						const ptrdiff_t dif = (ptrdiff_t)seq - (ptrdiff_t)pos;
+						if (dif == 0)
+						{
+							if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+							{
+								cell.task = task;
+								cell.seq.store(pos + 1, std::memory_order_release);
+								return true;
+							}
+						}
+						else if (dif < 0)
+						{
+							return false;
+						}
+						else
+						{
+							pos = tail.load(std::memory_order_relaxed);
+						}
+					}
+				}
+
+				PoolTask* pop()
+				{
+					size_t pos = head.load(std::memory_order_relaxed);
+					for (;;)
+					{
+						Cell& cell = cells[pos & mask];
+						const size_t seq = cell.seq.load(std::memory_order_acquire);
+						const ptrdiff_t dif = (ptrdiff_t)seq - (ptrdiff_t)(pos + 1);
+						if (dif == 0)
+						{
+							if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+							{
+								PoolTask* task = cell.task;
+								cell.seq.store(pos + mask + 1, std::memory_order_release);
+								return task;
+							}
+						}
+						else if (dif < 0)
+						{
+							return nullptr;
+						}
+						else
+						{
+							pos = head.load(std::memory_order_relaxed);
+						}
+					}
+				}
+			};
+		}
+
+		/**
+		 * @brief `ThreadPool::runParallel`로 함께 실행되는 작업들이 서로를 기다리기 위한 장벽
+		 */
+		class Barrier
+		{
+			std::mutex mtx;
+			std::condition_variable cnd;
+			size_t threshold, count, generation = 0;
+		public:
+			explicit Barrier(size_t n) : threshold{ n }, count{ n } {}
+
+			Barrier(const Barrier&) = delete;
+			Barrier& operator=(const Barrier&) = delete;
+
+			void wait()
+			{
+				std::unique_lock<std::mutex> lock{ mtx };
+				const size_t gen = generation;
+				if (!--count)
+				{
+					++generation;
+					count = threshold;
+					cnd.notify_all();
+				}
+				else
+				{
+					cnd.wait(lock, [&]() { return gen != generation; });
+				}
+			}
+		};
+
 		class ThreadPool
 		{
 		public:
-			ThreadPool(size_t threads = 0, size_t maxQueued = 0);
+			/**
+			 * @param threads 작업자 스레드 개수
+			 * @param maxQueued 대기 중인 작업 개수의 상한. 이를 넘으면 작업 추가가 블록된다. 0이면 제한하지 않는다.
+			 * @param pinWorkers true이면 각 작업자를 하나의 논리 코어에 고정한다.
+			 * 코어는 NUMA 노드 순으로 배정되므로 id가 인접한 작업자(=먼저 작업을 훔쳐가는 작업자)는 같은 노드에 놓인다.
+			 */
+			ThreadPool(size_t threads = 0, size_t maxQueued = 0, bool pinWorkers = false);
 			~ThreadPool();
 
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
 			template<class F, class... Args>
 			auto enqueue(F&& f, Args&&... args)
 				->std::future<typename std::result_of<F(size_t, Args...)>::type>;
 
-			size_t size() const { return workers.size(); }
-			size_t numEnqueued() const { return tasks.size(); }
+			/**
+			 * @brief future를 생성하지 않고 작업을 추가한다.
+			 * @param f `void(size_t threadId)` 형태의 호출 가능한 객체. 예외를 밖으로 던져서는 안 된다.
+			 * @note 작업 완료를 기다려야 하는 경우 `WaitGroup`과 함께 사용한다.
+			 */
+			template<class F>
+			void submit(F&& f);
+
+			/**
+			 * @brief f(threadId, numThreads, barrier)를 최대 maxWorkers개의 스레드에서 동시에 실행하고 모두 끝날 때까지 기다린다.
+			 * @details 호출한 스레드가 threadId 0을 맡고 나머지는 작업자들이 맡는다.
+			 * 모든 참여자가 동시에 실행되는 것이 보장되므로 f 안에서 `barrier->wait()`로 서로를 기다릴 수 있다.
+			 * 동시 실행을 보장하기 위해 한 스레드 풀에서 이러한 작업 묶음은 한 번에 하나씩만 실행된다.
+			 * 작업자 스레드나 이미 실행 중인 묶음의 threadId 0을 맡은 스레드에서 호출된 경우에는 교착을 피하기 위해 f(0, 1, nullptr)를 바로 실행한다.
+			 * @return 각 threadId별 f의 실행 결과를 담은 future들. 반환 시점에 모두 준비된 상태이다.
+			 */
+			template<class F>
+			auto runParallel(size_t maxWorkers, F&& f)
+				->std::vector<std::future<typename std::result_of<F(size_t, size_t, Barrier*)>::type>>;
+
+			size_t size() const { return numWorkers; }
+			size_t numEnqueued() const { return (size_t)pending.load(std::memory_order_relaxed); }
+
+			/**
+			 * @brief 호출한 스레드가 이 스레드 풀의 작업자이거나 `runParallel` 묶음의 threadId 0을 실행 중인지 확인한다.
+			 * @note 이러한 스레드에서 다른 작업의 완료를 기다리면 교착 상태에 빠질 수 있으므로 작업을 나누기 전에 확인한다.
+			 */
+			bool isWorkerThread() const
+			{
+				const auto& wid = currentWorker();
+				return wid.pool == this || wid.leading == this;
+			}
 			void joinAll();
 		private:
+			struct WorkerId
+			{
+				const ThreadPool* pool = nullptr;
+				const ThreadPool* leading = nullptr;
+				size_t id = 0;
+			};
+
+			static WorkerId& currentWorker()
+			{
+				static thread_local WorkerId wid;
+				return wid;
+			}
+
+			void push(detail::PoolTask* task);
+			detail::PoolTask* take(size_t id);
+			void workerLoop(size_t id);
+
 			std::vector<std::thread> workers;
-			std::queue<std::function<void(size_t)>> tasks;
+			size_t numWorkers;
+			std::unique_ptr<detail::PoolTaskQueue[]> queues;
+			std::deque<detail::PoolTask*> overflow;
+			std::mutex overflowMutex;
+			std::atomic<size_t> overflowSize = { 0 };
+			std::atomic<size_t> nextQueue = { 0 };
+			std::atomic<ptrdiff_t> pending = { 0 };
 
 			std::mutex queue_mutex;
 			std::condition_variable condition, inputCnd;
-			bool stop;
+			std::atomic<size_t> sleepers = { 0 }, blockedInputs = { 0 };
+			std::atomic<bool> stop = { false };
 			size_t maxQueued;
+			std::mutex groupMutex;
 		};
 
-		inline ThreadPool::ThreadPool(size_t threads, size_t _maxQueued)
-			: stop(false), maxQueued(_maxQueued)
+		namespace detail
+		{
+			/**
+			 * @brief 작업자를 고정할 논리 코어들을 NUMA 노드 순으로 정렬하여 반환한다. 현재 프로세스에 허용된 코어만 포함된다.
+			 * @note 코어 고정을 지원하지 않는 플랫폼에서는 빈 배열을 반환한다.
+			 */
+			std::vector<size_t> getCoresByNumaNode();
+
+			bool pinCurrentThread(size_t core);
+		}
+
+		inline ThreadPool::ThreadPool(size_t threads, size_t _maxQueued, bool pinWorkers)
+			: numWorkers{ threads }, queues{ threads ? new detail::PoolTaskQueue[threads] : nullptr }, maxQueued(_maxQueued)
 		{
+			std::vector<size_t> cores;
+			if (pinWorkers) cores = detail::getCoresByNumaNode();
+			workers.reserve(threads);
 			for (size_t i = 0; i < threads; ++i)
-				workers.emplace_back([this, i]
 			{
-				for (;;)
+				const size_t core = cores.empty() ? (size_t)-1 : cores[i % cores.size()];
+				workers.emplace_back([this, i, core]
 				{
-					std::function<void(size_t)> task;
-					{
-						std::unique_lock<std::mutex> lock(this->queue_mutex);
-						this->condition.wait(lock,
-							[this] { return this->stop || !this->tasks.empty(); });
-						if (this->stop && this->tasks.empty()) return;
-						task = std::move(this->tasks.front());
-						this->tasks.pop();
-						if (this->maxQueued) this->inputCnd.notify_all();
-					}
-					task(i);
-				}
-			});
+					if (core != (size_t)-1) detail::pinCurrentThread(core);
+					workerLoop(i);
+				});
+			}
 		}
 
-		template<class F, class... Args>
-		auto ThreadPool::enqueue(F&& f, Args&&... args)
-			-> std::future<typename std::result_of<F(size_t, Args...)>::type>
+		inline void ThreadPool::push(detail::PoolTask* task)
 		{
-			using return_type = typename std::result_of<F(size_t, Args...)>::type;
+			if (stop.load(std::memory_order_relaxed))
+			{
+				delete task;
+				throw std::runtime_error("enqueue on stopped ThreadPool");
+			}
 
-			auto task = std::make_shared< std::packaged_task<return_type(size_t)> >(
-				std::bind(std::forward<F>(f), std::placeholders::_1, std::forward<Args>(args)...));
+			if (!numWorkers)
+			{
+				std::unique_ptr<detail::PoolTask> t{ task };
+				t->run(0);
+				return;
+			}
 
-			std::future<return_type> res = task->get_future();
+			if (maxQueued && (size_t)pending.load(std::memory_order_seq_cst) >= maxQueued)
 			{
 				std::unique_lock<std::mutex> lock(queue_mutex);
+				blockedInputs.fetch_add(1, std::memory_order_seq_cst);
+				inputCnd.wait(lock, [&]() { return (size_t)pending.load(std::memory_order_seq_cst) < maxQueued; });
+				blockedInputs.fetch_sub(1, std::memory_order_relaxed);
+			}
+
+			// the counter is raised before the task becomes visible so that a consumer never observes a negative count
+			pending.fetch_add(1, std::memory_order_seq_cst);
+
+			// a worker submitting a task prefers its own queue to keep the data hot in its cache
+			const auto& wid = currentWorker();
+			const size_t n = numWorkers;
+			const size_t start = wid.pool == this ? wid.id : nextQueue.fetch_add(1, std::memory_order_relaxed) % n;
+			bool pushed = false;
+			for (size_t i = 0; i < n && !pushed; ++i)
+			{
+				pushed = queues[(start + i) % n].push(task);
+			}
 
-				// don't allow enqueueing after stopping the pool
-				if (stop) throw std::runtime_error("enqueue on stopped ThreadPool");
-				if (maxQueued && tasks.size() >= maxQueued)
+			if (!pushed)
+			{
+				std::lock_guard<std::mutex> lock(overflowMutex);
+				overflow.emplace_back(task);
+				overflowSize.fetch_add(1, std::memory_order_release);
+			}
+
+			// waking a worker is only needed when some of them are parked.
+			// A worker raises `sleepers` before it re-checks `pending`, so either it sees this task or we see it parking.
+			if (sleepers.load(std::memory_order_seq_cst))
+			{
 				{
-					inputCnd.wait(lock, [&]() { return tasks.size() < maxQueued; });
+					std::lock_guard<std::mutex> lock(queue_mutex);
 				}
-				tasks.emplace([task](size_t id) { (*task)(id); });
+				condition.notify_one();
 			}
-			condition.notify_one();
+		}
+
+		inline detail::PoolTask* ThreadPool::take(size_t id)
+		{
+			const size_t n = numWorkers;
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (auto* task = queues[(id + i) % n].pop()) return task;
+			}
+
+			if (overflowSize.load(std::memory_order_acquire))
+			{
+				std::lock_guard<std::mutex> lock(overflowMutex);
+				if (!overflow.empty())
+				{
+					auto* task = overflow.front();
+					overflow.pop_front();
+					overflowSize.fetch_sub(1, std::memory_order_relaxed);
+					return task;
+				}
+			}
+			return nullptr;
+		}
+
+		inline void ThreadPool::workerLoop(size_t id)
+		{
+			currentWorker().pool = this;
+			currentWorker().id = id;
+			size_t idleRounds = 0;
+			for (;;)
+			{
+				if (auto* task = take(id))
+				{
+					idleRounds = 0;
+					pending.fetch_sub(1, std::memory_order_seq_cst);
+					if (maxQueued && blockedInputs.load(std::memory_order_seq_cst))
+					{
+						{
+							std::lock_guard<std::mutex> lock(queue_mutex);
+						}
+						inputCnd.notify_all();
+					}
+					std::unique_ptr<detail::PoolTask> t{ task };
+					t->run(id);
+					continue;
+				}
+
+				// a task counted in `pending` but not yet pushed will show up shortly, so spin a little before parking
+				if (pending.load(std::memory_order_seq_cst) > 0 || ++idleRounds < 64)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				idleRounds = 0;
+
+				std::unique_lock<std::mutex> lock(queue_mutex);
+				sleepers.fetch_add(1, std::memory_order_seq_cst);
+				condition.wait(lock, [&] { return stop.load(std::memory_order_relaxed) || pending.load(std::memory_order_seq_cst) > 0; });
+				sleepers.fetch_sub(1, std::memory_order_relaxed);
+				if (stop.load(std::memory_order_relaxed) && pending.load(std::memory_order_seq_cst) <= 0) return;
+			}
+		}
+
+		template<class F, class... Args>
+		auto ThreadPool::enqueue(F&& f, Args&&... args)
+			-> std::future<typename std::result_of<F(size_t, Args...)>::type>
+		{
+			using return_type = typename std::result_of<F(size_t, Args...)>::type;
+
+			std::packaged_task<return_type(size_t)> task{
+				std::bind(std::forward<F>(f), std::placeholders::_1, std::forward<Args>(args)...)
+			};
+			std::future<return_type> res = task.get_future();
+			push(new detail::PoolTaskImpl<std::packaged_task<return_type(size_t)>>{ std::move(task) });
 			return res;
 		}
 
+		template<class F>
+		void ThreadPool::submit(F&& f)
+		{
+			push(new detail::PoolTaskImpl<typename std::decay<F>::type>{ std::forward<F>(f) });
+		}
+
 		inline void ThreadPool::joinAll()
 		{
 			if (stop) return;
@@ -108,10 +437,157 @@ namespace kiwi
 			joinAll();
 		}
 
+		/**
+		 * @brief `ThreadPool::submit`으로 추가한 작업들이 모두 끝날 때까지 기다리기 위한 카운터
+		 * @note 작업 내에서 발생한 첫번째 예외는 `wait()`에서 다시 던져진다.
+		 */
+		class WaitGroup
+		{
+			std::mutex mtx;
+			std::condition_variable cnd;
+			size_t remaining = 0;
+			std::exception_ptr error;
+		public:
+			WaitGroup(size_t n = 0) : remaining{ n } {}
+
+			void add(size_t n = 1)
+			{
+				std::lock_guard<std::mutex> lock{ mtx };
+				remaining += n;
+			}
+
+			void done()
+			{
+				std::lock_guard<std::mutex> lock{ mtx };
+				if (--remaining == 0) cnd.notify_all();
+			}
+
+			void fail(std::exception_ptr e)
+			{
+				std::lock_guard<std::mutex> lock{ mtx };
+				if (!error) error = std::move(e);
+				if (--remaining == 0) cnd.notify_all();
+			}
+
+			/**
+			 * @brief fn을 실행하고 작업 하나가 끝났음을 기록한다. fn에서 발생한 예외는 `wait()`로 전달된다.
+			 */
+			template<class Fn>
+			void run(Fn&& fn)
+			{
+				try
+				{
+					fn();
+				}
+				catch (...)
+				{
+					fail(std::current_exception());
+					return;
+				}
+				done();
+			}
+
+			void wait()
+			{
+				std::unique_lock<std::mutex> lock{ mtx };
+				cnd.wait(lock, [&]() { return remaining == 0; });
+				if (error) std::rethrow_exception(error);
+			}
+		};
+
+		template<class F>
+		auto ThreadPool::runParallel(size_t maxWorkers, F&& f)
+			-> std::vector<std::future<typename std::result_of<F(size_t, size_t, Barrier*)>::type>>
+		{
+			using return_type = typename std::result_of<F(size_t, size_t, Barrier*)>::type;
+			std::vector<std::future<return_type>> ret;
+			const size_t n = std::min(maxWorkers, numWorkers);
+			if (n <= 1 || isWorkerThread())
+			{
+				std::packaged_task<return_type(size_t, size_t, Barrier*)> task{ std::ref(f) };
+				ret.emplace_back(task.get_future());
+				task(0, 1, nullptr);
+				return ret;
+			}
+
+			// 두 묶음이 서로의 참여자가 실행되기를 기다리며 작업자를 나눠 가지는 일이 없도록 묶음 단위로 직렬화한다
+			std::lock_guard<std::mutex> groupLock{ groupMutex };
+			// threadId 0을 실행하는 동안 같은 스레드에서 다시 묶음을 시작하면 groupMutex에서 스스로를 기다리게 되므로 표시해둔다
+			struct LeadingGuard
+			{
+				const ThreadPool*& leading;
+				const ThreadPool* prev;
+				LeadingGuard(const ThreadPool*& _leading, const ThreadPool* pool) : leading{ _leading }, prev{ _leading } { leading = pool; }
+				~LeadingGuard() { leading = prev; }
+			} leadingGuard{ currentWorker().leading, this };
+			Barrier barrier{ n };
+			WaitGroup wg{ n - 1 };
+			std::vector<std::packaged_task<return_type(size_t, size_t, Barrier*)>> tasks;
+			tasks.reserve(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				tasks.emplace_back(std::ref(f));
+				ret.emplace_back(tasks.back().get_future());
+			}
+			for (size_t i = 1; i < n; ++i)
+			{
+				submit([&, i](size_t)
+				{
+					tasks[i](i, n, &barrier);
+					wg.done();
+				});
+			}
+			tasks[0](0, n, &barrier);
+			wg.wait();
+			return ret;
+		}
+
+		/**
+		 * @brief [first, last) 범위의 각 인덱스 i에 대해 fn(threadId, i)를 병렬로 호출한다.
+		 * @details 범위를 작은 조각으로 나누어 작업자들이 동적으로 가져가므로 항목마다 처리 시간이 크게 다르더라도 부하가 고르게 분산된다.
+		 * @param grain 한 번에 가져가는 조각의 크기. 0이면 자동으로 결정한다.
+		 * @note 작업자 스레드에서 호출되면 교착을 피하기 위해 호출한 스레드에서 순서대로 실행한다.
+		 */
+		template<class Fn>
+		void parallelFor(ThreadPool* pool, size_t first, size_t last, Fn&& fn, size_t grain = 0)
+		{
+			if (first >= last) return;
+			if (!pool || pool->size() <= 1 || last - first == 1 || pool->isWorkerThread())
+			{
+				for (; first < last; ++first) fn((size_t)0, first);
+				return;
+			}
+
+			const size_t numItems = last - first;
+			if (!grain) grain = std::max(numItems / (pool->size() * 16), (size_t)1);
+			const size_t numTasks = std::min(pool->size(), (numItems + grain - 1) / grain);
+			std::atomic<size_t> next = { first };
+			WaitGroup wg{ numTasks };
+			for (size_t i = 0; i < numTasks; ++i)
+			{
+				pool->submit([&](size_t tid)
+				{
+					wg.run([&]()
+					{
+						for (size_t b; (b = next.fetch_add(grain, std::memory_order_relaxed)) < last;)
+						{
+							const size_t e = std::min(b + grain, last);
+							for (; b < e; ++b) fn(tid, b);
+						}
+					});
+				});
+			}
+			wg.wait();
+		}
+
+		/**
+		 * @brief [first, last) 범위를 작업자 수만큼 나누어 각 항목에 대해 fn(threadId, item)을 병렬로 호출한다.
+		 * @note 작업자 스레드에서 호출되면 교착을 피하기 위해 호출한 스레드에서 순서대로 실행한다.
+		 */
 		template<class InputIt, class Fn>
 		void forEach(ThreadPool* pool, InputIt first, InputIt last, Fn fn)
 		{
-			if (!pool)
+			if (!pool || pool->size() <= 1 || pool->isWorkerThread())
 			{
 				for (; first != last; ++first)
 				{
@@ -122,27 +598,27 @@ namespace kiwi
 			{
 				const size_t numItems = std::distance(first, last);
 				const size_t numWorkers = std::min(pool->size(), numItems);
-				std::vector<std::future<void>> futures;
-				futures.reserve(numWorkers);
+				if (!numWorkers) return;
+				WaitGroup wg{ numWorkers };
 
 				for (size_t i = 0; i < numWorkers; ++i)
 				{
 					InputIt mid = first;
 					std::advance(mid, (numItems * (i + 1) / numWorkers) - (numItems * i / numWorkers));
-					futures.emplace_back(pool->enqueue([&](size_t tid, InputIt tFirst, InputIt tLast)
+					pool->submit([&, tFirst = first, tLast = mid](size_t tid) mutable
 					{
-						for (; tFirst != tLast; ++tFirst)
+						wg.run([&]()
 						{
-							fn(tid, *tFirst);
-						}
-					}, first, mid));
+							for (; tFirst != tLast; ++tFirst)
+							{
+								fn(tid, *tFirst);
+							}
+						});
+					});
 					first = mid;
 				}
-				
-				for (auto& f : futures)
-				{
-					f.get();
-				}
+
+				wg.wait();
 			}
 		}
 
@@ -151,5 +627,26 @@ namespace kiwi
 		{
 			forEach(pool, std::begin(cont), std::end(cont), fn);
 		}
+
+		/**
+		 * @brief 프로세스 전체에서 공유하는 스레드 풀을 반환한다.
+		 * @details 최초 호출 시 생성된다. 작업자 수는 환경변수 `KIWI_NUM_THREADS`가 설정되어 있으면 그 값을, 아니면 하드웨어 스레드 수를 따른다.
+		 * 환경변수 `KIWI_THREAD_AFFINITY`가 0이 아닌 값이면 작업자들을 코어에 고정한다.
+		 */
+		std::shared_ptr<ThreadPool> getSharedThreadPool();
+
+		/**
+		 * @brief 프로세스 전체에서 공유할 스레드 풀을 교체한다.
+		 * @note 이미 이전 풀을 받아간 객체들은 계속 이전 풀을 사용한다.
+		 */
+		void setSharedThreadPool(std::shared_ptr<ThreadPool> pool);
+
+		/**
+		 * @brief numThreads개의 작업자로 작업을 처리할 스레드 풀을 얻는다.
+		 * @details numThreads가 0이거나 공유 풀의 작업자 수와 같으면 공유 풀을 반환하여, 
+		 * 한 프로세스 내의 여러 구성 요소가 각자 풀을 만들어 코어를 과다하게 점유하는 일을 막는다.
+		 * 그 외의 경우에는 numThreads개의 작업자를 가진 전용 풀을 새로 생성한다.
+		 */
+		std::shared_ptr<ThreadPool> acquireThreadPool(size_t numThreads);
 	}
 }
@@ -403,6 +403,18 @@ namespace kiwi
 				return &nodes.back();
 			}
 
+			/**
+			 * @brief 다른 트라이의 [skip, o.size()) 범위의 노드들을 뒤에 이어붙이고, 이어붙인 첫 노드의 위치를 반환한다.
+			 * @details 노드 사이의 연결은 상대 위치로 저장되므로 이어붙인 노드들끼리의 연결은 그대로 유지된다.
+			 * 이어붙인 노드로의 연결은 호출하는 쪽에서 직접 만들어야 한다.
+			 */
+			size_t append(ContinuousTrie&& o, size_t skip = 0)
+			{
+				const size_t offset = nodes.size();
+				nodes.insert(nodes.end(), std::make_move_iterator(o.nodes.begin() + skip), std::make_move_iterator(o.nodes.end()));
+				return offset;
+			}
+
 			template<class Iter, class Value>
 			Node* build(Iter first, Iter last, Value&& val)
 			{
@@ -383,6 +383,172 @@ namespace kiwi
 	 */
 	using TokenResult = std::pair<std::vector<TokenInfo>, float>;
 
+	/**
+	 * @brief 여러 분석 결과를 열(column) 단위로 모아 담는 구조체
+	 * 
+	 * @note 모든 형태는 `formPool` 하나에 이어 붙여 저장되고, 형태소별 정보는 같은 인덱스를 공유하는 배열들에 나뉘어 저장된다.
+	 * 입력 i의 분석 결과는 [inputOffsets[i], inputOffsets[i + 1]) 범위에 있고,
+	 * 분석 결과 r의 형태소는 [resultOffsets[r], resultOffsets[r + 1]) 범위에 있다.
+	 * 형태소 t의 형태는 formPool의 [formOffsets[t], formOffsets[t + 1]) 구간이다.
+	 */
+	struct ColumnarTokenResult
+	{
+		std::u16string formPool;
+		std::vector<uint32_t> formOffsets = { 0 };
+		std::vector<uint32_t> positions;
+		std::vector<uint32_t> wordPositions;
+		std::vector<uint32_t> sentPositions;
+		std::vector<uint32_t> lineNumbers;
+		std::vector<uint16_t> lengths;
+		std::vector<POSTag> tags;
+		std::vector<uint8_t> senseIds; /**< `TokenInfo::senseId` 혹은 `TokenInfo::script` */
+		std::vector<float> scores;
+		std::vector<float> typoCosts;
+		std::vector<uint32_t> typoFormIds;
+		std::vector<uint32_t> pairedTokens;
+		std::vector<uint32_t> subSentPositions;
+		std::vector<const Morpheme*> morphs;
+
+		std::vector<uint32_t> resultOffsets = { 0 };
+		std::vector<float> resultScores;
+		std::vector<uint32_t> inputOffsets = { 0 };
+
+		size_t numInputs() const { return inputOffsets.size() - 1; }
+		size_t numResults() const { return resultOffsets.size() - 1; }
+		size_t numTokens() const { return formOffsets.size() - 1; }
+
+		const char16_t* formData(size_t token) const { return formPool.data() + formOffsets[token]; }
+		size_t formSize(size_t token) const { return formOffsets[token + 1] - formOffsets[token]; }
+		std::u16string form(size_t token) const { return std::u16string{ formData(token), formSize(token) }; }
+
+		/**
+		 * @brief 내용을 모두 지운다. 할당된 메모리는 유지되므로 다음 분석에 재사용된다.
+		 */
+		void clear()
+		{
+			formPool.clear();
+			for (auto* v : { &formOffsets, &positions, &wordPositions, &sentPositions, &lineNumbers, &typoFormIds, &pairedTokens, &subSentPositions, &resultOffsets, &inputOffsets })
+			{
+				v->clear();
+			}
+			lengths.clear();
+			tags.clear();
+			senseIds.clear();
+			scores.clear();
+			typoCosts.clear();
+			morphs.clear();
+			resultScores.clear();
+			formOffsets.emplace_back(0);
+			resultOffsets.emplace_back(0);
+			inputOffsets.emplace_back(0);
+		}
+
+		void reserve(size_t tokens, size_t chars)
+		{
+			formPool.reserve(chars);
+			for (auto* v : { &formOffsets, &positions, &wordPositions, &sentPositions, &lineNumbers, &typoFormIds, &pairedTokens, &subSentPositions })
+			{
+				v->reserve(tokens + 1);
+			}
+			lengths.reserve(tokens);
+			tags.reserve(tokens);
+			senseIds.reserve(tokens);
+			scores.reserve(tokens);
+			typoCosts.reserve(tokens);
+			morphs.reserve(tokens);
+		}
+
+		void pushToken(const TokenInfo& t)
+		{
+			formPool += t.str;
+			formOffsets.emplace_back((uint32_t)formPool.size());
+			positions.emplace_back(t.position);
+			wordPositions.emplace_back(t.wordPosition);
+			sentPositions.emplace_back(t.sentPosition);
+			lineNumbers.emplace_back(t.lineNumber);
+			lengths.emplace_back(t.length);
+			tags.emplace_back(t.tag);
+			senseIds.emplace_back(t.senseId);
+			scores.emplace_back(t.score);
+			typoCosts.emplace_back(t.typoCost);
+			typoFormIds.emplace_back(t.typoFormId);
+			pairedTokens.emplace_back(t.pairedToken);
+			subSentPositions.emplace_back(t.subSentPosition);
+			morphs.emplace_back(t.morph);
+		}
+
+		/**
+		 * @brief 입력 하나에 대한 분석 결과(top-N개)를 뒤에 추가한다.
+		 */
+		void pushInput(const std::vector<TokenResult>& results)
+		{
+			for (auto& r : results)
+			{
+				for (auto& t : r.first) pushToken(t);
+				resultOffsets.emplace_back((uint32_t)numTokens());
+				resultScores.emplace_back(r.second);
+			}
+			inputOffsets.emplace_back((uint32_t)numResults());
+		}
+
+		/**
+		 * @brief 다른 ColumnarTokenResult의 내용을 모두 뒤에 이어 붙인다.
+		 */
+		void append(const ColumnarTokenResult& o)
+		{
+			const uint32_t charBase = (uint32_t)formPool.size(), tokenBase = (uint32_t)numTokens(), resultBase = (uint32_t)numResults();
+			formPool += o.formPool;
+			for (size_t i = 1; i < o.formOffsets.size(); ++i) formOffsets.emplace_back(o.formOffsets[i] + charBase);
+			for (size_t i = 1; i < o.resultOffsets.size(); ++i) resultOffsets.emplace_back(o.resultOffsets[i] + tokenBase);
+			for (size_t i = 1; i < o.inputOffsets.size(); ++i) inputOffsets.emplace_back(o.inputOffsets[i] + resultBase);
+			positions.insert(positions.end(), o.positions.begin(), o.positions.end());
+			wordPositions.insert(wordPositions.end(), o.wordPositions.begin(), o.wordPositions.end());
+			sentPositions.insert(sentPositions.end(), o.sentPositions.begin(), o.sentPositions.end());
+			lineNumbers.insert(lineNumbers.end(), o.lineNumbers.begin(), o.lineNumbers.end());
+			lengths.insert(lengths.end(), o.lengths.begin(), o.lengths.end());
+			tags.insert(tags.end(), o.tags.begin(), o.tags.end());
+			senseIds.insert(senseIds.end(), o.senseIds.begin(), o.senseIds.end());
+			scores.insert(scores.end(), o.scores.begin(), o.scores.end());
+			typoCosts.insert(typoCosts.end(), o.typoCosts.begin(), o.typoCosts.end());
+			typoFormIds.insert(typoFormIds.end(), o.typoFormIds.begin(), o.typoFormIds.end());
+			pairedTokens.insert(pairedTokens.end(), o.pairedTokens.begin(), o.pairedTokens.end());
+			subSentPositions.insert(subSentPositions.end(), o.subSentPositions.begin(), o.subSentPositions.end());
+			morphs.insert(morphs.end(), o.morphs.begin(), o.morphs.end());
+			resultScores.insert(resultScores.end(), o.resultScores.begin(), o.resultScores.end());
+		}
+
+		/**
+		 * @brief 형태소 하나를 `TokenInfo`로 복원한다.
+		 */
+		TokenInfo getToken(size_t token) const
+		{
+			TokenInfo t{ form(token), tags[token], lengths[token], positions[token], wordPositions[token], scores[token] };
+			t.sentPosition = sentPositions[token];
+			t.lineNumber = lineNumbers[token];
+			t.senseId = senseIds[token];
+			t.typoCost = typoCosts[token];
+			t.typoFormId = typoFormIds[token];
+			t.pairedToken = pairedTokens[token];
+			t.subSentPosition = subSentPositions[token];
+			t.morph = morphs[token];
+			return t;
+		}
+
+		/**
+		 * @brief 분석 결과 하나를 `TokenResult`로 복원한다.
+		 */
+		TokenResult getResult(size_t result) const
+		{
+			TokenResult ret;
+			for (size_t t = resultOffsets[result]; t < resultOffsets[result + 1]; ++t)
+			{
+				ret.first.emplace_back(getToken(t));
+			}
+			ret.second = resultScores[result];
+			return ret;
+		}
+	};
+
 	using U16Reader = std::function<std::u16string()>;
 	using U16MultipleReader = std::function<U16Reader()>;
 
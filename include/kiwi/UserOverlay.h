@@ -0,0 +1,86 @@
+/**
+ * @file UserOverlay.h
+ * @author bab2min (bab2min@gmail.com)
+ * @brief 생성된 Kiwi에 덧씌워 사용하는 사용자 사전 오버레이
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Types.h"
+#include "Form.h"
+#include "Utils.h"
+#include "FrozenTrie.h"
+
+namespace kiwi
+{
+	class Kiwi;
+
+	/**
+	 * @brief 이미 생성된 `Kiwi`에 덧씌워 사용하는 사용자 사전.
+	 * @details `KiwiBuilder`로 모델 전체를 다시 생성하지 않고도 단어를 추가할 수 있도록 별도의 작은 형태 트라이와 형태소 목록을 가진다.
+	 * 형태 분할 시 `Kiwi`의 기본 형태 트라이와 함께 탐색되며, 오버레이의 단어는 `KiwiBuilder::addWord`로 추가한 단어처럼
+	 * 언어 모델 상에서 품사별 기본 형태소로 취급되고 `score`만큼의 사용자 점수를 받는다.
+	 *
+	 * 한번 생성된 오버레이는 변경되지 않는다. 단어를 추가하려면 `Kiwi::makeUserOverlay`로 새 오버레이를 만들어 `Kiwi::setUserOverlay`로 교체하거나
+	 * `Kiwi::addUserWords`를 사용한다. 교체는 원자적으로 이뤄지며, 이미 분석 중인 스레드는 그 분석이 끝날 때까지 이전 오버레이를 계속 사용한다.
+	 * @note 공백을 포함하는 단어와 용언(동사, 형용사 등)은 활용형을 생성해야 하므로 오버레이에 추가할 수 없다.
+	 * 오버레이는 `Kiwi::save`로 저장되지 않으므로 `Kiwi::loadBaked`로 불러온 뒤 다시 설정해야 한다.
+	 */
+	class UserOverlay
+	{
+		friend class Kiwi;
+	public:
+		struct Word
+		{
+			std::u16string form;
+			POSTag tag = POSTag::nnp;
+			float score = 0;
+
+			Word(const std::u16string& _form = {}, POSTag _tag = POSTag::nnp, float _score = 0)
+				: form{ _form }, tag{ _tag }, score{ _score }
+			{
+			}
+		};
+
+		UserOverlay() = default;
+		UserOverlay(const UserOverlay&) = delete;
+		UserOverlay& operator=(const UserOverlay&) = delete;
+
+		/**
+		 * @brief 오버레이에 포함된 단어 목록. 같은 형태와 품사를 가진 단어는 마지막으로 추가된 것 하나만 남는다.
+		 */
+		const std::vector<Word>& getWords() const { return words; }
+
+		size_t size() const { return words.size(); }
+
+		bool empty() const { return words.empty(); }
+
+		/**
+		 * @brief 오버레이마다 고유하게 부여되는 번호. 분석 결과 캐시의 키로 사용된다.
+		 */
+		uint64_t getGeneration() const { return generation; }
+
+		ArchType archType() const { return arch; }
+
+		const FormTrie& getTrie() const { return trie; }
+
+		bool ownsForm(const Form* form) const
+		{
+			return within(form, forms);
+		}
+
+		bool ownsMorpheme(const Morpheme* morph) const
+		{
+			return within(morph, morphemes);
+		}
+
+	private:
+		std::vector<Word> words;
+		Vector<Form> forms;
+		Vector<Morpheme> morphemes;
+		FormTrie trie;
+		uint64_t generation = 0;
+		ArchType arch = ArchType::none;
+	};
+}
@@ -28,6 +28,7 @@
 typedef struct kiwi_s* kiwi_h;
 typedef struct kiwi_builder* kiwi_builder_h;
 typedef struct kiwi_res* kiwi_res_h;
+typedef struct kiwi_cres* kiwi_cres_h;
 typedef struct kiwi_ws* kiwi_ws_h;
 typedef struct kiwi_ss* kiwi_ss_h;
 typedef struct kiwi_joiner* kiwi_joiner_h;
@@ -57,6 +58,26 @@ typedef struct {
 	uint32_t sub_sent_position; /**< 인용부호나 괄호로 둘러싸인 하위 문장의 번호. 1부터 시작. 0인 경우 하위 문장이 아님을 뜻함 */
 } kiwi_token_info_t;
 
+typedef struct {
+	uint64_t num_analyzed; /**< 분석한 텍스트의 개수 */
+	uint64_t num_chars; /**< 분석한 텍스트의 총 길이(UTF16 문자 기준) */
+	double normalize_time; /**< 한글 정규화 단계의 누적 소요 시간(초) */
+	double split_time; /**< 형태 그래프 생성 단계의 누적 소요 시간(초) */
+	double path_time; /**< 최적 경로 탐색 단계의 누적 소요 시간(초) */
+	double insert_time; /**< 결과 생성 단계의 누적 소요 시간(초) */
+	uint64_t num_splits; /**< 생성한 형태 그래프의 개수 */
+	uint64_t num_nodes; /**< 생성한 그래프 노드의 총 개수 */
+	uint64_t num_typo_nodes; /**< 그 중 오타 교정 후보로 생성된 노드의 개수 */
+	uint64_t num_paths_evaluated; /**< 점수를 계산한 경로 후보의 개수 */
+	uint64_t num_paths_pruned; /**< KIWI_CUT_OFF_THRESHOLD에 의해 제거된 경로의 개수 */
+	uint64_t num_lm_calls; /**< 언어 모델 전이 계산 횟수 */
+	uint64_t num_memo_hits; /**< 경로 탐색 없이 기억된 결과를 재사용한 그래프의 개수 */
+	uint64_t lm_cache_hits; /**< LM 전이 캐시에서 찾은 전이의 개수 */
+	uint64_t lm_cache_misses; /**< LM 전이 캐시에 없던 전이의 개수 */
+	uint64_t result_cache_hits; /**< 분석 결과 캐시에서 결과를 찾은 횟수 */
+	uint64_t result_cache_misses; /**< 분석 결과 캐시에 결과가 없던 횟수 */
+} kiwi_stats_t;
+
 /*
 int (*kiwi_reader_t)(int id, char* buffer, void* user_data)
 id: id number of line to be read. if id == 0, kiwi_reader should roll back file and read lines from the beginning
@@ -107,6 +128,11 @@ enum
 	KIWI_NUM_THREADS = 0x8001,
 	KIWI_MAX_UNK_FORM_SIZE = 0x8002,
 	KIWI_SPACE_TOLERANCE = 0x8003,
+	KIWI_PARALLEL_CHUNK_SIZE = 0x8004,
+	KIWI_LM_CACHE_SIZE = 0x8005,
+	KIWI_COLLECT_STATS = 0x8006,
+	KIWI_RESULT_CACHE_SIZE = 0x8007,
+	KIWI_CHUNK_MEMO_SIZE = 0x8008,
 };
 
 enum
@@ -457,7 +483,7 @@ DECL_DLL kiwi_h kiwi_init(const char* model_path, int num_threads, int options);
  * @brief int 타입 옵션의 값을 변경합니다.
  * 
  * @param handle Kiwi.
- * @param option {KIWI_BUILD_INTEGRATE_ALLOMORPH, KIWI_MAX_UNK_FORM_SIZE, KIWI_SPACE_TOLERANCE}.
+ * @param option {KIWI_BUILD_INTEGRATE_ALLOMORPH, KIWI_MAX_UNK_FORM_SIZE, KIWI_SPACE_TOLERANCE, KIWI_PARALLEL_CHUNK_SIZE, KIWI_LM_CACHE_SIZE, KIWI_COLLECT_STATS, KIWI_RESULT_CACHE_SIZE, KIWI_CHUNK_MEMO_SIZE}.
  * @param value 옵션의 설정값
  * 
  * @see kiwi_get_option, kiwi_set_option_f
@@ -468,13 +494,18 @@ DECL_DLL void kiwi_set_option(kiwi_h handle, int option, int value);
  * @brief int 타입 옵션의 값을 반환합니다.
  * 
  * @param handle  Kiwi.
- * @param option {KIWI_BUILD_INTEGRATE_ALLOMORPH, KIWI_NUM_THREADS, KIWI_MAX_UNK_FORM_SIZE, KIWI_SPACE_TOLERANCE}.
+ * @param option {KIWI_BUILD_INTEGRATE_ALLOMORPH, KIWI_NUM_THREADS, KIWI_MAX_UNK_FORM_SIZE, KIWI_SPACE_TOLERANCE, KIWI_PARALLEL_CHUNK_SIZE, KIWI_LM_CACHE_SIZE, KIWI_COLLECT_STATS, KIWI_RESULT_CACHE_SIZE, KIWI_CHUNK_MEMO_SIZE}.
  * @return 해당 옵션의 값을 반환합니다.
  *
  * - KIWI_BUILD_INTEGRATE_ALLOMORPH: 이형태 통합 기능 사용 유무 (0 혹은 1)
  * - KIWI_NUM_THREADS: 사용중인 쓰레드 수 (1 이상의 정수)
  * - KIWI_MAX_UNK_FORM_SIZE: 추출 가능한 사전 미등재 형태의 최대 길이 (0 이상의 정수)
  * - KIWI_SPACE_TOLERANCE: 무시할 수 있는 공백의 최대 개수 (0 이상의 정수)
+ * - KIWI_PARALLEL_CHUNK_SIZE: 이보다 긴 텍스트는 문장 경계에서 나누어 병렬로 분석 (0 이상의 정수, 0이면 나누지 않음)
+ * - KIWI_LM_CACHE_SIZE: 스레드별 LM 전이 캐시의 최대 항목 수 (0 이상의 정수, 0이면 캐시를 사용하지 않음)
+ * - KIWI_COLLECT_STATS: 분석 단계별 통계 집계 여부 (0 혹은 1). 집계된 통계는 kiwi_get_stats로 얻을 수 있음
+ * - KIWI_RESULT_CACHE_SIZE: 같은 입력에 대한 분석 결과를 기억해두는 캐시의 최대 항목 수 (0 이상의 정수, 0이면 캐시를 사용하지 않음)
+ * - KIWI_CHUNK_MEMO_SIZE: 반복되는 문장 조각의 경로 탐색 결과를 스레드별로 기억해둘 최대 조각 수 (0 이상의 정수, 0이면 사용하지 않음)
  */
 DECL_DLL int kiwi_get_option(kiwi_h handle, int option);
 
@@ -503,6 +534,25 @@ DECL_DLL void kiwi_set_option_f(kiwi_h handle, int option, float value);
  */
 DECL_DLL float kiwi_get_option_f(kiwi_h handle, int option);
 
+/**
+ * @brief 생성 혹은 마지막 kiwi_reset_stats 호출 이후 집계된 분석 단계별 통계를 반환합니다.
+ *
+ * @param handle Kiwi.
+ * @param stats 통계가 저장될 구조체의 주소
+ * @return 성공 시 0를 반환합니다. 실패 시 음수를 반환하고 에러 메세지를 설정합니다.
+ *
+ * @note 통계는 KIWI_COLLECT_STATS 옵션이 1인 동안에만 집계됩니다.
+ */
+DECL_DLL int kiwi_get_stats(kiwi_h handle, kiwi_stats_t* stats);
+
+/**
+ * @brief 집계된 분석 단계별 통계를 초기화합니다.
+ *
+ * @param handle Kiwi.
+ * @return 성공 시 0를 반환합니다. 실패 시 음수를 반환하고 에러 메세지를 설정합니다.
+ */
+DECL_DLL int kiwi_reset_stats(kiwi_h handle);
+
 /**
  * @brief 새 형태소집합을 생성합니다. 형태소집합은 kiwi_analyze 함수의 blocklist 등으로 사용될 수 있습니다.
  * 
@@ -541,6 +591,37 @@ DECL_DLL kiwi_res_h kiwi_analyze_w(kiwi_h handle, const kchar16_t* text, int top
  */
 DECL_DLL kiwi_res_h kiwi_analyze(kiwi_h handle, const char* text, int top_n, int match_options, kiwi_morphset_h blocklist, kiwi_pretokenized_h pretokenized);
 
+/**
+ * @brief 텍스트를 분석해 형태소 결과를 열 단위로 반환합니다.
+ *
+ * @param handle Kiwi.
+ * @param text 분석할 텍스트 (utf-16).
+ * @param top_n 반환할 결과물.
+ * @param match_options KIWI_MATCH_ALL 등 KIWI_MATCH_* 열거형 참고.
+ * @param blocklist 분석 후보 탐색 과정에서 blocklist에 포함된 형태소들은 배제됩니다. null 입력 시에는 blocklist를 사용하지 않습니다.
+ * @param pretokenized 입력 텍스트 중 특정 영역의 분석 방법을 강제로 지정합니다. null 입력 시에는 pretokenization을 사용하지 않습니다.
+ * @return 열 단위 분석 결과의 핸들. kiwi_cres_* 함수를 통해 값에 접근가능합니다. 이 핸들은 사용 후 kiwi_cres_close를 사용해 반드시 해제되어야 합니다.
+ *
+ * @note 모든 형태소의 정보가 하나의 배열씩에 연속으로 저장되므로, 형태소마다 함수를 호출하는 kiwi_res_* 계열보다 적은 비용으로 결과를 읽을 수 있습니다.
+ * @see kiwi_analyze_columnar
+ */
+DECL_DLL kiwi_cres_h kiwi_analyze_columnar_w(kiwi_h handle, const kchar16_t* text, int top_n, int match_options, kiwi_morphset_h blocklist, kiwi_pretokenized_h pretokenized);
+
+/**
+ * @brief 텍스트를 분석해 형태소 결과를 열 단위로 반환합니다.
+ *
+ * @param handle Kiwi.
+ * @param text 분석할 텍스트 (utf-8).
+ * @param top_n 반환할 결과물.
+ * @param match_options KIWI_MATCH_ALL 등 KIWI_MATCH_* 열거형 참고.
+ * @param blocklist 분석 후보 탐색 과정에서 blocklist에 포함된 형태소들은 배제됩니다. null 입력 시에는 blocklist를 사용하지 않습니다.
+ * @param pretokenized 입력 텍스트 중 특정 영역의 분석 방법을 강제로 지정합니다. null 입력 시에는 pretokenization을 사용하지 않습니다.
+ * @return 열 단위 분석 결과의 핸들. kiwi_cres_* 함수를 통해 값에 접근가능합니다. 이 핸들은 사용 후 kiwi_cres_close를 사용해 반드시 해제되어야 합니다.
+ *
+ * @see kiwi_analyze_columnar_w
+ */
+DECL_DLL kiwi_cres_h kiwi_analyze_columnar(kiwi_h handle, const char* text, int top_n, int match_options, kiwi_morphset_h blocklist, kiwi_pretokenized_h pretokenized);
+
 /**
  * @brief 
  * 
@@ -595,6 +676,63 @@ DECL_DLL kiwi_ss_h kiwi_split_into_sents_w(kiwi_h handle, const kchar16_t* text,
  */
 DECL_DLL kiwi_ss_h kiwi_split_into_sents(kiwi_h handle, const char* text, int match_options, kiwi_res_h* tokenized_res);
 
+/**
+ * @brief 전체 형태소 분석 없이 텍스트를 문장 단위로 빠르게 분할합니다.
+ *
+ * @param handle Kiwi.
+ * @param text 분할할 텍스트 (utf-16).
+ * @param match_options KIWI_MATCH_ALL 등 KIWI_MATCH_* 열거형 참고. 문장 경계 후보 주변을 분석할 때 사용됩니다.
+ * @return 문장 분할 결과의 핸들. kiwi_ss_* 함수를 통해 값에 접근가능합니다.  이 핸들은 사용 후 kiwi_ss_close를 사용해 반드시 해제되어야 합니다.
+ * 
+ * @note 문장 경계 후보가 되는 어절과 그 주변만 분석하므로 kiwi_split_into_sents_w보다 빠르지만, 결과가 일부 다를 수 있습니다.
+ * @see kiwi_split_into_sents_fast
+ */
+DECL_DLL kiwi_ss_h kiwi_split_into_sents_fast_w(kiwi_h handle, const kchar16_t* text, int match_options);
+
+/**
+ * @brief 전체 형태소 분석 없이 텍스트를 문장 단위로 빠르게 분할합니다.
+ *
+ * @param handle Kiwi.
+ * @param text 분할할 텍스트 (utf-8).
+ * @param match_options KIWI_MATCH_ALL 등 KIWI_MATCH_* 열거형 참고. 문장 경계 후보 주변을 분석할 때 사용됩니다.
+ * @return 문장 분할 결과의 핸들. kiwi_ss_* 함수를 통해 값에 접근가능합니다.  이 핸들은 사용 후 kiwi_ss_close를 통해 반드시 해제되어야 합니다.
+ * 
+ * @see kiwi_split_into_sents_fast_w
+ */
+DECL_DLL kiwi_ss_h kiwi_split_into_sents_fast(kiwi_h handle, const char* text, int match_options);
+
+/**
+ * @brief 이미 생성된 Kiwi에 사용자 단어를 추가합니다.
+ *
+ * @param handle Kiwi.
+ * @param word 추가할 형태 (utf-8). 공백을 포함할 수 없습니다.
+ * @param pos 품사 태그. 용언(VV, VA 등)은 사용할 수 없습니다.
+ * @param score 점수
+ * @return 새로 추가된 경우 0, 이미 같은 단어가 있어 점수만 갱신된 경우 1을 반환합니다. 실패시 음수를 반환합니다.
+ * 
+ * @note 추가된 단어는 Kiwi를 다시 생성하지 않고도 바로 다음 분석부터 반영됩니다. 이미 진행 중인 분석에는 영향을 주지 않습니다.
+ * @see kiwi_clear_user_words
+ */
+DECL_DLL int kiwi_add_user_word(kiwi_h handle, const char* word, const char* pos, float score);
+
+/**
+ * @brief kiwi_add_user_word로 추가한 사용자 단어를 모두 제거합니다.
+ *
+ * @param handle Kiwi.
+ * @return 성공시 0을 반환합니다. 실패시 0이 아닌 값을 반환합니다.
+ */
+DECL_DLL int kiwi_clear_user_words(kiwi_h handle);
+
+/**
+ * @brief 사전과 모델 데이터를 복사하지 않고 공유하는 새 Kiwi를 생성합니다.
+ *
+ * @param handle Kiwi.
+ * @return 새 Kiwi의 핸들. 설정과 사용자 단어는 복사되며, 이후 각자의 변경은 서로에게 영향을 주지 않습니다. 실패 시 null을 반환합니다.
+ * 
+ * @note 반환된 kiwi_h는 kiwi_close로 해제되어야 합니다. 원본을 먼저 해제해도 안전합니다.
+ */
+DECL_DLL kiwi_h kiwi_clone(kiwi_h handle);
+
 /**
  * @brief 형태소를 결합하여 텍스트로 만들어주는 Joiner를 새로 생성합니다.
  *
@@ -760,6 +898,95 @@ DECL_DLL float kiwi_res_typo_cost(kiwi_res_h result, int index, int num);
  */
 DECL_DLL int kiwi_res_close(kiwi_res_h result);
 
+/**
+ * @brief 열 단위 분석 결과 내에 포함된 분석 결과의 개수를 반환합니다.
+ *
+ * @param result 열 단위 분석 결과의 핸들
+ * @return 성공시 0이상의 값, 실패 시 음수를 반환합니다.
+ */
+DECL_DLL int kiwi_cres_size(kiwi_cres_h result);
+
+/**
+ * @brief index번째 분석 결과의 확률 점수를 반환합니다.
+ *
+ * @param result 열 단위 분석 결과의 핸들
+ * @param index `0` 이상 `kiwi_cres_size(result)` 미만의 정수
+ * @return 성공 시 0이 아닌 값, 실패 시 0을 반환합니다.
+ */
+DECL_DLL float kiwi_cres_prob(kiwi_cres_h result, int index);
+
+/**
+ * @brief 모든 분석 결과에 포함된 형태소의 총 개수를 반환합니다.
+ *
+ * @param result 열 단위 분석 결과의 핸들
+ * @return 성공시 0이상의 값, 실패 시 음수를 반환합니다.
+ */
+DECL_DLL int kiwi_cres_token_num(kiwi_cres_h result);
+
+/**
+ * @brief 분석 결과별 형태소 구간을 담은 배열을 반환합니다.
+ *
+ * @param result 열 단위 분석 결과의 핸들
+ * @return 길이가 `kiwi_cres_size(result) + 1`인 배열. index번째 분석 결과의 형태소는 [offsets[index], offsets[index + 1]) 범위에 있습니다. 실패 시 null을 반환합니다.
+ */
+DECL_DLL const uint32_t* kiwi_cres_result_offsets(kiwi_cres_h result);
+
+/**
+ * @brief 모든 형태소의 형태가 이어 붙여진 버퍼를 반환합니다.
+ *
+ * @param result 열 단위 분석 결과의 핸들
+ * @return UTF-16으로 인코딩된 문자열. 각 형태소의 형태는 `kiwi_cres_form_offsets`로 구분합니다. 실패 시 null을 반환합니다.
+ */
+DECL_DLL const kchar16_t* kiwi_cres_forms_w(kiwi_cres_h result);
+
+/**
+ * @brief 형태 버퍼 내에서 각 형태소의 형태 구간을 담은 배열을 반환합니다.
+ *
+ * @param result 열 단위 분석 결과의 핸들
+ * @return 길이가 `kiwi_cres_token_num(result) + 1`인 배열. t번째 형태소의 형태는 [offsets[t], offsets[t + 1]) 범위에 있습니다. 실패 시 null을 반환합니다.
+ */
+DECL_DLL const uint32_t* kiwi_cres_form_offsets(kiwi_cres_h result);
+
+/**
+ * @brief 각 형태소의 시작 위치(UTF-16 문자열 기준)를 담은 배열을 반환합니다. 배열의 길이는 `kiwi_cres_token_num(result)`입니다.
+ */
+DECL_DLL const uint32_t* kiwi_cres_positions(kiwi_cres_h result);
+
+/**
+ * @brief 각 형태소의 길이(UTF-16 문자열 기준)를 담은 배열을 반환합니다. 배열의 길이는 `kiwi_cres_token_num(result)`입니다.
+ */
+DECL_DLL const uint16_t* kiwi_cres_lengths(kiwi_cres_h result);
+
+/**
+ * @brief 각 형태소의 품사 태그를 담은 배열을 반환합니다. 배열의 길이는 `kiwi_cres_token_num(result)`입니다.
+ */
+DECL_DLL const uint8_t* kiwi_cres_tags(kiwi_cres_h result);
+
+/**
+ * @brief 각 형태소의 문장 내 어절 번호를 담은 배열을 반환합니다. 배열의 길이는 `kiwi_cres_token_num(result)`입니다.
+ */
+DECL_DLL const uint32_t* kiwi_cres_word_positions(kiwi_cres_h result);
+
+/**
+ * @brief 각 형태소의 문장 번호를 담은 배열을 반환합니다. 배열의 길이는 `kiwi_cres_token_num(result)`입니다.
+ */
+DECL_DLL const uint32_t* kiwi_cres_sent_positions(kiwi_cres_h result);
+
+/**
+ * @brief 각 형태소의 언어 모델 점수를 담은 배열을 반환합니다. 배열의 길이는 `kiwi_cres_token_num(result)`입니다.
+ */
+DECL_DLL const float* kiwi_cres_scores(kiwi_cres_h result);
+
+/**
+ * @brief 사용이 완료된 열 단위 분석 결과를 해제합니다.
+ *
+ * @param result 열 단위 분석 결과 핸들
+ * @return 성공시 0을 반환합니다. 실패시 0이 아닌 값을 반환합니다.
+ *
+ * @note kiwi_analyze_columnar 계열의 함수들에서 반환된 kiwi_cres_h 값들은 반드시 이 함수를 통해 해제되어야 합니다.
+ */
+DECL_DLL int kiwi_cres_close(kiwi_cres_h result);
+
 
 /**
  * @brief 
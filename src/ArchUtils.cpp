@@ -4,6 +4,7 @@
 #include <algorithm>
 
 #include "ArchAvailable.h"
+#include "search.h"
 
 using namespace kiwi;
 
@@ -79,6 +80,8 @@ namespace kiwi
 		std::string envs = env;
 		std::transform(envs.begin(), envs.end(), envs.begin(), asciitolower);
 
+		if (envs == "auto") return getTunedArch();
+
 		for (size_t i = 0; i <= static_cast<size_t>(ArchType::last); ++i)
 		{
 			if (envs == archNames[i]) return static_cast<ArchType>(i);
@@ -89,6 +92,12 @@ namespace kiwi
 	}
 }
 
+ArchType kiwi::getTunedArch()
+{
+	static ArchType tuned = nst::tuneSearch(getBestArch()).best;
+	return tuned;
+}
+
 ArchType kiwi::getSelectedArch(ArchType arch)
 {
 	static ArchType best = getBestArch();
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <kiwi/Types.h>
+
+namespace kiwi
+{
+	namespace utils
+	{
+		/**
+		 * @brief 한 번의 분석 동안만 살아있는 임시 객체들을 위한 bump-pointer 메모리 풀.
+		 * @details 큰 블록을 미리 할당해두고 요청이 올 때마다 포인터만 앞으로 옮겨서 메모리를 내어준다.
+		 * 개별 해제는 가장 마지막에 할당된 영역에 대해서만 실제로 반영되며,
+		 * 나머지는 `Scope`가 끝날 때 한꺼번에 회수된다. 블록은 해제하지 않고 다음 분석에서 재사용한다.
+		 */
+		class Arena
+		{
+			static constexpr size_t defaultBlockSize = 256 * 1024;
+
+			struct Block
+			{
+				std::unique_ptr<uint8_t[]> data;
+				size_t size = 0;
+			};
+
+			Vector<Block> blocks;
+			Vector<std::unique_ptr<uint8_t[]>> largeBlocks;
+			size_t curBlock = 0, curOffset = 0;
+			size_t numHeapAllocs = 0;
+
+		public:
+			struct Mark
+			{
+				size_t block = 0, offset = 0, numLarge = 0;
+			};
+
+			/**
+			 * @brief 생성 시점의 위치를 기억해두었다가 소멸할 때 그 위치까지 Arena를 되돌린다.
+			 */
+			class Scope
+			{
+				Arena& arena;
+				Mark mark;
+			public:
+				Scope(Arena& _arena) : arena{ _arena }, mark{ _arena.mark() }
+				{
+				}
+
+				Scope(const Scope&) = delete;
+				Scope& operator=(const Scope&) = delete;
+
+				~Scope()
+				{
+					arena.rewind(mark);
+				}
+			};
+
+			static Arena& local()
+			{
+				thread_local Arena arena;
+				return arena;
+			}
+
+			void* allocate(size_t size, size_t align)
+			{
+				// 블록의 상당 부분을 차지하는 요청은 별도로 할당하여 블록들의 크기를 균일하게 유지한다
+				if (size + align > defaultBlockSize / 4)
+				{
+					largeBlocks.emplace_back(new uint8_t[size + align]);
+					++numHeapAllocs;
+					const uintptr_t base = (uintptr_t)largeBlocks.back().get();
+					return (void*)((base + align - 1) & ~(uintptr_t)(align - 1));
+				}
+
+				while (curBlock < blocks.size())
+				{
+					auto& b = blocks[curBlock];
+					const uintptr_t base = (uintptr_t)b.data.get();
+					const size_t aligned = (size_t)(((base + curOffset + align - 1) & ~(uintptr_t)(align - 1)) - base);
+					if (aligned + size <= b.size)
+					{
+						curOffset = aligned + size;
+						return b.data.get() + aligned;
+					}
+					++curBlock;
+					curOffset = 0;
+				}
+
+				Block b;
+				b.size = defaultBlockSize;
+				b.data.reset(new uint8_t[b.size]);
+				++numHeapAllocs;
+				blocks.emplace_back(std::move(b));
+				curBlock = blocks.size() - 1;
+				curOffset = 0;
+				return allocate(size, align);
+			}
+
+			void deallocate(void* p, size_t size, size_t align)
+			{
+				// 마지막으로 할당된 영역만 되돌릴 수 있다
+				if (size + align > defaultBlockSize / 4)
+				{
+					if (!largeBlocks.empty() && (uintptr_t)p - (uintptr_t)largeBlocks.back().get() < align)
+					{
+						largeBlocks.pop_back();
+					}
+				}
+				else if (curBlock < blocks.size() && (uint8_t*)p + size == blocks[curBlock].data.get() + curOffset)
+				{
+					curOffset -= size;
+				}
+			}
+
+			Mark mark() const
+			{
+				return Mark{ curBlock, curOffset, largeBlocks.size() };
+			}
+
+			void rewind(const Mark& m)
+			{
+				curBlock = m.block;
+				curOffset = m.offset;
+				if (largeBlocks.size() > m.numLarge) largeBlocks.resize(m.numLarge);
+			}
+
+			/**
+			 * @brief 지금까지 Arena가 힙으로부터 블록을 할당받은 횟수
+			 */
+			size_t heapAllocations() const
+			{
+				return numHeapAllocs;
+			}
+		};
+
+		/**
+		 * @brief `Arena`로부터 메모리를 할당받는 STL allocator
+		 */
+		template<class Ty>
+		class ArenaAllocator
+		{
+			template<class> friend class ArenaAllocator;
+			Arena* arena;
+
+		public:
+			using value_type = Ty;
+
+			ArenaAllocator(Arena& _arena = Arena::local()) : arena{ &_arena }
+			{
+			}
+
+			template<class Other>
+			ArenaAllocator(const ArenaAllocator<Other>& o) : arena{ o.arena }
+			{
+			}
+
+			Ty* allocate(size_t n)
+			{
+				return (Ty*)arena->allocate(n * sizeof(Ty), alignof(Ty));
+			}
+
+			void deallocate(Ty* p, size_t n)
+			{
+				arena->deallocate(p, n * sizeof(Ty), alignof(Ty));
+			}
+
+			template<class Other>
+			bool operator==(const ArenaAllocator<Other>& o) const
+			{
+				return arena == o.arena;
+			}
+
+			template<class Other>
+			bool operator!=(const ArenaAllocator<Other>& o) const
+			{
+				return arena != o.arena;
+			}
+		};
+
+		template<class Ty>
+		using ArenaVector = std::vector<Ty, ArenaAllocator<Ty>>;
+	}
+}
@@ -9,6 +9,7 @@
 #include "FeatureTestor.h"
 #include "StrUtils.h"
 #include "RaggedVector.hpp"
+#include "serializer.hpp"
 
 using namespace std;
 using namespace kiwi;
@@ -1320,3 +1321,132 @@ void CompiledRule::addAllomorph(const vector<tuple<U16StringView, CondVowel, uin
 {
 	return addAllomorphImpl(forms, tag);
 }
+
+DEFINE_SERIALIZER_OUTSIDE(ReplString, str, leftEnd, rightBegin, score);
+DEFINE_SERIALIZER_OUTSIDE(Replacement, repl, leftVowel, leftPolarity, ignoreRCond);
+DEFINE_SERIALIZER_OUTSIDE(CompiledRule::Allomorph, form, cvowel, priority);
+
+namespace kiwi
+{
+	inline void writeBitset(ostream& ostr, const utils::Bitset& b)
+	{
+		Vector<uint32_t> setBits;
+		if (b.size()) b.visit([&](size_t i) { setBits.emplace_back(i); });
+		serializer::writeMany(ostr, (uint64_t)b.size(), setBits);
+	}
+
+	inline utils::Bitset readBitset(istream& istr)
+	{
+		uint64_t size;
+		Vector<uint32_t> setBits;
+		serializer::readMany(istr, size, setBits);
+		utils::Bitset ret{ size };
+		for (auto i : setBits) ret.set(i);
+		return ret;
+	}
+
+	struct DFAWriter
+	{
+		ostream& ostr;
+
+		DFAWriter(ostream& _ostr) : ostr{ _ostr }
+		{
+		}
+
+		template<class NodeSizeTy, class GroupSizeTy>
+		void operator()(const MultiRuleDFA<NodeSizeTy, GroupSizeTy>& e) const
+		{
+			serializer::writeMany(ostr, (uint8_t)sizeof(NodeSizeTy), (uint8_t)sizeof(GroupSizeTy));
+			e.serializerWrite(ostr);
+		}
+	};
+
+	template<class NodeSizeTy, class GroupSizeTy>
+	MultiRuleDFAErased readDFA(istream& istr)
+	{
+		MultiRuleDFA<NodeSizeTy, GroupSizeTy> ret;
+		ret.serializerRead(istr);
+		return ret;
+	}
+
+	template<class NodeSizeTy>
+	MultiRuleDFAErased readDFA(istream& istr, uint8_t groupSize)
+	{
+		switch (groupSize)
+		{
+		case 1:
+			return readDFA<NodeSizeTy, uint8_t>(istr);
+		case 2:
+			return readDFA<NodeSizeTy, uint16_t>(istr);
+		case 4:
+			return readDFA<NodeSizeTy, uint32_t>(istr);
+		case 8:
+			return readDFA<NodeSizeTy, uint64_t>(istr);
+		}
+		throw serializer::SerializationException{ "Wrong group size of MultiRuleDFA : " + to_string(groupSize) };
+	}
+
+	inline MultiRuleDFAErased readDFA(istream& istr)
+	{
+		uint8_t nodeSize, groupSize;
+		serializer::readMany(istr, nodeSize, groupSize);
+		switch (nodeSize)
+		{
+		case 1:
+			return readDFA<uint8_t>(istr, groupSize);
+		case 2:
+			return readDFA<uint16_t>(istr, groupSize);
+		case 4:
+			return readDFA<uint32_t>(istr, groupSize);
+		case 8:
+			return readDFA<uint64_t>(istr, groupSize);
+		}
+		throw serializer::SerializationException{ "Wrong node size of MultiRuleDFA : " + to_string(nodeSize) };
+	}
+}
+
+template<class NodeSizeTy, class GroupSizeTy>
+void MultiRuleDFA<NodeSizeTy, GroupSizeTy>::serializerRead(istream& istr)
+{
+	serializer::readMany(istr, vocabs, transition, finishGroup, sepGroupFlatten, sepGroupPtrs, finish);
+	groupInfo.resize(serializer::readFromStream<uint32_t>(istr));
+	for (auto& g : groupInfo) g = readBitset(istr);
+}
+
+template<class NodeSizeTy, class GroupSizeTy>
+void MultiRuleDFA<NodeSizeTy, GroupSizeTy>::serializerWrite(ostream& ostr) const
+{
+	serializer::writeMany(ostr, vocabs, transition, finishGroup, sepGroupFlatten, sepGroupPtrs, finish);
+	serializer::writeToStream(ostr, (uint32_t)groupInfo.size());
+	for (auto& g : groupInfo) writeBitset(ostr, g);
+}
+
+void CompiledRule::serializerRead(istream& istr)
+{
+	serializer::readMany(istr, serializer::toKey("CRUL"));
+	for (auto* d : { &dfa, &dfaRight })
+	{
+		d->clear();
+		const size_t size = serializer::readFromStream<uint32_t>(istr);
+		d->reserve(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			d->emplace_back(readDFA(istr));
+		}
+	}
+	serializer::readMany(istr, map, allomorphData, allomorphPtrMap);
+}
+
+void CompiledRule::serializerWrite(ostream& ostr) const
+{
+	serializer::writeMany(ostr, serializer::toKey("CRUL"));
+	for (auto* d : { &dfa, &dfaRight })
+	{
+		serializer::writeToStream(ostr, (uint32_t)d->size());
+		for (auto& e : *d)
+		{
+			mapbox::util::apply_visitor(DFAWriter{ ostr }, e);
+		}
+	}
+	serializer::writeMany(ostr, map, allomorphData, allomorphPtrMap);
+}
@@ -26,6 +26,9 @@ namespace kiwi
 				: str{ _str }, leftEnd{ std::min(_leftEnd, str.size()) }, rightBegin{ _rightBegin }, score{ _score }
 			{
 			}
+
+			void serializerRead(std::istream& istr);
+			void serializerWrite(std::ostream& ostr) const;
 		};
 
 		struct Replacement
@@ -41,6 +44,9 @@ namespace kiwi
 				bool _ignoreRCond = false
 			) : repl{ _repl }, leftVowel{ _leftVowel }, leftPolarity{ _leftPolar }, ignoreRCond{ _ignoreRCond }
 			{}
+
+			void serializerRead(std::istream& istr);
+			void serializerWrite(std::ostream& ostr) const;
 		};
 
 		struct Result
@@ -87,6 +93,9 @@ namespace kiwi
 		public:
 			Vector<Result> combine(U16StringView left, U16StringView right) const;
 			Vector<std::tuple<size_t, size_t, CondPolarity>> searchLeftPat(U16StringView left, bool matchRuleSep = true) const;
+
+			void serializerRead(std::istream& istr);
+			void serializerWrite(std::ostream& ostr) const;
 		};
 
 		namespace detail
@@ -198,6 +207,9 @@ namespace kiwi
 					: form{ _form }, cvowel{ _cvowel }, priority{ _priority }
 				{
 				}
+
+				void serializerRead(std::istream& istr);
+				void serializerWrite(std::ostream& ostr) const;
 			};
 
 			Vector<MultiRuleDFAErased> dfa, dfaRight;
@@ -278,6 +290,14 @@ namespace kiwi
 
 			void addAllomorph(const std::vector<std::tuple<U16StringView, CondVowel, uint8_t>>& forms, POSTag tag);
 
+			/**
+			 * @brief 컴파일된 결합 규칙 전체(DFA, 규칙 맵, 이형태 목록)를 스트림에 쓰거나 읽는다.
+			 * 
+			 * @note 저장된 규칙은 `RuleSet::compile()` 없이 그대로 복원되므로 `Kiwi::loadBaked()`에서 사용한다.
+			 */
+			void serializerRead(std::istream& istr);
+			void serializerWrite(std::ostream& ostr) const;
+
 			/**
 			 * @return vector of tuple(replaceGroupId, capturedStartPos, replaceGroupCondition)
 			 */
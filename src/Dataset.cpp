@@ -7,7 +7,7 @@ using namespace kiwi;
 
 HSDataset::HSDataset(size_t _batchSize, size_t _causalContextSize, size_t _windowSize, size_t _workers, 
 	double _dropoutProb, double _dropoutProbOnHistory)
-	: workers{ _workers ? make_unique<utils::ThreadPool>(_workers) : nullptr },
+	: workers{ _workers ? utils::acquireThreadPool(_workers) : nullptr },
 	dropout{ {1 - _dropoutProb * 3, _dropoutProb, _dropoutProb, _dropoutProb} }, 
 	dropoutOnHistory{ _dropoutProbOnHistory },
 	locals( _workers ? workers->size() : 1),
@@ -19,6 +19,17 @@ HSDataset::HSDataset(size_t _batchSize, size_t _causalContextSize, size_t _windo
 
 HSDataset::~HSDataset()
 {
+	// 작업자 풀은 다른 객체와 공유될 수 있으므로 진행 중인 작업이 이 객체의 버퍼를 건드리지 않도록 끝날 때까지 기다린다
+	for (auto& f : futures)
+	{
+		try
+		{
+			f.get();
+		}
+		catch (...)
+		{
+		}
+	}
 }
 
 HSDataset::HSDataset(HSDataset&& o) /*noexcept*/ = default;
@@ -112,3 +112,17 @@ bool FeatureTestor::isMatchedApprox(const kchar_t* begin, const kchar_t* end, Co
 {
 	return isMatched(begin, end, vowel) && isMatchedApprox(begin, end, polar);
 }
+
+uint16_t FeatureTestor::condMask(const kchar_t* begin, const kchar_t* end)
+{
+	uint16_t ret = 0;
+	for (size_t v = 0; v <= static_cast<size_t>(CondVowel::applosive); ++v)
+	{
+		if (isMatched(begin, end, static_cast<CondVowel>(v))) ret |= 1 << v;
+	}
+	for (size_t p = 0; p <= static_cast<size_t>(CondPolarity::non_adj); ++p)
+	{
+		if (isMatched(begin, end, static_cast<CondPolarity>(p))) ret |= 1 << (condPolarityShift + p);
+	}
+	return ret;
+}
@@ -17,6 +17,20 @@ namespace kiwi
 		static bool isMatched(const KString* form, CondVowel vowel, CondPolarity polar);
 
 		static bool isMatchedApprox(const kchar_t* begin, const kchar_t* end, CondVowel vowel, CondPolarity polar);
+
+		/**
+		 * @brief 주어진 형태가 각 CondVowel, CondPolarity 조건을 만족하는지를 비트로 묶어 반환한다.
+		 * @details 하위 9비트는 CondVowel의 각 값, 그 위의 4비트는 CondPolarity의 각 값에 대응한다.
+		 * 반환값은 `isMatched(uint16_t, CondVowel, CondPolarity)`에 넘겨 조건을 분기 없이 검사하는 데 쓴다.
+		 */
+		static uint16_t condMask(const kchar_t* begin, const kchar_t* end);
+
+		static bool isMatched(uint16_t condMask, CondVowel vowel, CondPolarity polar)
+		{
+			return !!((condMask >> static_cast<size_t>(vowel)) & (condMask >> (condPolarityShift + static_cast<size_t>(polar))) & 1);
+		}
+
+		static constexpr size_t condPolarityShift = 9;
 	};
 
 	inline bool hasNoOnset(const KString& form)
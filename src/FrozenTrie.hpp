@@ -2,8 +2,10 @@
 
 #include <kiwi/FrozenTrie.h>
 #include <kiwi/Utils.h>
+#include <kiwi/ThreadPool.h>
 #include "search.h"
 #include "ArchAvailable.h"
+#include "serializer.hpp"
 
 namespace kiwi
 {
@@ -14,6 +16,10 @@ namespace kiwi
 		auto FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::Node::nextOpt(const FrozenTrie& ft, Key c) const -> const Node*
 		{
 			_Diff v;
+			if (ft.direct.find(this - ft.nodes.get(), numNexts, c, v))
+			{
+				return v ? this + v : nullptr;
+			}
 			if (!nst::search<arch>(&ft.nextKeys[nextOffset], &ft.nextDiffs[nextOffset], numNexts, c, v))
 			{
 				return nullptr;
@@ -34,21 +40,12 @@ namespace kiwi
 		{
 			if (!lower) return this;
 			auto* lowerNode = this + lower;
-			_Diff v;
-
-			if (!nst::search<arch>(
-				&ft.nextKeys[lowerNode->nextOffset],
-				&ft.nextDiffs[lowerNode->nextOffset],
-				lowerNode->numNexts, c, v
-			))
-			{
-				// `c` node doesn't exist
-				return lowerNode->template findFail<arch>(ft, c);
-			}
-			else
+			if (auto* next = lowerNode->template nextOpt<arch>(ft, c))
 			{
-				return lowerNode + v;
+				return next;
 			}
+			// `c` node doesn't exist
+			return lowerNode->template findFail<arch>(ft, c);
 		}
 
 		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
@@ -70,6 +67,7 @@ namespace kiwi
 			std::copy(o.values.get(), o.values.get() + numNodes, values.get());
 			std::copy(o.nextKeys.get(), o.nextKeys.get() + numNexts, nextKeys.get());
 			std::copy(o.nextDiffs.get(), o.nextDiffs.get() + numNexts, nextDiffs.get());
+			direct = o.direct;
 		}
 
 		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
@@ -87,12 +85,50 @@ namespace kiwi
 			std::copy(o.values.get(), o.values.get() + numNodes, values.get());
 			std::copy(o.nextKeys.get(), o.nextKeys.get() + numNexts, nextKeys.get());
 			std::copy(o.nextDiffs.get(), o.nextDiffs.get() + numNexts, nextDiffs.get());
+			direct = o.direct;
 			return *this;
 		}
 
+		namespace detail
+		{
+			/**
+			 * @brief 루트에서부터 깊이 순서대로 모든 노드 p에 대해 visit(p, children)을 호출한다. visit은 p의 자식들을 children에 추가해야 한다.
+			 * @details 실패 링크는 언제나 더 얕은 노드를 가리키므로, 한 깊이의 노드들을 모두 방문한 뒤에 다음 깊이로 넘어가기만 하면
+			 * 같은 깊이의 노드들은 순서와 관계없이 여러 스레드에서 동시에 방문해도 너비 우선 탐색과 같은 결과를 얻는다.
+			 */
+			template<class Node, class Fn>
+			void visitByDepth(Node* root, ThreadPool* pool, Fn&& visit)
+			{
+				static constexpr size_t minParallelWidth = 4096;
+				Vector<Node*> frontier{ root }, next;
+				std::vector<Vector<Node*>> found(pool ? pool->size() : 0);
+				while (!frontier.empty())
+				{
+					next.clear();
+					if (pool && pool->size() > 1 && frontier.size() >= minParallelWidth)
+					{
+						parallelFor(pool, 0, frontier.size(), [&](size_t tid, size_t i)
+						{
+							visit(frontier[i], found[tid]);
+						}, 256);
+						for (auto& f : found)
+						{
+							next.insert(next.end(), f.begin(), f.end());
+							f.clear();
+						}
+					}
+					else
+					{
+						for (auto* p : frontier) visit(p, next);
+					}
+					frontier.swap(next);
+				}
+			}
+		}
+
 		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
 		template<class TrieNode, ArchType archType, class Xform>
-		FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::FrozenTrie(const ContinuousTrie<TrieNode>& trie, ArchTypeHolder<archType>, Xform xform)
+		FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::FrozenTrie(const ContinuousTrie<TrieNode>& trie, ArchTypeHolder<archType>, Xform xform, ThreadPool* pool)
 		{
 			numNodes = trie.size();
 			nodes = make_unique<Node[]>(numNodes);
@@ -100,36 +136,34 @@ namespace kiwi
 
 			for (size_t i = 0; i < trie.size(); ++i)
 			{
+				nodes[i].numNexts = (Key)trie[i].next.size();
+				nodes[i].nextOffset = numNexts;
 				numNexts += trie[i].next.size();
 			}
 
 			nextKeys = make_unique<Key[]>(numNexts);
 			nextDiffs = make_unique<Diff[]>(numNexts);
 
-			size_t ptr = 0;
-			Vector<uint8_t> tempBuf;
-			for (size_t i = 0; i < trie.size(); ++i)
+			// 노드마다 쓰는 위치가 미리 정해져 있으므로 여러 스레드가 나누어 채울 수 있다
+			std::vector<Vector<uint8_t>> tempBufs(pool ? std::max(pool->size(), (size_t)1) : 1);
+			parallelFor(trie.size() >= 65536 ? pool : nullptr, 0, trie.size(), [&](size_t tid, size_t i)
 			{
 				auto& o = trie[i];
-				nodes[i].numNexts = (Key)o.next.size();
 				values[i] = xform(o);
-				nodes[i].nextOffset = ptr;
 
+				const size_t offset = nodes[i].nextOffset;
 				std::vector<std::pair<Key, Diff>> pairs{ o.next.begin(), o.next.end() };
 				std::sort(pairs.begin(), pairs.end());
-				for (auto& p : pairs)
+				for (size_t j = 0; j < pairs.size(); ++j)
 				{
-					nextKeys[ptr] = p.first;
-					nextDiffs[ptr] = p.second;
-					++ptr;
+					nextKeys[offset + j] = pairs[j].first;
+					nextDiffs[offset + j] = pairs[j].second;
 				}
-				nst::prepare<archType>(&nextKeys[nodes[i].nextOffset], &nextDiffs[nodes[i].nextOffset], pairs.size(), tempBuf);
-			}
+				nst::prepare<archType>(&nextKeys[offset], &nextDiffs[offset], pairs.size(), tempBufs[tid]);
+			}, 1024);
 
-			Deque<Node*> dq;
-			for (dq.emplace_back(&nodes[0]); !dq.empty(); dq.pop_front())
+			detail::visitByDepth(&nodes[0], pool, [&](Node* p, Vector<Node*>& children)
 			{
-				auto p = dq.front();
 				for (size_t i = 0; i < p->numNexts; ++i)
 				{
 					auto k = nextKeys[p->nextOffset + i];
@@ -137,7 +171,7 @@ namespace kiwi
 					if (v <= 0) continue;
 					auto* child = &p[v];
 					child->lower = p->template findFail<archType>(*this, k) - child;
-					dq.emplace_back(child);
+					children.emplace_back(child);
 				}
 
 				if (this->isNull(p->val(*this)))
@@ -149,6 +183,333 @@ namespace kiwi
 						break;
 					}
 				}
+			});
+			buildDirectTransitions();
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		template<class Fn>
+		void FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::writeRaw(std::ostream& ostr, Fn&& valueToIdx) const
+		{
+			serializer::writeMany(ostr, (uint64_t)numNodes, (uint64_t)numNexts);
+			Vector<uint32_t> idx(numNodes);
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				idx[i] = valueToIdx(values[i]);
+			}
+			serializer::writeToStream(ostr, idx);
+			if (!ostr.write((const char*)nodes.get(), sizeof(Node) * numNodes)
+				|| !ostr.write((const char*)nextKeys.get(), sizeof(Key) * numNexts)
+				|| !ostr.write((const char*)nextDiffs.get(), sizeof(Diff) * numNexts))
+			{
+				throw serializer::SerializationException{ "writing FrozenTrie failed" };
+			}
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		template<class Fn>
+		void FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::readRaw(std::istream& istr, Fn&& idxToValue)
+		{
+			uint64_t nNodes, nNexts;
+			Vector<uint32_t> idx;
+			serializer::readMany(istr, nNodes, nNexts, idx);
+			if (idx.size() != nNodes) throw serializer::SerializationException{ "reading FrozenTrie failed" };
+			numNodes = nNodes;
+			numNexts = nNexts;
+			nodes = make_unique<Node[]>(numNodes);
+			values = make_unique<Value[]>(numNodes);
+			nextKeys = make_unique<Key[]>(numNexts);
+			nextDiffs = make_unique<Diff[]>(numNexts);
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				values[i] = idxToValue(idx[i]);
+			}
+			if (!istr.read((char*)nodes.get(), sizeof(Node) * numNodes)
+				|| !istr.read((char*)nextKeys.get(), sizeof(Key) * numNexts)
+				|| !istr.read((char*)nextDiffs.get(), sizeof(Diff) * numNexts))
+			{
+				throw serializer::SerializationException{ "reading FrozenTrie failed" };
+			}
+			buildDirectTransitions();
+		}
+
+		namespace detail
+		{
+			template<ArchType archType, class Key, class Diff>
+			void rearrangeKeys(Key* keys, Diff* diffs, size_t size, Vector<uint8_t>& tempBuf)
+			{
+				std::vector<std::pair<Key, Diff>> pairs;
+				pairs.reserve(size);
+				for (size_t i = 0; i < size; ++i)
+				{
+					pairs.emplace_back(keys[i], diffs[i]);
+				}
+				std::sort(pairs.begin(), pairs.end());
+				for (size_t i = 0; i < size; ++i)
+				{
+					keys[i] = pairs[i].first;
+					diffs[i] = pairs[i].second;
+				}
+				nst::prepare<archType>(keys, diffs, size, tempBuf);
+			}
+
+			template<class Fn, class Key, class Diff>
+			struct RearrangeKeysGetter
+			{
+				template<std::ptrdiff_t i>
+				struct Wrapper
+				{
+					static constexpr Fn value = &rearrangeKeys<static_cast<ArchType>(i), Key, Diff>;
+				};
+			};
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		void FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::rearrangeKeys(ArchType archType)
+		{
+			using FnRearrangeKeys = decltype(&detail::rearrangeKeys<ArchType::none, _Key, _Diff>);
+			static tp::Table<FnRearrangeKeys, AvailableArch> table{ detail::RearrangeKeysGetter<FnRearrangeKeys, _Key, _Diff>{} };
+			auto* fn = table[static_cast<std::ptrdiff_t>(archType)];
+			if (!fn) throw std::runtime_error{ std::string{"Unsupported architecture : "} + archToStr(archType) };
+
+			Vector<uint8_t> tempBuf;
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				(*fn)(&nextKeys[nodes[i].nextOffset], &nextDiffs[nodes[i].nextOffset], nodes[i].numNexts, tempBuf);
+			}
+		}
+
+		template<class _Key, class _Value, class _Diff, class _HasSubmatch>
+		void FrozenTrie<_Key, _Value, _Diff, _HasSubmatch>::buildDirectTransitions(size_t memoryBudget, size_t minFanout)
+		{
+			direct.clear();
+			if (!memoryBudget) return;
+
+			// 자식이 많은 노드일수록 먼저 테이블을 배정한다
+			Vector<size_t> cands;
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				if (nodes[i].numNexts >= minFanout) cands.emplace_back(i);
+			}
+			std::stable_sort(cands.begin(), cands.end(), [&](size_t a, size_t b)
+			{
+				return nodes[a].numNexts > nodes[b].numNexts;
+			});
+			for (auto i : cands)
+			{
+				direct.add(i, &nextKeys[nodes[i].nextOffset], &nextDiffs[nodes[i].nextOffset], nodes[i].numNexts, minFanout, memoryBudget);
+			}
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<ArchType arch>
+		auto CompactFrozenTrie<_Key, _Value, _HasSubmatch>::Node::nextOpt(const CompactFrozenTrie& ft, Key c) const -> const Node*
+		{
+			int32_t v;
+			if (ft.direct.find(this - ft.nodes.data(), numNexts(), c, v))
+			{
+				return v ? this + v : nullptr;
+			}
+			Rank r;
+			if (!nst::search<arch>(&ft.nextKeys[nextOffset], &ft.nextRanks[nextOffset], numNexts(), c, r))
+			{
+				return nullptr;
+			}
+			return ft.child(this, r);
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		auto CompactFrozenTrie<_Key, _Value, _HasSubmatch>::Node::fail() const -> const Node*
+		{
+			if (!lower) return nullptr;
+			return this + lower;
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<ArchType arch>
+		auto CompactFrozenTrie<_Key, _Value, _HasSubmatch>::Node::findFail(const CompactFrozenTrie& ft, Key c) const -> const Node*
+		{
+			if (!lower) return this;
+			auto* lowerNode = this + lower;
+			if (auto* next = lowerNode->template nextOpt<arch>(ft, c))
+			{
+				return next;
+			}
+			// `c` node doesn't exist
+			return lowerNode->template findFail<arch>(ft, c);
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		auto CompactFrozenTrie<_Key, _Value, _HasSubmatch>::Node::val(const CompactFrozenTrie& ft) const -> const Value&
+		{
+			return ft.values[ft.valueIdx[this - ft.nodes.data()]];
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<class TrieNode, ArchType archType, class Xform>
+		CompactFrozenTrie<_Key, _Value, _HasSubmatch>::CompactFrozenTrie(const ContinuousTrie<TrieNode>& trie, ArchTypeHolder<archType>, Xform xform, ThreadPool* pool)
+		{
+			numNodes = trie.size();
+
+			// 루트와 부모가 없는 노드들을 원래 순서대로 앞에 두고, 나머지는 너비 우선 순서로 배치한다.
+			Vector<uint8_t> hasParent(numNodes);
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				for (auto& p : trie[i].next)
+				{
+					if (p.second <= 0) throw std::invalid_argument{ "CompactFrozenTrie requires a tree-shaped trie" };
+					hasParent[i + p.second] = 1;
+				}
+			}
+
+			Vector<uint32_t> order;
+			order.reserve(numNodes);
+			order.emplace_back(0);
+			for (size_t i = 1; i < numNodes; ++i)
+			{
+				if (!hasParent[i]) order.emplace_back(i);
+			}
+			childBase = order.size();
+
+			nodes.resize(numNodes + 1);
+			valueIdx.resize(numNodes);
+			initValues();
+			nextKeys.reserve(numNodes - childBase);
+			nextRanks.reserve(numNodes - childBase);
+
+			Vector<uint8_t> tempBuf;
+			std::vector<std::pair<Key, int32_t>> pairs;
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				auto& o = trie[order[i]];
+				nodes[i].nextOffset = nextKeys.size();
+				valueIdx[i] = addValue(xform(o));
+
+				pairs.assign(o.next.begin(), o.next.end());
+				std::sort(pairs.begin(), pairs.end());
+				for (size_t r = 0; r < pairs.size(); ++r)
+				{
+					nextKeys.emplace_back(pairs[r].first);
+					nextRanks.emplace_back((Rank)r);
+					order.emplace_back(order[i] + pairs[r].second);
+				}
+				nst::prepare<archType>(nextKeys.data() + nodes[i].nextOffset, nextRanks.data() + nodes[i].nextOffset, pairs.size(), tempBuf);
+			}
+			nodes[numNodes].nextOffset = nextKeys.size();
+
+			// 실패 링크와 submatch 표시는 `FrozenTrie`와 같은 순서로 루트에서 도달 가능한 노드에 대해서만 계산한다.
+			detail::visitByDepth(&nodes[0], pool, [&](Node* p, Vector<Node*>& children)
+			{
+				for (size_t i = 0; i < p->numNexts(); ++i)
+				{
+					auto k = nextKeys[p->nextOffset + i];
+					auto* c = const_cast<Node*>(child(p, nextRanks[p->nextOffset + i]));
+					c->lower = p->template findFail<archType>(*this, k) - c;
+					children.emplace_back(c);
+				}
+
+				if (this->isNull(p->val(*this)))
+				{
+					for (auto n = p; n->lower; n = const_cast<Node*>(n->fail()))
+					{
+						if (this->isNull(n->val(*this))) continue;
+						valueIdx[p - nodes.data()] = 1;
+						break;
+					}
+				}
+			});
+			buildDirectTransitions();
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<class Fn>
+		void CompactFrozenTrie<_Key, _Value, _HasSubmatch>::writeRaw(std::ostream& ostr, Fn&& valueToIdx) const
+		{
+			// `FrozenTrie::readRaw()`가 잘못 읽지 않도록 노드 수 자리에 구분용 값을 먼저 쓴다.
+			serializer::writeMany(ostr, (uint64_t)-1, (uint64_t)numNodes, (uint64_t)childBase, (uint64_t)nextKeys.size());
+			Vector<uint32_t> idx(numNodes);
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				idx[i] = valueToIdx(values[valueIdx[i]]);
+			}
+			serializer::writeToStream(ostr, idx);
+			if (!ostr.write((const char*)nodes.data(), sizeof(Node) * nodes.size())
+				|| !ostr.write((const char*)nextKeys.data(), sizeof(Key) * nextKeys.size())
+				|| !ostr.write((const char*)nextRanks.data(), sizeof(Rank) * nextRanks.size()))
+			{
+				throw serializer::SerializationException{ "writing CompactFrozenTrie failed" };
+			}
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		template<class Fn>
+		void CompactFrozenTrie<_Key, _Value, _HasSubmatch>::readRaw(std::istream& istr, Fn&& idxToValue)
+		{
+			uint64_t magic, nNodes, nBase, nNexts;
+			Vector<uint32_t> idx;
+			serializer::readMany(istr, magic, nNodes, nBase, nNexts, idx);
+			if (magic != (uint64_t)-1 || idx.size() != nNodes) throw serializer::SerializationException{ "reading CompactFrozenTrie failed" };
+			numNodes = nNodes;
+			childBase = nBase;
+			nodes.resize(numNodes + 1);
+			valueIdx.resize(numNodes);
+			nextKeys.resize(nNexts);
+			nextRanks.resize(nNexts);
+			initValues();
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				valueIdx[i] = addValue(idxToValue(idx[i]));
+			}
+			if (!istr.read((char*)nodes.data(), sizeof(Node) * nodes.size())
+				|| !istr.read((char*)nextKeys.data(), sizeof(Key) * nextKeys.size())
+				|| !istr.read((char*)nextRanks.data(), sizeof(Rank) * nextRanks.size()))
+			{
+				throw serializer::SerializationException{ "reading CompactFrozenTrie failed" };
+			}
+			buildDirectTransitions();
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		void CompactFrozenTrie<_Key, _Value, _HasSubmatch>::rearrangeKeys(ArchType archType)
+		{
+			using FnRearrangeKeys = decltype(&detail::rearrangeKeys<ArchType::none, _Key, Rank>);
+			static tp::Table<FnRearrangeKeys, AvailableArch> table{ detail::RearrangeKeysGetter<FnRearrangeKeys, _Key, Rank>{} };
+			auto* fn = table[static_cast<std::ptrdiff_t>(archType)];
+			if (!fn) throw std::runtime_error{ std::string{"Unsupported architecture : "} + archToStr(archType) };
+
+			Vector<uint8_t> tempBuf;
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				(*fn)(nextKeys.data() + nodes[i].nextOffset, nextRanks.data() + nodes[i].nextOffset, nodes[i].numNexts(), tempBuf);
+			}
+		}
+
+		template<class _Key, class _Value, class _HasSubmatch>
+		void CompactFrozenTrie<_Key, _Value, _HasSubmatch>::buildDirectTransitions(size_t memoryBudget, size_t minFanout)
+		{
+			direct.clear();
+			if (!memoryBudget) return;
+
+			Vector<size_t> cands;
+			for (size_t i = 0; i < numNodes; ++i)
+			{
+				if (nodes[i].numNexts() >= minFanout) cands.emplace_back(i);
+			}
+			std::stable_sort(cands.begin(), cands.end(), [&](size_t a, size_t b)
+			{
+				return nodes[a].numNexts() > nodes[b].numNexts();
+			});
+			Vector<int32_t> diffs;
+			for (auto i : cands)
+			{
+				const auto* node = &nodes[i];
+				const size_t n = node->numNexts();
+				diffs.resize(n);
+				for (size_t j = 0; j < n; ++j)
+				{
+					diffs[j] = (int32_t)(child(node, nextRanks[node->nextOffset + j]) - node);
+				}
+				direct.add(i, &nextKeys[node->nextOffset], diffs.data(), n, minFanout, memoryBudget);
 			}
 		}
 
@@ -180,5 +541,38 @@ namespace kiwi
 			if (!fn) throw std::runtime_error{ std::string{"Unsupported architecture : "} + archToStr(archType) };
 			return (*fn)(std::move(trie));
 		}
+
+		namespace detail
+		{
+			template<ArchType archType, class Frozen, class Ty>
+			Frozen freezeTrieAs(ContinuousTrie<Ty>&& trie, ThreadPool* pool)
+			{
+				return { trie, ArchTypeHolder<archType>{}, NodeToVal{}, pool };
+			}
+
+			template<class Fn, class Frozen, class Ty>
+			struct FreezeTrieAsGetter
+			{
+				template<std::ptrdiff_t i>
+				struct Wrapper
+				{
+					static constexpr Fn value = &freezeTrieAs<static_cast<ArchType>(i), Frozen, Ty>;
+				};
+			};
+		}
+
+		/**
+		 * @brief `freezeTrie()`와 같지만 결과 트라이의 타입(`FrozenTrie` 또는 `CompactFrozenTrie`)을 지정할 수 있다.
+		 * @param pool nullptr이 아니면 변환 작업을 pool의 작업자들이 나누어 수행한다.
+		 */
+		template<class Frozen, class Ty>
+		inline Frozen freezeTrieAs(ContinuousTrie<Ty>&& trie, ArchType archType, ThreadPool* pool = nullptr)
+		{
+			using FnFreezeTrie = decltype(&detail::freezeTrieAs<ArchType::none, Frozen, Ty>);
+			static tp::Table<FnFreezeTrie, AvailableArch> table{ detail::FreezeTrieAsGetter<FnFreezeTrie, Frozen, Ty>{} };
+			auto* fn = table[static_cast<std::ptrdiff_t>(archType)];
+			if (!fn) throw std::runtime_error{ std::string{"Unsupported architecture : "} + archToStr(archType) };
+			return (*fn)(std::move(trie), pool);
+		}
 	}
 }
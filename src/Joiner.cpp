@@ -246,7 +246,7 @@ namespace kiwi
 		template<class LmState>
 		void AutoJoiner::add(size_t morphemeId, Space space, Vector<Candidate<LmState>>& candidates)
 		{
-			auto& morph = kiwi->morphemes[morphemeId];
+			auto& morph = kiwi->vocab->morphemes[morphemeId];
 			for (auto& cand : candidates)
 			{
 				cand.score += cand.lmState.next(kiwi->langMdl, morph.lmMorphemeId);
@@ -269,7 +269,7 @@ namespace kiwi
 				{
 					if (tformHead->score() == 0)
 					{
-						for (auto m : tformHead->form(kiwi->forms.data()).candidate)
+						for (auto m : tformHead->form(kiwi->vocab->forms.data()).candidate)
 						{
 							func(m);
 						}
@@ -294,10 +294,10 @@ namespace kiwi
 		void AutoJoiner::add(U16StringView form, POSTag tag, bool inferRegularity, Space space, Vector<Candidate<LmState>>& candidates)
 		{
 			const Form* formHead;
-			auto node = kiwi->formTrie.root();
+			auto node = kiwi->vocab->formTrie.root();
 			for (auto c : normalizeHangul(form))
 			{
-				node = node->template nextOpt<LmState::arch>(kiwi->formTrie, c);
+				node = node->template nextOpt<LmState::arch>(kiwi->vocab->formTrie, c);
 				if (!node) break;
 			}
 
@@ -308,7 +308,7 @@ namespace kiwi
 				fixedTag = POSTag::nnp;
 			}
 
-			if (node && kiwi->formTrie.hasMatch(formHead = node->val(kiwi->formTrie)))
+			if (node && kiwi->vocab->formTrie.hasMatch(formHead = node->val(kiwi->vocab->formTrie)))
 			{
 				Vector<const Morpheme*> cands;
 				foreachMorpheme(formHead, [&](const Morpheme* m)
@@ -395,16 +395,16 @@ namespace kiwi
 		{
 			if (inferRegularity)
 			{
-				auto node = kiwi->formTrie.root();
+				auto node = kiwi->vocab->formTrie.root();
 				for (auto c : normalizeHangul(form))
 				{
-					node = node->template nextOpt<arch>(kiwi->formTrie, c);
+					node = node->template nextOpt<arch>(kiwi->vocab->formTrie, c);
 					if (!node) break;
 				}
 
 				if (node)
 				{
-					if (const Form* formHead = node->val(kiwi->formTrie))
+					if (const Form* formHead = node->val(kiwi->vocab->formTrie))
 					{
 						Vector<const Morpheme*> cands;
 						foreachMorpheme(formHead, [&](const Morpheme* m)
@@ -428,7 +428,7 @@ namespace kiwi
 		template<ArchType arch>
 		void AutoJoiner::addWithoutSearch(size_t morphemeId, Space space, Vector<Candidate<VoidState<arch>>>& candidates)
 		{
-			auto& morph = kiwi->morphemes[morphemeId];
+			auto& morph = kiwi->vocab->morphemes[morphemeId];
 			for (auto& cand : candidates)
 			{
 				cand.joiner.add(morph.getForm(), morph.tag, space);
@@ -45,6 +45,9 @@ namespace kiwi
 	template<bool typoTolerant, bool continualTypoTolerant, bool lengtheningTypoTolerant>
 	struct FormCandidate
 	{
+		// 오타 목록에 없는 형태(사용자 사전 오버레이의 형태)에 부여되는 typoId
+		static constexpr uint32_t noTypoId = -1;
+
 		const Form* form = nullptr;
 		float cost = 0;
 		uint32_t start = 0;
@@ -84,11 +87,12 @@ namespace kiwi
 
 		uint32_t getTypoId() const
 		{
-			return typoId;
+			return typoId == noTypoId ? 0 : typoId;
 		}
 
 		size_t getFormSizeWithTypos(const size_t* typoPtrs) const
 		{
+			if (typoId == noTypoId) return form->form.size() + numSpaces;
 			return typoPtrs[typoId + 1] - typoPtrs[typoId] + numSpaces;
 		}
 
@@ -101,6 +105,8 @@ namespace kiwi
 	template<>
 	struct FormCandidate<false, false, false>
 	{
+		static constexpr uint32_t noTypoId = -1;
+
 		const Form* form = nullptr;
 
 		FormCandidate(const Form* _form = nullptr, float = 0, uint32_t = 0, uint32_t = 0, uint32_t = 0, uint32_t = 0, uint32_t = 0)
@@ -497,16 +503,16 @@ namespace kiwi
 	template<ArchType arch, class Decomposer, bool typoTolerant, bool continualTypoTolerant, bool lengtheningTypoTolerant>
 	inline void insertContinualTypoNode(
 		Vector<FormCandidate<typoTolerant, continualTypoTolerant, lengtheningTypoTolerant>>& candidates,
-		Vector<pair<size_t, const utils::FrozenTrie<kchar_t, const Form*>::Node*>>& continualTypoRightNodes,
+		Vector<pair<size_t, const FormTrie::Node*>>& continualTypoRightNodes,
 		Decomposer decomposer,
 		float continualTypoCost,
 		char16_t c,
 		const Form* formBase,
 		const size_t* typoPtrs,
-		const utils::FrozenTrie<kchar_t, const Form*>& trie,
+		const FormTrie& trie,
 		U16StringView str,
 		const Vector<uint32_t>& nonSpaces,
-		const utils::FrozenTrie<kchar_t, const Form*>::Node* curNode
+		const FormTrie::Node* curNode
 	)
 	{
 		if (!continualTypoTolerant) return;
@@ -568,7 +574,8 @@ size_t kiwi::splitByTrie(
 	Vector<KGraphNode>& ret,
 	const Form* formBase,
 	const size_t* typoPtrs,
-	const utils::FrozenTrie<kchar_t, const Form*>& trie, 
+	const FormTrie& trie, 
+	const UserOverlay* overlay,
 	U16StringView str,
 	size_t startOffset,
 	Match matchOptions, 
@@ -622,6 +629,42 @@ size_t kiwi::splitByTrie(
 	Vector<pair<size_t, NodePtrTy>> continualTypoRightNodes;
 	Vector<pair<size_t, NodePtrTy>> lengtheningTypoNodes;
 
+	// 사용자 사전 오버레이는 공백 없이 이어진 구간 안에서 기본 트라이와 나란히 탐색한다
+	const FormTrie* overlayTrie = (overlay && !overlay->empty()) ? &overlay->getTrie() : nullptr;
+	NodePtrTy overlayNode = overlayTrie ? overlayTrie->root() : nullptr;
+	auto matchOverlay = [&](char16_t ch)
+	{
+		if (!overlayTrie) return;
+		auto* next = overlayNode->template nextOpt<arch>(*overlayTrie, ch);
+		while (!next && overlayNode->fail())
+		{
+			overlayNode = overlayNode->fail();
+			next = overlayNode->template nextOpt<arch>(*overlayTrie, ch);
+		}
+		if (!next)
+		{
+			overlayNode = overlayTrie->root();
+			return;
+		}
+		overlayNode = next;
+		using Candidate = FormCandidate<typoTolerant, continualTypoTolerant, lengtheningTypoTolerant>;
+		for (auto submatcher = overlayNode; submatcher; submatcher = submatcher->fail())
+		{
+			const Form* cand = submatcher->val(*overlayTrie);
+			if (!cand) break;
+			else if (!overlayTrie->hasSubmatch(cand))
+			{
+				candidates.emplace_back(cand, 0.f, 
+					(uint32_t)((nonSpaces.size() - cand->form.size()) * posMultiplier), 
+					(uint32_t)Candidate::noTypoId);
+			}
+		}
+	};
+	auto resetOverlay = [&]()
+	{
+		if (overlayTrie) overlayNode = overlayTrie->root();
+	};
+
 	size_t lastSpecialEndPos = 0, specialStartPos = 0;
 	POSTag chrType, lastChrType = POSTag::unknown, lastMatchedPattern = POSTag::unknown;
 	ScriptType scriptType, lastScriptType = ScriptType::unknown;
@@ -673,7 +716,7 @@ size_t kiwi::splitByTrie(
 				}				
 
 				// if special character
-				if (cand.form->candidate[0] <= trie.value((size_t)POSTag::sn)->candidate[0])
+				if (!(overlay && overlay->ownsForm(cand.form)) && cand.form->candidate[0] <= trie.value((size_t)POSTag::sn)->candidate[0])
 				{
 					// special character should be processed one by one chr.
 					if (!alreadySpecialChrProcessed)
@@ -788,6 +831,7 @@ size_t kiwi::splitByTrie(
 			pretokenizedFirst++;
 			chrType = POSTag::max;
 			curNode = trie.root();
+			resetOverlay();
 			goto continueFor;
 		}
 
@@ -857,6 +901,7 @@ size_t kiwi::splitByTrie(
 
 				n += m.first - 1;
 				lastMatchedPattern = m.second;
+				resetOverlay();
 				// SN태그 패턴 매칭의 경우 Web태그로 치환하여 Web와 동일하게 처리되도록 한다
 				if (chrType == POSTag::sn)
 				{
@@ -933,6 +978,7 @@ size_t kiwi::splitByTrie(
 		{
 			flushBranch(nonSpaces.size(), n);
 			lastSpecialEndPos = nonSpaces.size();
+			resetOverlay();
 			goto continueFor;
 		}
 
@@ -966,12 +1012,18 @@ size_t kiwi::splitByTrie(
 				if (chrType == POSTag::unknown)
 				{
 					lastSpecialEndPos = nonSpaces.size();
+					resetOverlay();
 				}
 				// 그 외의 경우
 				else
 				{
 					nonSpaces.emplace_back(n);
-					if (c32 >= 0x10000) nonSpaces.emplace_back(++n);
+					matchOverlay(c);
+					if (c32 >= 0x10000)
+					{
+						nonSpaces.emplace_back(++n);
+						matchOverlay(str[n]);
+					}
 					if (chrType != POSTag::max)
 					{
 						lastSpecialEndPos = nonSpaces.size();
@@ -1083,6 +1135,7 @@ size_t kiwi::splitByTrie(
 		}
 		
 		nonSpaces.emplace_back(n);
+		matchOverlay(c);
 
 		if (!!(matchOptions & Match::zCoda) && zCodaFollowable && isHangulCoda(c) && (n + 1 >= str.size() || !isHangulSyllable(str[n + 1])))
 		{
@@ -1204,7 +1257,7 @@ size_t kiwi::splitByTrie(
 
 template<ArchType arch, bool typoTolerant>
 const Form* kiwi::findForm(
-	const utils::FrozenTrie<kchar_t, const Form*>& trie,
+	const FormTrie& trie,
 	const Form* formData,
 	const KString& str
 )
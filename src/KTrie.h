@@ -5,6 +5,7 @@
 #include <kiwi/Form.h>
 #include <kiwi/PatternMatcher.h>
 #include <kiwi/FrozenTrie.h>
+#include <kiwi/UserOverlay.h>
 
 #include "StrUtils.h"
 
@@ -81,6 +82,7 @@ namespace kiwi
 	* @tparam typoTolerant 오타가 포함된 형태를 탐색할지 여부
 	* @tparam continualTypoTolerant 연철된 오타를 탐색할지 여부
 	* @tparam lengtheningTypoTolerant 여러 음절로 늘려진 오타를 탐색할지 여부
+	* @param overlay 기본 형태 트라이와 함께 탐색할 사용자 사전 오버레이. 없으면 nullptr
 	*/
 	template<ArchType arch, 
 		bool typoTolerant = false, 
@@ -91,7 +93,8 @@ namespace kiwi
 		Vector<KGraphNode>& out,
 		const Form* formBase,
 		const size_t* typoPtrs,
-		const utils::FrozenTrie<kchar_t, const Form*>& trie, 
+		const FormTrie& trie, 
+		const UserOverlay* overlay,
 		U16StringView str, 
 		size_t startOffset,
 		Match matchOptions, 
@@ -105,7 +108,7 @@ namespace kiwi
 
 	template<ArchType arch, bool typoTolerant>
 	const Form* findForm(
-		const utils::FrozenTrie<kchar_t, const Form*>& trie,
+		const FormTrie& trie,
 		const Form* formData,
 		const KString& str
 	);
@@ -1,4 +1,5 @@
 #include <fstream>
+#include <list>
 
 #include <kiwi/Kiwi.h>
 #include <kiwi/Utils.h>
@@ -14,6 +15,7 @@
 #include "serializer.hpp"
 #include "Joiner.hpp"
 #include "PathEvaluator.hpp"
+#include "ResultCache.hpp"
 
 using namespace std;
 
@@ -48,6 +50,8 @@ namespace kiwi
 		bool lengtheningTypoTolerant)
 		: langMdl(_langMdl)
 	{
+		static atomic<uint64_t> numInstances{ 0 };
+		instanceId = ++numInstances;
 		selectedArch = arch;
 		dfSplitByTrie = (void*)getSplitByTrieFn(selectedArch, 
 			typoTolerant, 
@@ -141,7 +145,143 @@ namespace kiwi
 		return ret;
 	}
 
-	inline void fillPairedTokenInfo(vector<TokenInfo>& tokens)
+	/**
+	* @brief 분석 결과를 만드는 동안 사용하는 형태소 정보.
+	* @details TokenInfo와 같은 정보를 담지만 형태를 직접 소유하지 않고, 
+	* PooledTokenForms가 관리하는 공유 버퍼 내의 구간(formBegin, formSize)으로 가리킨다.
+	*/
+	struct PooledTokenInfo
+	{
+		uint32_t formBegin = 0;
+		uint32_t formSize = 0;
+		uint32_t position = 0;
+		uint32_t wordPosition = 0;
+		uint32_t sentPosition = 0;
+		uint32_t lineNumber = 0;
+		uint16_t length = 0;
+		POSTag tag = POSTag::unknown;
+		union {
+			uint8_t senseId = 0;
+			ScriptType script;
+		};
+		float score = 0;
+		float typoCost = 0;
+		uint32_t typoFormId = 0;
+		uint32_t pairedToken = -1;
+		uint32_t subSentPosition = 0;
+		const Morpheme* morph = nullptr;
+
+		uint32_t endPos() const { return position + length; }
+	};
+
+	/**
+	* @brief [first, last)의 자모를 음절로 합쳐 out의 뒤에 추가한다. out의 start 이전 문자와는 합치지 않는다.
+	*/
+	template<class It>
+	inline void appendJoinedHangul(u16string& out, size_t start, It first, It last)
+	{
+		for (; first != last; ++first)
+		{
+			auto c = *first;
+			if (isHangulCoda(c) && out.size() > start && isHangulSyllable(out.back()))
+			{
+				if ((out.back() - 0xAC00) % 28) out.push_back(c);
+				else out.back() += c - 0x11A7;
+			}
+			else
+			{
+				out.push_back(c);
+			}
+		}
+	}
+
+	/**
+	* @brief 형태를 직접 소유하는 TokenInfo에 대한 형태 접근자
+	*/
+	struct OwnedTokenForms
+	{
+		U16StringView view(const TokenInfo& t) const
+		{
+			return t.str;
+		}
+
+		template<class It>
+		void assignJoined(TokenInfo& t, char16_t head, It first, It last, bool compatibleJamo)
+		{
+			t.str.clear();
+			if (head) t.str.push_back(head);
+			appendJoinedHangul(t.str, 0, first, last);
+			if (compatibleJamo)
+			{
+				for (auto& c : t.str) c = toCompatibleHangulConsonant(c);
+			}
+		}
+
+		void concat(TokenInfo& dest, const TokenInfo& src)
+		{
+			dest.str += src.str;
+		}
+
+		void addToBack(TokenInfo& t, char16_t delta)
+		{
+			t.str.back() += delta;
+		}
+	};
+
+	/**
+	* @brief 형태를 하나의 공유 버퍼(pool)에 이어 붙여 저장하는 PooledTokenInfo에 대한 형태 접근자.
+	* @details 후보 경로를 복사할 때 형태소들은 버퍼 내 같은 구간을 공유하므로, 
+	* 형태를 수정할 때에는 항상 버퍼의 끝에 있는 구간만 제자리에서 늘리고, 그렇지 않으면 끝으로 복사한 뒤 수정한다.
+	*/
+	struct PooledTokenForms
+	{
+		u16string& pool;
+
+		U16StringView view(const PooledTokenInfo& t) const
+		{
+			return U16StringView{ pool.data() + t.formBegin, t.formSize };
+		}
+
+		template<class It>
+		void assignJoined(PooledTokenInfo& t, char16_t head, It first, It last, bool compatibleJamo)
+		{
+			const size_t begin = pool.size();
+			if (head) pool.push_back(head);
+			appendJoinedHangul(pool, begin, first, last);
+			if (compatibleJamo)
+			{
+				for (size_t i = begin; i < pool.size(); ++i) pool[i] = toCompatibleHangulConsonant(pool[i]);
+			}
+			t.formBegin = (uint32_t)begin;
+			t.formSize = (uint32_t)(pool.size() - begin);
+		}
+
+		void moveToBack(PooledTokenInfo& t)
+		{
+			const size_t begin = pool.size();
+			pool.resize(begin + t.formSize);
+			copy(pool.begin() + t.formBegin, pool.begin() + t.formBegin + t.formSize, pool.begin() + begin);
+			t.formBegin = (uint32_t)begin;
+		}
+
+		void concat(PooledTokenInfo& dest, const PooledTokenInfo& src)
+		{
+			if (dest.formBegin + dest.formSize != pool.size()) moveToBack(dest);
+			const size_t begin = pool.size();
+			pool.resize(begin + src.formSize);
+			copy(pool.begin() + src.formBegin, pool.begin() + src.formBegin + src.formSize, pool.begin() + begin);
+			dest.formSize += src.formSize;
+		}
+
+		void addToBack(PooledTokenInfo& t, char16_t delta)
+		{
+			moveToBack(t);
+			pool.back() += delta;
+		}
+	};
+
+	template<class Tokens, class Forms>
+	inline void fillPairedTokenInfo(Tokens& tokens, const Forms& forms)
 	{
 		Vector<pair<uint32_t, uint32_t>> pStack;
 		Vector<pair<uint32_t, uint32_t>> bStack;
@@ -150,13 +290,13 @@ namespace kiwi
 			const uint32_t i = &t - tokens.data();
 			if (t.tag == POSTag::sso)
 			{
-				uint32_t type = getSSType(t.str[0]);
+				uint32_t type = getSSType(forms.view(t)[0]);
 				if (!type) continue;
 				pStack.emplace_back(i, type);
 			}
 			else if (t.tag == POSTag::ssc)
 			{
-				uint32_t type = getSSType(t.str[0]);
+				uint32_t type = getSSType(forms.view(t)[0]);
 				if (!type) continue;
 				for (auto j = pStack.rbegin(); j != pStack.rend(); ++j)
 				{
@@ -169,7 +309,7 @@ namespace kiwi
 			}
 			else if (t.tag == POSTag::sb)
 			{
-				uint32_t type = getSBType(t.str);
+				uint32_t type = getSBType(forms.view(t));
 				if (!type) continue;
 				
 				for (auto j = bStack.rbegin(); j != bStack.rend(); ++j)
@@ -208,7 +348,8 @@ namespace kiwi
 		size_t lastLineNumber = 0;
 	public:
 
-		bool next(const TokenInfo& t, size_t lineNumber, bool forceNewSent = false)
+		template<class Token>
+		bool next(const Token& t, size_t lineNumber, bool forceNewSent = false)
 		{
 			bool ret = false;
 			if (forceNewSent)
@@ -345,30 +486,34 @@ namespace kiwi
 		}
 	};
 
-	inline bool hasSentences(const TokenInfo* first, const TokenInfo* last)
+	template<class Token>
+	inline bool hasSentences(const Token* first, const Token* last)
 	{
 		SentenceParser sp;
 		for (; first != last; ++first)
 		{
 			if (sp.next(*first, 0)) return true;
 		}
-		return sp.next({}, 0);
+		return sp.next(Token{}, 0);
 	}
 
-	inline bool isNestedLeft(const TokenInfo& t)
+	template<class Token>
+	inline bool isNestedLeft(const Token& t)
 	{
 		return isJClass(t.tag) || (isEClass(t.tag) && t.tag != POSTag::ef) || t.tag == POSTag::sp;
 	}
 
-	inline bool isNestedRight(const TokenInfo& t)
+	template<class Token, class Forms>
+	inline bool isNestedRight(const Token& t, const Forms& forms)
 	{
-		return isJClass(t.tag) || isEClass(t.tag) || (isVerbClass(t.tag) && t.str == u"하") || t.tag == POSTag::vcp || t.tag == POSTag::sp;
+		return isJClass(t.tag) || isEClass(t.tag) || (isVerbClass(t.tag) && forms.view(t) == u"하") || t.tag == POSTag::vcp || t.tag == POSTag::sp;
 	}
 
 	/**
 	* @brief tokens에 문장 번호 및 줄 번호를 채워넣는다.
 	*/
-	inline void fillSentLineInfo(vector<TokenInfo>& tokens, const vector<size_t>& newlines)
+	template<class Tokens, class Forms>
+	inline void fillSentLineInfo(Tokens& tokens, const Forms& forms, const vector<size_t>& newlines)
 	{
 		SentenceParser sp;
 		uint32_t sentPos = 0, lastSentPos = 0, subSentPos = 0, accumSubSent = 1, accumWordPos = 0, lastWordPos = 0;
@@ -415,7 +560,7 @@ namespace kiwi
 					nestedEnd = t.pairedToken;
 					subSentPos = 0;
 				}
-				else if ((t.pairedToken + 1 < tokens.size() && isNestedRight(tokens[t.pairedToken + 1]))
+				else if ((t.pairedToken + 1 < tokens.size() && isNestedRight(tokens[t.pairedToken + 1], forms))
 						|| (i > 0 && isNestedLeft(tokens[i - 1])))
 				{
 					nestedSentEnd = t.pairedToken;
@@ -530,16 +675,17 @@ namespace kiwi
 		}
 	}
 
-	inline void concatTokens(TokenInfo& dest, const TokenInfo& src, POSTag tag)
+	template<class Token, class Forms>
+	inline void concatTokens(Token& dest, const Token& src, POSTag tag, Forms& forms)
 	{
 		dest.tag = tag;
 		dest.morph = nullptr;
 		dest.length = (uint16_t)(src.position + src.length - dest.position);
-		dest.str += src.str;
+		forms.concat(dest, src);
 	}
 
-	template<class TokenInfoIt>
-	TokenInfoIt joinAffixTokens(TokenInfoIt first, TokenInfoIt last, Match matchOptions)
+	template<class TokenInfoIt, class Forms>
+	TokenInfoIt joinAffixTokens(TokenInfoIt first, TokenInfoIt last, Match matchOptions, Forms& forms)
 	{
 		if (!(matchOptions & (Match::joinNounPrefix 
 							| Match::joinNounSuffix 
@@ -553,8 +699,8 @@ namespace kiwi
 		++next;
 		while (next != last)
 		{
-			TokenInfo& current = *first;
-			TokenInfo& nextToken = *next;
+			auto& current = *first;
+			auto& nextToken = *next;
 
 			// XPN + (NN. | SN) => (NN. | SN)
 			if (!!(matchOptions & Match::joinNounPrefix) 
@@ -562,7 +708,7 @@ namespace kiwi
 				&& (isNNClass(nextToken.tag) || nextToken.tag == POSTag::sn)
 			)
 			{
-				concatTokens(current, nextToken, nextToken.tag);
+				concatTokens(current, nextToken, nextToken.tag, forms);
 				++next;
 			}
 			// (NN. | SN) + XSN => (NN. | SN)
@@ -571,7 +717,7 @@ namespace kiwi
 				&& (isNNClass(current.tag) || current.tag == POSTag::sn)
 			)
 			{
-				concatTokens(current, nextToken, current.tag);
+				concatTokens(current, nextToken, current.tag, forms);
 				++next;
 			}
 			// (NN. | XR) + XSV => VV
@@ -580,7 +726,7 @@ namespace kiwi
 				&& (isNNClass(current.tag) || current.tag == POSTag::xr)
 			)
 			{
-				concatTokens(current, nextToken, setIrregular(POSTag::vv, isIrregular(nextToken.tag)));
+				concatTokens(current, nextToken, setIrregular(POSTag::vv, isIrregular(nextToken.tag)), forms);
 				++next;
 			}
 			// (NN. | XR) + XSA => VA
@@ -589,7 +735,7 @@ namespace kiwi
 				&& (isNNClass(current.tag) || current.tag == POSTag::xr)
 			)
 			{
-				concatTokens(current, nextToken, setIrregular(POSTag::va, isIrregular(nextToken.tag)));
+				concatTokens(current, nextToken, setIrregular(POSTag::va, isIrregular(nextToken.tag)), forms);
 				++next;
 			}
 			// (NN. | XR) + XSM => MAG
@@ -598,7 +744,7 @@ namespace kiwi
 				&& (isNNClass(current.tag) || current.tag == POSTag::xr)
 				)
 			{
-				concatTokens(current, nextToken, POSTag::mag);
+				concatTokens(current, nextToken, POSTag::mag, forms);
 				++next;
 			}
 			// NN. + Z_SIOT + NN. => NN
@@ -608,8 +754,8 @@ namespace kiwi
 				&& next + 1 != last
 				&& isNNClass((next + 1)->tag))
 			{
-				current.str.back() += (0x11BA - 0x11A7);
-				concatTokens(current, *(next + 1), POSTag::nng);
+				forms.addToBack(current, 0x11BA - 0x11A7);
+				concatTokens(current, *(next + 1), POSTag::nng, forms);
 				++next;
 				++next;
 			}
@@ -623,15 +769,17 @@ namespace kiwi
 		return ++first;
 	}
 
-	inline void updateTokenInfoScript(TokenInfo& info)
+	template<class Token, class Forms>
+	inline void updateTokenInfoScript(Token& info, const Forms& forms)
 	{
 		if (!(info.tag == POSTag::sl || info.tag == POSTag::sh || info.tag == POSTag::sw || info.tag == POSTag::w_emoji)) return;
 		if ((info.morph && info.morph->kform && !info.morph->kform->empty())) return;
-		if (info.str.empty()) return;
-		char32_t c = info.str[0];
+		const auto str = forms.view(info);
+		if (str.empty()) return;
+		char32_t c = str[0];
 		if (isHighSurrogate(c))
 		{
-			c = mergeSurrogate(c, info.str[1]);
+			c = mergeSurrogate(c, str[1]);
 		}
 		info.script = chr2ScriptType(c);
 		if (info.script == ScriptType::latin)
@@ -640,16 +788,102 @@ namespace kiwi
 		}
 	}
 
-	inline void toCompatibleJamo(u16string& str)
+	/**
+	 * @brief 문장 단위 그래프 조각에 대한 findBestPath의 결과를 기억해두는 스레드별 저장소.
+	 * @details 그래프는 조각의 텍스트만으로 결정되고 경로 탐색은 조각마다 새 LM 상태에서 시작하므로,
+	 * 텍스트와 앞 조각에서 넘어온 SpecialState, 분석 옵션이 같으면 결과도 위치만 다를 뿐 동일하다.
+	 * 크기가 한도에 이르면 가장 오래 사용되지 않은 항목부터 하나씩 밀어낸다.
+	 */
+	class ChunkResultMemo
 	{
-		for (auto& c : str)
+		struct Entry
+		{
+			Vector<PathEvaluator::ChunkResult> results;
+			size_t startPos = 0;
+			std::list<u16string>::iterator order;
+		};
+
+		UnorderedMap<u16string, Entry> entries;
+		std::list<u16string> lru;
+		u16string key;
+
+		template<class Ty>
+		void append(const Ty& v)
 		{
-			c = toCompatibleHangulConsonant(c);
+			const size_t pos = key.size();
+			key.resize(pos + (sizeof(Ty) + 1) / 2);
+			memcpy(&key[pos], &v, sizeof(Ty));
+		}
+
+	public:
+		static ChunkResultMemo& local()
+		{
+			thread_local ChunkResultMemo memo;
+			return memo;
 		}
-	}
 
+		void makeKey(uint64_t instanceId, size_t configVersion, uint64_t overlayGeneration, size_t topN, Match matchOptions,
+			const std::unordered_set<const Morpheme*>* blocklist,
+			const Vector<SpecialState>& spStates,
+			U16StringView chunk)
+		{
+			key.clear();
+			append(instanceId);
+			append(configVersion);
+			append(overlayGeneration);
+			append((uint64_t)topN);
+			append(matchOptions);
+			ResultCache::appendBlocklist(key, blocklist);
+			append((uint64_t)spStates.size());
+			for (auto s : spStates) append((uint8_t)s);
+			key.append(chunk.begin(), chunk.end());
+		}
+
+		bool find(Vector<PathEvaluator::ChunkResult>& out, size_t startPos)
+		{
+			auto it = entries.find(key);
+			if (it == entries.end()) return false;
+			lru.splice(lru.begin(), lru, it->second.order);
+			out = it->second.results;
+			const uint32_t oldStart = (uint32_t)it->second.startPos;
+			for (auto& r : out)
+			{
+				for (auto& p : r.path)
+				{
+					p.begin = p.begin - oldStart + (uint32_t)startPos;
+					p.end = p.end - oldStart + (uint32_t)startPos;
+				}
+			}
+			return true;
+		}
+
+		void store(const Vector<PathEvaluator::ChunkResult>& results, size_t startPos, size_t capacity)
+		{
+			auto it = entries.find(key);
+			if (it == entries.end())
+			{
+				while (!lru.empty() && entries.size() >= capacity)
+				{
+					entries.erase(lru.back());
+					lru.pop_back();
+				}
+				lru.emplace_front(key);
+				it = entries.emplace(key, Entry{}).first;
+				it->second.order = lru.begin();
+			}
+			else
+			{
+				lru.splice(lru.begin(), lru, it->second.order);
+			}
+			it->second.results = results;
+			it->second.startPos = startPos;
+		}
+	};
+
+	template<class Token, class Forms>
 	inline void insertPathIntoResults(
-		vector<TokenResult>& ret, 
+		vector<pair<vector<Token>, float>>& ret, 
+		Forms& forms,
 		Vector<SpecialState>& spStatesByRet,
 		const Vector<PathEvaluator::ChunkResult>& pathes,
 		size_t topN, 
@@ -658,7 +892,8 @@ namespace kiwi
 		const Vector<uint32_t>& positionTable,
 		const Vector<uint16_t>& wordPositions,
 		const PretokenizedSpanGroup& pretokenizedGroup,
-		const Vector<uint32_t>& nodeInWhichPretokenized
+		const Vector<uint32_t>& nodeInWhichPretokenized,
+		const UserOverlay* overlay
 	)
 	{
 		Vector<size_t> parentMap;
@@ -734,7 +969,10 @@ namespace kiwi
 			for (auto& s : r.path)
 			{
 				if (!s.str.empty() && s.str[0] == ' ') continue;
-				u16string joined;
+				rarr.emplace_back();
+				auto& token = rarr.back();
+				token.tag = s.morph->tag;
+				const bool compatibleJamo = !!(matchOptions & Match::compatibleJamo);
 				do
 				{
 					if (!integrateAllomorph)
@@ -745,28 +983,23 @@ namespace kiwi
 							{
 								if (prevMorph && prevMorph[0].back() == u'\uD558') // 하
 								{
-									joined = joinHangul(u"\uC5EC" + s.morph->kform->substr(1)); // 여
+									forms.assignJoined(token, u'\uC5EC', s.morph->kform->begin() + 1, s.morph->kform->end(), compatibleJamo); // 여
 									break;
 								}
 								else if (FeatureTestor::isMatched(prevMorph, CondPolarity::positive))
 								{
-									joined = joinHangul(u"\uC544" + s.morph->kform->substr(1)); // 아
+									forms.assignJoined(token, u'\uC544', s.morph->kform->begin() + 1, s.morph->kform->end(), compatibleJamo); // 아
 									break;
 								}
 							}
 						}
 					}
-					joined = joinHangul(s.str.empty() ? *s.morph->kform : s.str);
+					const KString& form = s.str.empty() ? *s.morph->kform : s.str;
+					forms.assignJoined(token, 0, form.begin(), form.end(), compatibleJamo);
 				} while (0);
-				
-				if (!!(matchOptions & Match::compatibleJamo))
-				{
-					toCompatibleJamo(joined);
-				}
 
-				rarr.emplace_back(joined, s.morph->tag);
-				auto& token = rarr.back();
-				token.morph = within(s.morph, pretokenizedGroup.morphemes) ? nullptr : s.morph;
+				// 분석 중에만 유효한 형태소(기분석 구간, 교체될 수 있는 오버레이)는 결과에 노출하지 않는다
+				token.morph = (within(s.morph, pretokenizedGroup.morphemes) || (overlay && overlay->ownsMorpheme(s.morph))) ? nullptr : s.morph;
 				size_t beginPos = (upper_bound(positionTable.begin(), positionTable.end(), s.begin) - positionTable.begin()) - 1;
 				size_t endPos = lower_bound(positionTable.begin(), positionTable.end(), s.end) - positionTable.begin();
 				token.position = (uint32_t)beginPos;
@@ -775,7 +1008,7 @@ namespace kiwi
 				token.typoCost = s.typoCost;
 				token.typoFormId = s.typoFormId;
 				token.senseId = s.morph->senseId;
-				updateTokenInfoScript(token);
+				updateTokenInfoScript(token, forms);
 				auto ptId = nodeInWhichPretokenized[s.nodeId] + 1;
 				if (ptId)
 				{
@@ -786,7 +1019,7 @@ namespace kiwi
 				token.wordPosition = wordPositions[token.position];
 				prevMorph = s.morph->kform;
 			}
-			rarr.erase(joinAffixTokens(rarr.begin(), rarr.end(), matchOptions), rarr.end());
+			rarr.erase(joinAffixTokens(rarr.begin(), rarr.end(), matchOptions, forms), rarr.end());
 			ret[validTarget].second += r.score;
 			spStatesByRet[validTarget] = r.curState;
 			spStateCnt[r.curState]++;
@@ -796,7 +1029,7 @@ namespace kiwi
 		iota(idx.begin(), idx.end(), 0);
 		sort(idx.begin(), idx.end(), [&](size_t a, size_t b) { return ret[a].second > ret[b].second; });
 		
-		Vector<TokenResult> sortedRet;
+		Vector<pair<vector<Token>, float>> sortedRet;
 		Vector<SpecialState> sortedSpStatesByRet;
 		const size_t maxCands = min(topN * 2, validTarget);
 		for (size_t i = 0; i < maxCands; ++i)
@@ -819,7 +1052,7 @@ namespace kiwi
 		const Vector<uint32_t>& positionTable, 
 		const KString& normStr,
 		FnFindForm findForm,
-		const utils::FrozenTrie<kchar_t, const Form*>& formTrie,
+		const FormTrie& formTrie,
 		const Form* formData
 	)
 	{
@@ -999,7 +1232,9 @@ namespace kiwi
 		ret.resize(nodes.size(), -1);
 	}
 
-	vector<TokenResult> Kiwi::analyze(const u16string& str, size_t topN, Match matchOptions, 
+	template<class TokenTy, class FormPool>
+	void Kiwi::_analyze(vector<pair<vector<TokenTy>, float>>& ret, FormPool& formPool,
+		const u16string& str, size_t topN, Match matchOptions, 
 		const std::unordered_set<const Morpheme*>* blocklist,
 		const std::vector<PretokenizedSpan>& pretokenized
 	) const
@@ -1007,12 +1242,32 @@ namespace kiwi
 		thread_local KString normalizedStr;
 		thread_local Vector<uint32_t> positionTable;
 		thread_local PretokenizedSpanGroup pretokenizedGroup;
+		// 분석이 끝날 때까지 오버레이가 해제되지 않도록 참조를 유지한다
+		const auto overlay = std::atomic_load(&userOverlay);
+		const uint64_t overlayGeneration = overlay ? overlay->getGeneration() : 0;
 		normalizedStr.clear();
 		positionTable.clear();
 		pretokenizedGroup.clear();
+
+		// 통계 집계가 꺼져 있으면 stats는 nullptr이고 시간 측정도 하지 않는다.
+		size_t* stats = collectStats ? localStats().data() : nullptr;
+		auto lapTime = chrono::steady_clock::now();
+		auto addLap = [&](StatCounter c)
+		{
+			const auto now = chrono::steady_clock::now();
+			stats[c] += chrono::duration_cast<chrono::nanoseconds>(now - lapTime).count();
+			lapTime = now;
+		};
+
 		normalizeHangulWithPosition(str.begin(), str.end(), back_inserter(normalizedStr), back_inserter(positionTable));
 
 		if (!!(matchOptions & Match::normalizeCoda)) normalizeCoda(normalizedStr.begin(), normalizedStr.end());
+		if (stats)
+		{
+			addLap(statNormalizeTime);
+			stats[statNumAnalyzed]++;
+			stats[statNumChars] += str.size();
+		}
 
 		makePretokenizedSpanGroup(
 			pretokenizedGroup, 
@@ -1020,8 +1275,8 @@ namespace kiwi
 			positionTable, 
 			normalizedStr, 
 			reinterpret_cast<FnFindForm>(dfFindForm), 
-			formTrie,
-			forms.data()
+			vocab->formTrie,
+			vocab->forms.data()
 		);
 
 		// 분석할 문장에 포함된 개별 문자에 대해 어절번호를 생성한다
@@ -1029,22 +1284,26 @@ namespace kiwi
 		wordPositions.clear();
 		getWordPositions(wordPositions, str.begin(), str.end());
 		
-		vector<TokenResult> ret;
 		Vector<SpecialState> spStatesByRet;
 		thread_local Vector<KGraphNode> nodes;
 		thread_local Vector<uint32_t> nodeInWhichPretokenized;
 		const auto* pretokenizedFirst = pretokenizedGroup.spans.data();
 		const auto* pretokenizedLast = pretokenizedFirst + pretokenizedGroup.spans.size();
+		// pretokenized 구간은 그래프에 위치 정보를 남기므로 조각 재사용에서 제외한다.
+		ChunkResultMemo* memo = (chunkMemoSize && pretokenizedGroup.spans.empty()) ? &ChunkResultMemo::local() : nullptr;
 		size_t splitEnd = 0;
 		while (splitEnd < normalizedStr.size())
 		{
 			nodes.clear();
 			auto* pretokenizedPrev = pretokenizedFirst;
+			const size_t splitStart = splitEnd;
+			if (stats) lapTime = chrono::steady_clock::now();
 			splitEnd = (*reinterpret_cast<FnSplitByTrie>(dfSplitByTrie))(
 				nodes,
-				forms.data(),
-				typoPtrs.data(),
-				formTrie,
+				vocab->forms.data(),
+				vocab->typoPtrs.data(),
+				vocab->formTrie,
+				overlay.get(),
 				U16StringView{ normalizedStr.data() + splitEnd, normalizedStr.size() - splitEnd },
 				splitEnd,
 				matchOptions,
@@ -1056,25 +1315,49 @@ namespace kiwi
 				pretokenizedLast
 			);
 
+			if (stats)
+			{
+				addLap(statSplitTime);
+				stats[statNumSplits]++;
+				stats[statNumNodes] += nodes.size();
+				stats[statNumTypoNodes] += count_if(nodes.begin(), nodes.end(), [](const KGraphNode& n) { return n.typoCost > 0; });
+			}
+
 			if (nodes.size() <= 2) continue;
 			findPretokenizedGroupOfNode(nodeInWhichPretokenized, nodes, pretokenizedPrev, pretokenizedFirst);
 
-			Vector<PathEvaluator::ChunkResult> res = (*reinterpret_cast<FnFindBestPath>(dfFindBestPath))(
-				this,
-				spStatesByRet,
-				nodes.data(),
-				nodes.size(),
-				topN,
-				false,
-				!!(matchOptions & Match::splitComplex),
-				!!(matchOptions & Match::splitSaisiot),
-				!!(matchOptions & Match::mergeSaisiot),
-				blocklist
-			);
-			insertPathIntoResults(ret, spStatesByRet, res, topN, matchOptions, integrateAllomorph, positionTable, wordPositions, pretokenizedGroup, nodeInWhichPretokenized);
+			Vector<PathEvaluator::ChunkResult> res;
+			if (memo)
+			{
+				memo->makeKey(instanceId, configVersion, overlayGeneration, topN, matchOptions, blocklist, spStatesByRet,
+					U16StringView{ normalizedStr.data() + splitStart, splitEnd - splitStart });
+			}
+			if (memo && memo->find(res, splitStart))
+			{
+				if (stats) stats[statNumMemoHits]++;
+			}
+			else
+			{
+				res = (*reinterpret_cast<FnFindBestPath>(dfFindBestPath))(
+					this,
+					spStatesByRet,
+					nodes.data(),
+					nodes.size(),
+					topN,
+					false,
+					!!(matchOptions & Match::splitComplex),
+					!!(matchOptions & Match::splitSaisiot),
+					!!(matchOptions & Match::mergeSaisiot),
+					blocklist
+				);
+				if (memo) memo->store(res, splitStart, chunkMemoSize);
+			}
+			if (stats) addLap(statPathTime);
+			insertPathIntoResults(ret, formPool, spStatesByRet, res, topN, matchOptions, integrateAllomorph, positionTable, wordPositions, pretokenizedGroup, nodeInWhichPretokenized, overlay.get());
+			if (stats) addLap(statInsertTime);
 		}
 
-		sort(ret.begin(), ret.end(), [](const TokenResult& a, const TokenResult& b)
+		sort(ret.begin(), ret.end(), [](const pair<vector<TokenTy>, float>& a, const pair<vector<TokenTy>, float>& b)
 		{
 			return a.second > b.second;
 		});
@@ -1083,17 +1366,144 @@ namespace kiwi
 		auto newlines = allNewLinePositions(str);
 		for (auto& r : ret)
 		{
-			fillPairedTokenInfo(r.first);
-			fillSentLineInfo(r.first, newlines);
+			fillPairedTokenInfo(r.first, formPool);
+			fillSentLineInfo(r.first, formPool, newlines);
 		}
+		if (stats) flushStats();
+	}
 
-		if (ret.empty()) ret.emplace_back();
+	void Kiwi::flushStats() const
+	{
+		auto& stats = localStats();
+		for (size_t i = 0; i < numStatCounters; ++i)
+		{
+			if (!stats[i]) continue;
+			statCounters[i].fetch_add(stats[i], memory_order_relaxed);
+			stats[i] = 0;
+		}
+	}
+
+	AnalyzeStats Kiwi::getStats() const
+	{
+		AnalyzeStats ret;
+		if (!statCounters) return ret;
+		auto get = [&](StatCounter c) { return statCounters[c].load(memory_order_relaxed); };
+		ret.numAnalyzed = get(statNumAnalyzed);
+		ret.numChars = get(statNumChars);
+		ret.normalizeTime = get(statNormalizeTime) / 1e9;
+		ret.splitTime = get(statSplitTime) / 1e9;
+		ret.pathTime = get(statPathTime) / 1e9;
+		ret.insertTime = get(statInsertTime) / 1e9;
+		ret.numSplits = get(statNumSplits);
+		ret.numNodes = get(statNumNodes);
+		ret.numTypoNodes = get(statNumTypoNodes);
+		ret.numPathsEvaluated = get(statNumPathsEvaluated);
+		ret.numPathsPruned = get(statNumPathsPruned);
+		ret.numLmCalls = get(statNumLmCalls);
+		ret.numMemoHits = get(statNumMemoHits);
+		ret.lmCache = getLmCacheStats();
+		ret.resultCache = getResultCacheStats();
+		return ret;
+	}
+
+	void Kiwi::resetStats()
+	{
+		if (!statCounters) return;
+		for (size_t i = 0; i < numStatCounters; ++i) statCounters[i].store(0, memory_order_relaxed);
+		resetLmCacheStats();
+		resetResultCacheStats();
+	}
+
+	vector<TokenResult> Kiwi::analyze(const u16string& str, size_t topN, Match matchOptions, 
+		const std::unordered_set<const Morpheme*>* blocklist,
+		const std::vector<PretokenizedSpan>& pretokenized
+	) const
+	{
+		u16string cacheKey;
+		if (resultCache)
+		{
+			const auto overlay = std::atomic_load(&userOverlay);
+			ResultCache::makeKey(cacheKey, str, topN, matchOptions, blocklist, pretokenized, configVersion, overlay ? overlay->getGeneration() : 0);
+			if (auto cached = resultCache->find(cacheKey)) return *cached;
+		}
+
+		vector<TokenResult> ret;
+		if (!(parallelChunkSize && pool && pool->size() > 1 && str.size() > parallelChunkSize && !pool->isWorkerThread()
+			&& analyzeSplitted(ret, str, topN, matchOptions, blocklist, pretokenized)))
+		{
+			OwnedTokenForms forms;
+			_analyze(ret, forms, str, topN, matchOptions, blocklist, pretokenized);
+			if (ret.empty()) ret.emplace_back();
+		}
+
+		if (resultCache)
+		{
+			resultCache->store(move(cacheKey), make_shared<const vector<TokenResult>>(ret));
+		}
 		return ret;
 	}
 
+	void Kiwi::setResultCacheSize(size_t v)
+	{
+		resultCacheSize = v;
+		if (v) resultCache = make_unique<ResultCache>(v);
+		else resultCache.reset();
+	}
+
+	ResultCacheStats Kiwi::getResultCacheStats() const
+	{
+		if (!resultCache) return {};
+		return resultCache->getStats();
+	}
+
+	void Kiwi::resetResultCacheStats()
+	{
+		if (resultCache) resultCache->resetStats();
+	}
+
+	ColumnarTokenResult& Kiwi::analyze(const u16string& str, ColumnarTokenResult& out, size_t topN, Match matchOptions,
+		const std::unordered_set<const Morpheme*>* blocklist,
+		const std::vector<PretokenizedSpan>& pretokenized
+	) const
+	{
+		thread_local u16string formBuf;
+		thread_local vector<pair<vector<PooledTokenInfo>, float>> ret;
+		formBuf.clear();
+		ret.clear();
+		PooledTokenForms forms{ formBuf };
+		_analyze(ret, forms, str, topN, matchOptions, blocklist, pretokenized);
+		if (ret.empty()) ret.emplace_back();
+
+		for (auto& r : ret)
+		{
+			for (auto& t : r.first)
+			{
+				out.formPool.append(formBuf, t.formBegin, t.formSize);
+				out.formOffsets.emplace_back((uint32_t)out.formPool.size());
+				out.positions.emplace_back(t.position);
+				out.wordPositions.emplace_back(t.wordPosition);
+				out.sentPositions.emplace_back(t.sentPosition);
+				out.lineNumbers.emplace_back(t.lineNumber);
+				out.lengths.emplace_back(t.length);
+				out.tags.emplace_back(t.tag);
+				out.senseIds.emplace_back(t.senseId);
+				out.scores.emplace_back(t.score);
+				out.typoCosts.emplace_back(t.typoCost);
+				out.typoFormIds.emplace_back(t.typoFormId);
+				out.pairedTokens.emplace_back(t.pairedToken);
+				out.subSentPositions.emplace_back(t.subSentPosition);
+				out.morphs.emplace_back(t.morph);
+			}
+			out.resultOffsets.emplace_back((uint32_t)out.numTokens());
+			out.resultScores.emplace_back(r.second);
+		}
+		out.inputOffsets.emplace_back((uint32_t)out.numResults());
+		return out;
+	}
+
 	const Morpheme* Kiwi::getDefaultMorpheme(POSTag tag) const
 	{
-		return &morphemes[getDefaultMorphemeId(tag)];
+		return &vocab->morphemes[getDefaultMorphemeId(tag)];
 	}
 
 	template<class Str, class Pretokenized, class ...Rest>
@@ -1197,6 +1607,414 @@ namespace kiwi
 		return _asyncAnalyzeEcho(move(str), move(pretokenized), matchOptions, blocklist);
 	}
 
+	inline bool isSentenceFinal(char16_t c)
+	{
+		switch (c)
+		{
+		case u'.':
+		case u'?':
+		case u'!':
+		case u'\u2026':
+		case u'\u3002':
+		case u'\uFF01':
+		case u'\uFF0E':
+		case u'\uFF1F':
+			return true;
+		}
+		return false;
+	}
+
+	void Kiwi::updateSentEndingSyllables()
+	{
+		sentEndingSyllables.clear();
+		sentEndingSyllables.resize((0xD7A4 - 0xAC00 + 63) / 64);
+		auto mark = [&](char16_t c)
+		{
+			const size_t i = c - 0xAC00;
+			sentEndingSyllables[i / 64] |= (uint64_t)1 << (i % 64);
+		};
+
+		// 종결어미 뒤에 붙는 보조사 '요'
+		mark(u'요');
+		for (auto& m : vocab->morphemes)
+		{
+			if (clearIrregular(m.tag) != POSTag::ef || !m.kform || m.kform->empty()) continue;
+			const auto& form = *m.kform;
+			const char16_t last = form.back();
+			if (isHangulSyllable(last))
+			{
+				mark(last);
+			}
+			else if (isHangulCoda(last))
+			{
+				// 형태는 받침이 분리된 상태로 저장되어 있으므로 앞 음절과 다시 합쳐준다.
+				const char16_t coda = last - 0x11A7;
+				if (form.size() >= 2 && isHangulSyllable(form[form.size() - 2]))
+				{
+					mark(form[form.size() - 2] + coda);
+				}
+				else
+				{
+					for (char16_t c = 0xAC00 + coda; c < 0xD7A4; c += 28) mark(c);
+				}
+			}
+		}
+	}
+
+	/**
+	* @brief str[begin:end]의 어절이 문장의 끝이 될 수 있는지 여부를 반환한다.
+	* @details 종결 부호를 포함하거나, 마지막 한글 음절이 종결어미(+받침)로 끝날 수 있는 경우 후보가 된다.
+	*/
+	bool Kiwi::mayEndSentence(const u16string& str, size_t begin, size_t end) const
+	{
+		auto test = [&](char16_t c)
+		{
+			const size_t i = c - 0xAC00;
+			return !!(sentEndingSyllables[i / 64] & ((uint64_t)1 << (i % 64)));
+		};
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (isSentenceFinal(str[i])) return true;
+		}
+
+		for (size_t i = end; i > begin; --i)
+		{
+			const char16_t c = str[i - 1];
+			if (!isHangulSyllable(c)) continue;
+			return test(c) || test(c - (c - 0xAC00) % 28);
+		}
+		return false;
+	}
+
+	vector<pair<size_t, size_t>> Kiwi::splitIntoSentsFast(const u16string& str, Match matchOptions) const
+	{
+		struct Eojeol
+		{
+			size_t begin, end;
+			bool candidate;
+		};
+
+		vector<Eojeol> eojeols;
+		for (size_t i = 0; i < str.size();)
+		{
+			while (i < str.size() && isSpace(str[i])) ++i;
+			if (i >= str.size()) break;
+			const size_t b = i;
+			while (i < str.size() && !isSpace(str[i])) ++i;
+			eojeols.emplace_back(Eojeol{ b, i, mayEndSentence(str, b, i) });
+		}
+
+		vector<pair<size_t, size_t>> ret;
+		if (eojeols.empty()) return ret;
+
+		const auto newlines = allNewLinePositions(str);
+		auto lineOf = [&](size_t pos)
+		{
+			return (size_t)(lower_bound(newlines.begin(), newlines.end(), pos) - newlines.begin());
+		};
+
+		// 새 문장이 시작하는 위치들
+		vector<size_t> boundaries;
+		for (size_t k = 1; k < eojeols.size(); ++k)
+		{
+			if (lineOf(eojeols[k].begin) > lineOf(eojeols[k - 1].end) + 1) boundaries.emplace_back(eojeols[k].begin);
+		}
+
+		// 경계 후보 어절과 그 앞뒤 어절만 분석하여 fillSentLineInfo와 같은 규칙으로 경계를 찾는다.
+		// 인접한 후보들의 구간이 겹치면 하나로 합쳐서 분석한다.
+		for (size_t k = 0; k < eojeols.size();)
+		{
+			if (!eojeols[k].candidate)
+			{
+				++k;
+				continue;
+			}
+			size_t last = k;
+			for (size_t j = k + 1; j < eojeols.size() && j <= last + 2; ++j)
+			{
+				if (eojeols[j].candidate) last = j;
+			}
+
+			const size_t wb = eojeols[k > 0 ? k - 1 : k].begin;
+			const size_t we = eojeols[min(last + 1, eojeols.size() - 1)].end;
+			auto tokens = analyze(str.substr(wb, we - wb), matchOptions).first;
+			SentenceParser sp;
+			for (size_t i = 0; i < tokens.size(); ++i)
+			{
+				if (!sp.next(tokens[i], lineOf(wb + tokens[i].position))) continue;
+				size_t p = tokens[i].position;
+				const bool includePrevToken = i > 1 &&
+					(tokens[i - 1].tag == POSTag::so
+						|| tokens[i - 1].tag == POSTag::sw
+						|| tokens[i - 1].tag == POSTag::sp
+						|| tokens[i - 1].tag == POSTag::se
+						|| tokens[i - 1].tag == POSTag::sso)
+					&& tokens[i - 1].endPos() == tokens[i].position
+					&& tokens[i - 1].position > tokens[i - 2].endPos();
+				if (includePrevToken) p = tokens[i - 1].position;
+				if (p > 0) boundaries.emplace_back(wb + p);
+			}
+			k = last + 1;
+		}
+
+		// 조사나 어미 등과 붙어서 문장 안에 포함된 괄호 및 따옴표 안쪽에서는 문장을 나누지 않는다.
+		vector<pair<size_t, size_t>> nested;
+		{
+			vector<pair<size_t, size_t>> stack;
+			for (size_t i = 0; i < str.size(); ++i)
+			{
+				const size_t type = getSSType(str[i]);
+				if (!type || str[i] == u'\'') continue;
+				const POSTag tag = identifySpecialChr(str[i]);
+				if (tag == POSTag::ssc || (tag == POSTag::ss && !stack.empty() && stack.back().second == type))
+				{
+					auto it = find_if(stack.rbegin(), stack.rend(), [&](const pair<size_t, size_t>& p) { return p.second == type; });
+					if (it == stack.rend()) continue;
+					const size_t open = it->first;
+					stack.erase(it.base() - 1, stack.end());
+
+					const bool nestedLeft = open > 0 && (isHangulSyllable(str[open - 1]) || str[open - 1] == u',');
+					const bool nestedRight = i + 1 < str.size() && isHangulSyllable(str[i + 1]);
+					if (nestedLeft || nestedRight)
+					{
+						size_t after = i + 1;
+						while (after < str.size() && isSpace(str[after])) ++after;
+						nested.emplace_back(open, after);
+					}
+				}
+				else if (tag == POSTag::sso || tag == POSTag::ss)
+				{
+					stack.emplace_back(i, type);
+				}
+			}
+		}
+
+		sort(boundaries.begin(), boundaries.end());
+		boundaries.erase(unique(boundaries.begin(), boundaries.end()), boundaries.end());
+		boundaries.erase(remove_if(boundaries.begin(), boundaries.end(), [&](size_t p)
+		{
+			return any_of(nested.begin(), nested.end(), [&](const pair<size_t, size_t>& n)
+			{
+				return n.first < p && p <= n.second;
+			});
+		}), boundaries.end());
+
+		// 경계 사이의 공백을 제외한 구간을 문장으로 반환한다.
+		size_t b = 0;
+		for (size_t i = 0; i <= boundaries.size(); ++i)
+		{
+			const size_t e = i < boundaries.size() ? boundaries[i] : str.size();
+			size_t sb = b, se = e;
+			while (sb < se && isSpace(str[sb])) ++sb;
+			while (se > sb && isSpace(str[se - 1])) --se;
+			if (sb < se) ret.emplace_back(sb, se);
+			b = e;
+		}
+		return ret;
+	}
+
+	vector<pair<size_t, size_t>> Kiwi::splitIntoSentsFast(const string& str, Match matchOptions) const
+	{
+		vector<size_t> bytePositions;
+		u16string u16str = utf8To16(str, bytePositions);
+		bytePositions.emplace_back(str.size());
+		vector<pair<size_t, size_t>> ret = splitIntoSentsFast(u16str, matchOptions);
+		for (auto& r : ret)
+		{
+			r.first = bytePositions[r.first];
+			r.second = bytePositions[r.second];
+		}
+		return ret;
+	}
+
+	vector<size_t> Kiwi::findSplitPoints(const u16string& str, size_t chunkSize)
+	{
+		vector<size_t> ret{ 0 };
+		if (!chunkSize) return ret;
+
+		size_t begin = 0;
+		while (str.size() - begin > chunkSize)
+		{
+			const size_t target = begin + chunkSize, lowest = begin + chunkSize / 2;
+			size_t found = 0, fallback = 0;
+			// 목표 위치에서부터 거꾸로 올라가며 공백 다음에 오는 어절의 시작 위치를 찾는다.
+			for (size_t q = target; q > lowest; --q)
+			{
+				if (!isSpace(str[q - 1]) || isSpace(str[q])) continue;
+				size_t p = q - 1, numNewlines = 0;
+				while (p > begin && isSpace(str[p - 1])) --p;
+				for (size_t i = p; i < q; ++i) numNewlines += str[i] == u'\n';
+				if (numNewlines >= 2 || (p > begin && isSentenceFinal(str[p - 1])))
+				{
+					found = q;
+					break;
+				}
+				if (!fallback) fallback = q;
+			}
+			if (!found) found = fallback;
+			if (!found)
+			{
+				for (size_t q = target + 1; q < str.size(); ++q)
+				{
+					if (isSpace(str[q - 1]) && !isSpace(str[q]))
+					{
+						found = q;
+						break;
+					}
+				}
+				if (!found) break;
+			}
+			ret.emplace_back(found);
+			begin = found;
+		}
+		return ret;
+	}
+
+	void Kiwi::mergeSplitResults(vector<TokenResult>& out, vector<vector<TokenResult>>& parts,
+		const u16string& str, const vector<size_t>& splitPoints)
+	{
+		const auto newlines = allNewLinePositions(str);
+		size_t numResults = 0;
+		for (auto& p : parts) numResults = max(numResults, p.size());
+		out.clear();
+		out.resize(numResults);
+		for (size_t k = 0; k < numResults; ++k)
+		{
+			auto& dest = out[k];
+			uint32_t sentBase = 0;
+			for (size_t c = 0; c < parts.size(); ++c)
+			{
+				if (parts[c].empty()) continue;
+				// 결과가 topN보다 적은 조각은 마지막 결과를 반복하여 사용한다.
+				const size_t j = min(k, parts[c].size() - 1);
+				const bool lastUse = j + 1 < parts[c].size() || k + 1 == numResults;
+				auto& src = parts[c][j];
+				const uint32_t offset = (uint32_t)splitPoints[c];
+				const uint32_t lineBase = (uint32_t)(lower_bound(newlines.begin(), newlines.end(), splitPoints[c]) - newlines.begin());
+				const uint32_t tokenBase = (uint32_t)dest.first.size();
+				for (auto& t : src.first)
+				{
+					dest.first.emplace_back(lastUse ? move(t) : t);
+					auto& nt = dest.first.back();
+					// wordPosition은 문장 안에서의 어절 번호이고, 각 조각은 sentBase에서 새 문장으로 시작하므로 그대로 둔다.
+					nt.position += offset;
+					nt.sentPosition += sentBase;
+					nt.lineNumber += lineBase;
+					if (nt.pairedToken != (uint32_t)-1) nt.pairedToken += tokenBase;
+				}
+				dest.second += src.second;
+				if (dest.first.size() > tokenBase) sentBase = dest.first.back().sentPosition + 1;
+			}
+		}
+	}
+
+	bool Kiwi::analyzeSplitted(vector<TokenResult>& out, const u16string& str, size_t topN, Match matchOptions,
+		const unordered_set<const Morpheme*>* blocklist,
+		const vector<PretokenizedSpan>& pretokenized
+	) const
+	{
+		auto splitPoints = findSplitPoints(str, parallelChunkSize);
+		// 사전 분석된 구간의 안쪽에서는 자르지 않는다.
+		if (!pretokenized.empty())
+		{
+			splitPoints.erase(remove_if(splitPoints.begin() + 1, splitPoints.end(), [&](size_t p)
+			{
+				return any_of(pretokenized.begin(), pretokenized.end(), [&](const PretokenizedSpan& s)
+				{
+					return s.begin < p && p < s.end;
+				});
+			}), splitPoints.end());
+		}
+		if (splitPoints.size() <= 1) return false;
+
+		const size_t numParts = splitPoints.size();
+		vector<vector<PretokenizedSpan>> subPretokenized(numParts);
+		for (auto& s : pretokenized)
+		{
+			const size_t i = (upper_bound(splitPoints.begin(), splitPoints.end(), (size_t)s.begin) - splitPoints.begin()) - 1;
+			subPretokenized[i].emplace_back(s);
+			subPretokenized[i].back().begin -= splitPoints[i];
+			subPretokenized[i].back().end -= splitPoints[i];
+		}
+
+		vector<vector<TokenResult>> parts(numParts);
+		utils::parallelFor(pool.get(), 0, numParts, [&](size_t, size_t i)
+		{
+			const size_t b = splitPoints[i];
+			const size_t e = i + 1 < numParts ? splitPoints[i + 1] : str.size();
+			// 작업자 스레드 안에서 호출되므로 다시 나누어지지 않는다.
+			parts[i] = analyze(str.substr(b, e - b), topN, matchOptions, blocklist, subPretokenized[i]);
+		}, 1);
+
+		// 사전 분석된 구간의 ID는 시작 위치 순으로 매겨지므로 앞선 조각들에 포함된 구간의 개수만큼 더해준다.
+		uint32_t ptBase = 0;
+		for (size_t i = 0; i < numParts; ++i)
+		{
+			if (ptBase)
+			{
+				for (auto& r : parts[i])
+				{
+					for (auto& t : r.first)
+					{
+						if (t.typoCost == 0 && t.typoFormId) t.typoFormId += ptBase;
+					}
+				}
+			}
+			ptBase += (uint32_t)subPretokenized[i].size();
+		}
+		mergeSplitResults(out, parts, str, splitPoints);
+		return true;
+	}
+
+	ColumnarTokenResult Kiwi::analyzeBatch(const vector<u16string>& strs, size_t topN, Match matchOptions,
+		const unordered_set<const Morpheme*>* blocklist
+	) const
+	{
+		const auto analyzeRange = [&](size_t first, size_t last, ColumnarTokenResult& out)
+		{
+			size_t chars = 0;
+			for (size_t i = first; i < last; ++i) chars += strs[i].size();
+			out.reserve(chars * topN / 2, chars * topN);
+			for (size_t i = first; i < last; ++i)
+			{
+				analyze(strs[i], out, topN, matchOptions, blocklist);
+			}
+		};
+
+		ColumnarTokenResult ret;
+		// 작업자 스레드에서 호출된 경우 조각들을 기다리다 작업자가 모두 막힐 수 있으므로 직접 처리한다.
+		if (!pool || strs.size() <= 1 || pool->isWorkerThread())
+		{
+			analyzeRange(0, strs.size(), ret);
+			return ret;
+		}
+
+		// 작업량 편차를 줄이기 위해 작업자 수보다 많은 조각으로 나눈다.
+		const size_t numShards = std::min(strs.size(), pool->size() * 4);
+		vector<ColumnarTokenResult> shards(numShards);
+		utils::WaitGroup wg{ numShards };
+		for (size_t s = 0; s < numShards; ++s)
+		{
+			const size_t first = strs.size() * s / numShards, last = strs.size() * (s + 1) / numShards;
+			pool->submit([&, s, first, last](size_t)
+			{
+				wg.run([&]() { analyzeRange(first, last, shards[s]); });
+			});
+		}
+		wg.wait();
+
+		size_t tokens = 0, chars = 0;
+		for (size_t s = 0; s < numShards; ++s)
+		{
+			tokens += shards[s].numTokens();
+			chars += shards[s].formPool.size();
+		}
+		ret.reserve(tokens, chars);
+		for (auto& shard : shards) ret.append(shard);
+		return ret;
+	}
+
 	using FnNewAutoJoiner = cmb::AutoJoiner(Kiwi::*)() const;
 
 	template<template<ArchType> class LmState>
@@ -1333,15 +2151,15 @@ namespace kiwi
 
 	u16string Kiwi::getTypoForm(size_t typoFormId) const
 	{
-		if (typoFormId >= typoPtrs.size()) return {};
-		const size_t* p = &typoPtrs[typoFormId];
-		return joinHangul(typoPool.begin() + p[0], typoPool.begin() + p[1]);
+		if (typoFormId >= vocab->typoPtrs.size()) return {};
+		const size_t* p = &vocab->typoPtrs[typoFormId];
+		return joinHangul(vocab->typoPool.begin() + p[0], vocab->typoPool.begin() + p[1]);
 	}
 
 	void Kiwi::findMorpheme(vector<const Morpheme*>& ret, const u16string& s, POSTag tag) const
 	{
 		auto normalized = normalizeHangul(s);
-		auto form = (*reinterpret_cast<FnFindForm>(dfFindForm))(formTrie, forms.data(), normalized);
+		auto form = (*reinterpret_cast<FnFindForm>(dfFindForm))(vocab->formTrie, vocab->forms.data(), normalized);
 		if (!form) return;
 		tag = clearIrregular(tag);
 		for (auto c : form->candidate)
@@ -1360,4 +2178,138 @@ namespace kiwi
 		findMorpheme(ret, s, tag);
 		return ret;
 	}
+
+	shared_ptr<const UserOverlay> Kiwi::makeUserOverlay(vector<UserOverlay::Word> words) const
+	{
+		static atomic<uint64_t> lastGeneration{ 0 };
+
+		// 같은 형태와 품사의 단어는 마지막 것만 남기고, 트라이 구축을 위해 형태 순으로 정렬한다
+		std::map<pair<KString, POSTag>, size_t> uniqWords;
+		for (size_t i = 0; i < words.size(); ++i)
+		{
+			auto& w = words[i];
+			if (w.form.empty()) throw invalid_argument{ "`form` of a user word must not be empty." };
+			if (any_of(w.form.begin(), w.form.end(), [](char16_t c) { return isSpace(c); }))
+				throw invalid_argument{ "`form` of a user word must not contain spaces: " + utf16To8(w.form) };
+			const POSTag tag = clearIrregular(w.tag);
+			if (tag == POSTag::unknown || tag >= POSTag::p || isVerbClass(tag))
+				throw invalid_argument{ string{ "unsupported tag for a user word: " } + tagToString(w.tag) };
+			uniqWords[make_pair(normalizeHangul(w.form), w.tag)] = i;
+		}
+
+		auto ret = make_shared<UserOverlay>();
+		ret->arch = selectedArch;
+		ret->generation = ++lastGeneration;
+		ret->words.reserve(uniqWords.size());
+
+		size_t numForms = 0, numChrs = 0;
+		for (auto it = uniqWords.begin(); it != uniqWords.end(); ++it)
+		{
+			if (it == uniqWords.begin() || prev(it)->first.first != it->first.first)
+			{
+				++numForms;
+				numChrs += it->first.first.size();
+			}
+		}
+		// 형태소와 형태가 서로의 주소를 참조하므로 재할당이 일어나지 않도록 미리 공간을 확보한다
+		ret->forms.reserve(numForms);
+		ret->morphemes.reserve(uniqWords.size());
+
+		utils::ContinuousTrie<KTrie> trie{ 1 };
+		trie.reserveMore(numChrs);
+		decltype(trie)::CacheStore<KString> cache;
+		for (auto it = uniqWords.begin(); it != uniqWords.end();)
+		{
+			auto last = it;
+			while (last != uniqWords.end() && last->first.first == it->first.first) ++last;
+
+			ret->forms.emplace_back();
+			auto& form = ret->forms.back();
+			form.form = it->first.first;
+			form.zCodaAppendable = 0;
+			form.zSiotAppendable = 0;
+			form.candidate = FixedVector<const Morpheme*>{ (size_t)distance(it, last) };
+			for (size_t i = 0; it != last; ++it, ++i)
+			{
+				const auto& w = words[it->second];
+				ret->morphemes.emplace_back();
+				auto& morph = ret->morphemes.back();
+				morph.kform = &form.form;
+				morph.tag = w.tag;
+				morph.vowel = CondVowel::none;
+				morph.polar = CondPolarity::none;
+				morph.complex = 0;
+				morph.saisiot = 0;
+				morph.userScore = w.score;
+				morph.lmMorphemeId = getDefaultMorphemeId(w.tag);
+				form.candidate[i] = &morph;
+				ret->words.emplace_back(move(words[it->second]));
+			}
+			trie.buildWithCaching(form.form, &form, cache);
+		}
+		ret->trie = utils::freezeTrieAs<FormTrie>(move(trie), selectedArch);
+		return ret;
+	}
+
+	void Kiwi::setUserOverlay(shared_ptr<const UserOverlay> overlay)
+	{
+		if (overlay && overlay->archType() != selectedArch)
+		{
+			throw invalid_argument{ "`overlay` was made for a different ArchType." };
+		}
+		atomic_store(&userOverlay, move(overlay));
+	}
+
+	shared_ptr<const UserOverlay> Kiwi::getUserOverlay() const
+	{
+		return atomic_load(&userOverlay);
+	}
+
+	size_t Kiwi::addUserWords(const vector<UserOverlay::Word>& words)
+	{
+		auto prevOverlay = atomic_load(&userOverlay);
+		while (1)
+		{
+			vector<UserOverlay::Word> merged;
+			if (prevOverlay) merged = prevOverlay->getWords();
+			merged.insert(merged.end(), words.begin(), words.end());
+			auto newOverlay = makeUserOverlay(move(merged));
+			const size_t prevSize = prevOverlay ? prevOverlay->size() : 0;
+			const size_t added = newOverlay->size() - prevSize;
+			// 다른 스레드가 먼저 교체했다면 그 결과 위에 다시 쌓는다
+			if (atomic_compare_exchange_strong(&userOverlay, &prevOverlay, shared_ptr<const UserOverlay>{ move(newOverlay) }))
+			{
+				return added;
+			}
+		}
+	}
+
+	Kiwi Kiwi::clone() const
+	{
+		Kiwi ret{ selectedArch, langMdl, isTypoTolerant(), isfinite(continualTypoCost), isfinite(lengtheningTypoCost) };
+		ret.vocab = vocab;
+		ret.combiningRule = combiningRule;
+		ret.pool = pool;
+		ret.tagScorer = tagScorer;
+		ret.specialMorphIds = specialMorphIds;
+		ret.sentEndingSyllables = sentEndingSyllables;
+		ret.userOverlay = getUserOverlay();
+
+		ret.integrateAllomorph = integrateAllomorph;
+		ret.cutOffThreshold = cutOffThreshold;
+		ret.unkFormScoreScale = unkFormScoreScale;
+		ret.unkFormScoreBias = unkFormScoreBias;
+		ret.spacePenalty = spacePenalty;
+		ret.typoCostWeight = typoCostWeight;
+		ret.continualTypoCost = continualTypoCost;
+		ret.lengtheningTypoCost = lengtheningTypoCost;
+		ret.maxUnkFormSize = maxUnkFormSize;
+		ret.spaceTolerance = spaceTolerance;
+		ret.parallelChunkSize = parallelChunkSize;
+		ret.lmCacheSize = lmCacheSize;
+		ret.collectStats = collectStats;
+		ret.chunkMemoSize = chunkMemoSize;
+		ret.setResultCacheSize(resultCacheSize);
+		return ret;
+	}
 }
@@ -771,7 +771,7 @@ void KiwiBuilder::saveMorphBin(std::ostream& os) const
 }
 
 KiwiBuilder::KiwiBuilder(const string& modelPath, size_t _numThreads, BuildOption _options, bool useSBG) 
-	: detector{ modelPath, _numThreads }, options{ _options }, numThreads{ _numThreads ? _numThreads : thread::hardware_concurrency() }
+	: detector{ modelPath, _numThreads }, options{ _options }, numThreads{ _numThreads }
 {
 	archType = getSelectedArch(ArchType::default_);
 
@@ -895,14 +895,13 @@ KiwiBuilder::KiwiBuilder(const ModelBuildArgs& args)
 	}
 
 	vector<pair<uint16_t, uint16_t>> bigramList;
-	utils::ThreadPool pool;
+	shared_ptr<utils::ThreadPool> pool;
 	if (args.numWorkers > 1)
 	{
-		pool.~ThreadPool();
-		new (&pool) utils::ThreadPool{ args.numWorkers };
+		pool = utils::acquireThreadPool(args.numWorkers);
 	}
 	size_t lmMinCnt = *std::min(args.lmMinCnts.begin(), args.lmMinCnts.end());
-	auto cntNodes = utils::count(sents.begin(), sents.end(), lmMinCnt, 1, args.lmOrder, (args.numWorkers > 1 ? &pool : nullptr), &bigramList, args.useLmTagHistory ? &historyTx : nullptr);
+	auto cntNodes = utils::count(sents.begin(), sents.end(), lmMinCnt, 1, args.lmOrder, pool.get(), &bigramList, args.useLmTagHistory ? &historyTx : nullptr);
 	// discount for bos node cnt
 	if (args.useLmTagHistory)
 	{
@@ -1158,12 +1157,19 @@ KiwiBuilder::KiwiBuilder(const string& modelPath, const ModelBuildArgs& args)
 	}
 }
 
-void KiwiBuilder::saveModel(const string& modelPath) const
+void KiwiBuilder::saveModel(const string& modelPath, bool mappableLm, ArchType lmLayout) const
 {
 	{
 		ofstream ofs{ modelPath + "/sj.morph", ios_base::binary };
 		saveMorphBin(ofs);
 	}
+	if (mappableLm)
+	{
+		auto mem = langMdl.knlm->exportMappedLayout(lmLayout);
+		ofstream ofs{ modelPath + "/sj.knlm", ios_base::binary };
+		ofs.write((const char*)mem.get(), mem.size());
+	}
+	else
 	{
 		auto mem = langMdl.knlm->getMemory();
 		ofstream ofs{ modelPath + "/sj.knlm", ios_base::binary };
@@ -1892,6 +1898,91 @@ namespace kiwi
 		return false;
 	}
 
+	/**
+	 * 정렬된 키들을 순서대로 삽입하는 데에 필요한 노드 수를 센다.
+	 */
+	template<class KeyFn>
+	inline size_t countSortedTrieNodes(size_t first, size_t last, KeyFn&& getKey)
+	{
+		size_t ret = 0;
+		const KString* prev = nullptr;
+		for (size_t i = first; i < last; ++i)
+		{
+			const KString& key = getKey(i);
+			size_t commonPrefix = 0;
+			if (prev)
+			{
+				while (commonPrefix < std::min(prev->size(), key.size())
+					&& (*prev)[commonPrefix] == key[commonPrefix]) ++commonPrefix;
+			}
+			ret += key.size() - commonPrefix;
+			prev = &key;
+		}
+		return ret;
+	}
+
+	/**
+	 * 사전순으로 정렬된 키들을 formTrie에 삽입한다.
+	 * 정렬된 키들은 첫 글자가 같은 것끼리 연속해 있고, 이들이 만드는 노드들 역시 연속된 구간을 차지하므로
+	 * pool이 주어지면 첫 글자별로 별도의 트라이를 만들어 순서대로 이어붙인다. 결과는 하나씩 삽입한 것과 노드 배치까지 같다.
+	 */
+	template<class KeyFn, class ValueFn>
+	inline void buildSortedTrie(utils::ContinuousTrie<KTrie>& formTrie, size_t numKeys, KeyFn&& getKey, ValueFn&& getValue, utils::ThreadPool* pool)
+	{
+		using Trie = utils::ContinuousTrie<KTrie>;
+
+		Vector<size_t> runs;
+		bool partitionable = pool && pool->size() > 1;
+		for (size_t i = 0; partitionable && i < numKeys; ++i)
+		{
+			const KString& key = getKey(i);
+			if (key.empty())
+			{
+				partitionable = false;
+			}
+			else if (i == 0 || getKey(i - 1)[0] != key[0])
+			{
+				if (i > 0 && getKey(i - 1)[0] > key[0]) partitionable = false;
+				runs.emplace_back(i);
+			}
+		}
+		runs.emplace_back(numKeys);
+
+		if (!partitionable || runs.size() <= 2)
+		{
+			formTrie.reserveMore(countSortedTrieNodes(0, numKeys, getKey));
+			Trie::CacheStore<const KString*> cache;
+			for (size_t i = 0; i < numKeys; ++i)
+			{
+				formTrie.buildWithCaching(getKey(i), getValue(i), cache);
+			}
+			return;
+		}
+
+		// 각 부분 트라이의 0번 노드는 formTrie의 루트 역할만 하고 버려진다.
+		Vector<Trie> parts(runs.size() - 1);
+		utils::parallelFor(pool, 0, parts.size(), [&](size_t, size_t r)
+		{
+			auto& part = parts[r];
+			part = Trie{ 1, countSortedTrieNodes(runs[r], runs[r + 1], getKey) + 1 };
+			Trie::CacheStore<const KString*> cache;
+			for (size_t i = runs[r]; i < runs[r + 1]; ++i)
+			{
+				part.buildWithCaching(getKey(i), getValue(i), cache);
+			}
+		}, 1);
+
+		size_t totalNodes = 0;
+		for (auto& part : parts) totalNodes += part.size() - 1;
+		formTrie.reserveMore(totalNodes);
+		for (size_t r = 0; r < parts.size(); ++r)
+		{
+			const size_t offset = formTrie.append(move(parts[r]), 1);
+			formTrie.root().next[getKey(runs[r])[0]] = (int32_t)offset;
+			parts[r] = Trie{};
+		}
+	}
+
 	inline bool testSpeicalChr(const u16string& form)
 	{
 		POSTag pos;
@@ -1923,6 +2014,7 @@ namespace kiwi
 Kiwi KiwiBuilder::build(const TypoTransformer& typos, float typoCostThreshold) const
 {
 	Kiwi ret{ archType, langMdl, !typos.empty(), typos.isContinualTypoEnabled(), typos.isLengtheningTypoEnabled()};
+	auto vocab = make_shared<Kiwi::Vocab>();
 
 	Vector<FormRaw> combinedForms;
 	Vector<MorphemeRaw> combinedMorphemes;
@@ -1931,73 +2023,65 @@ Kiwi KiwiBuilder::build(const TypoTransformer& typos, float typoCostThreshold) c
 
 	buildCombinedMorphemes(combinedForms, newFormMap, combinedMorphemes, newFormCands);
 
-	ret.forms.reserve(forms.size() + combinedForms.size() + 1);
-	ret.morphemes.reserve(morphemes.size() + combinedMorphemes.size());
+	vocab->forms.reserve(forms.size() + combinedForms.size() + 1);
+	vocab->morphemes.reserve(morphemes.size() + combinedMorphemes.size());
 	ret.combiningRule = combiningRule;
 	ret.integrateAllomorph = !!(options & BuildOption::integrateAllomorph);
-	if (numThreads > 1)
-	{
-		ret.pool = make_unique<utils::ThreadPool>(numThreads);
-	}
-
-	for (auto& f : forms)
-	{
-		auto it = newFormCands.find(ret.forms.size());
-		bool zCodaAppendable = isZCodaAppendable(f.form, f.candidate, morphemes, combinedMorphemes);
-		bool zSiotAppendable = isZSiotAppendable(f.form, f.candidate, morphemes, combinedMorphemes);
-		if (it == newFormCands.end())
-		{
-			ret.forms.emplace_back(bake(f, ret.morphemes.data(), zCodaAppendable, zSiotAppendable));
-		}
-		else
-		{
-			zCodaAppendable = zCodaAppendable || isZCodaAppendable(f.form, it->second, morphemes, combinedMorphemes);
-			zSiotAppendable = zSiotAppendable || isZSiotAppendable(f.form, it->second, morphemes, combinedMorphemes);
-			ret.forms.emplace_back(bake(f, ret.morphemes.data(), zCodaAppendable, zSiotAppendable, it->second));
-		}
-		
-	}
-	for (auto& f : combinedForms)
-	{
-		bool zCodaAppendable = isZCodaAppendable(f.form, f.candidate, morphemes, combinedMorphemes)
-			|| isZCodaAppendable(f.form, newFormCands[ret.forms.size()], morphemes, combinedMorphemes);
-		bool zSiotAppendable = isZSiotAppendable(f.form, f.candidate, morphemes, combinedMorphemes)
-			|| isZSiotAppendable(f.form, newFormCands[ret.forms.size()], morphemes, combinedMorphemes);
-		ret.forms.emplace_back(bake(f, ret.morphemes.data(), zCodaAppendable, zSiotAppendable, newFormCands[ret.forms.size()]));
-	}
-
-	Vector<size_t> newFormIdMapper(ret.forms.size());
+	// 0이면 공용 스레드 풀을 사용한다
+	if (numThreads != 1)
+	{
+		ret.pool = utils::acquireThreadPool(numThreads);
+		if (ret.pool->size() <= 1) ret.pool.reset();
+	}
+	utils::ThreadPool* buildPool = ret.pool.get();
+
+	// 형태소 배열은 아직 비어 있지만 공간을 미리 확보해두었으므로 bake된 후보 포인터는 유효하다.
+	vocab->forms.resize(forms.size() + combinedForms.size());
+	const Vector<uint32_t> emptyCands;
+	utils::parallelFor(buildPool, 0, vocab->forms.size(), [&](size_t, size_t i)
+	{
+		const FormRaw& f = i < forms.size() ? forms[i] : combinedForms[i - forms.size()];
+		auto it = newFormCands.find(i);
+		const auto& cands = it == newFormCands.end() ? emptyCands : it->second;
+		const bool zCodaAppendable = isZCodaAppendable(f.form, f.candidate, morphemes, combinedMorphemes)
+			|| isZCodaAppendable(f.form, cands, morphemes, combinedMorphemes);
+		const bool zSiotAppendable = isZSiotAppendable(f.form, f.candidate, morphemes, combinedMorphemes)
+			|| isZSiotAppendable(f.form, cands, morphemes, combinedMorphemes);
+		vocab->forms[i] = bake(f, vocab->morphemes.data(), zCodaAppendable, zSiotAppendable, cands);
+	}, 1024);
+
+	Vector<size_t> newFormIdMapper(vocab->forms.size());
 	iota(newFormIdMapper.begin(), newFormIdMapper.begin() + defaultFormSize, 0);
-	utils::sortWriteInvIdx(ret.forms.begin() + defaultFormSize, ret.forms.end(), newFormIdMapper.begin() + defaultFormSize, defaultFormSize);
-	ret.forms.emplace_back();
+	utils::sortWriteInvIdx(vocab->forms.begin() + defaultFormSize, vocab->forms.end(), newFormIdMapper.begin() + defaultFormSize, defaultFormSize, {}, buildPool);
+	vocab->forms.emplace_back();
 
 	uint8_t formHash = 0;
-	for (size_t i = 1; i < ret.forms.size(); ++i)
+	for (size_t i = 1; i < vocab->forms.size(); ++i)
 	{
-		if (!ComparatorIgnoringSpace::equal(ret.forms[i].form, ret.forms[i - 1].form)) ++formHash;
-		ret.forms[i].formHash = formHash;
+		if (!ComparatorIgnoringSpace::equal(vocab->forms[i].form, vocab->forms[i - 1].form)) ++formHash;
+		vocab->forms[i].formHash = formHash;
 	}
 
 	for (auto& m : morphemes)
 	{
-		ret.morphemes.emplace_back(bake(m, ret.morphemes.data(), ret.forms.data(), newFormIdMapper));
+		vocab->morphemes.emplace_back(bake(m, vocab->morphemes.data(), vocab->forms.data(), newFormIdMapper));
 	}
 	for (auto& m : combinedMorphemes)
 	{
-		ret.morphemes.emplace_back(bake(m, ret.morphemes.data(), ret.forms.data(), newFormIdMapper));		
+		vocab->morphemes.emplace_back(bake(m, vocab->morphemes.data(), vocab->forms.data(), newFormIdMapper));		
 	}
 
 	utils::ContinuousTrie<KTrie> formTrie{ defaultFormSize + 1 };
 	// reserve places for root node + default tag morphemes
 	for (size_t i = 0; i < defaultFormSize; ++i)
 	{
-		formTrie[i + 1].val = &ret.forms[i];
+		formTrie[i + 1].val = &vocab->forms[i];
 	}
 
 	Vector<const Form*> sortedForms;
-	for (size_t i = defaultFormSize; i < ret.forms.size() - 1; ++i)
+	for (size_t i = defaultFormSize; i < vocab->forms.size() - 1; ++i)
 	{
-		auto& f = ret.forms[i];
+		auto& f = vocab->forms[i];
 		if (f.candidate.empty()) continue;
 
 		if (f.candidate[0]->vowel != CondVowel::none)
@@ -2015,147 +2099,173 @@ Kiwi KiwiBuilder::build(const TypoTransformer& typos, float typoCostThreshold) c
 	// 오타 교정이 없는 경우 일반 Trie 생성
 	if (typos.empty())
 	{
+		// 공백을 무시하면 같아지는 형태들의 순서가 어느 것이 노드의 값이 될지를 결정하므로 이 정렬은 기존대로 std::sort를 사용한다.
 		sort(sortedForms.begin(), sortedForms.end(), [](const Form* a, const Form* b)
 		{
 			return ComparatorIgnoringSpace::less(a->form, b->form);
 		});
 
-		size_t estimatedNodeSize = 0;
-		const KString* prevForm = nullptr;
-		for (auto f : sortedForms)
+		Vector<KString> keys(sortedForms.size());
+		utils::parallelFor(buildPool, 0, keys.size(), [&](size_t, size_t i)
 		{
-			if (!prevForm)
-			{
-				estimatedNodeSize += f->form.size() - count(f->form.begin(), f->form.end(), u' ');
-				prevForm = &f->form;
-				continue;
-			}
-			size_t commonPrefix = 0;
-			while (commonPrefix < std::min(prevForm->size(), f->form.size())
-				&& (*prevForm)[commonPrefix] == f->form[commonPrefix]) ++commonPrefix;
-			estimatedNodeSize += f->form.size() - commonPrefix;
-			prevForm = &f->form;
-		}
-		formTrie.reserveMore(estimatedNodeSize);
+			keys[i] = removeSpace(sortedForms[i]->form);
+		}, 4096);
 
-		decltype(formTrie)::CacheStore<KString> cache;
-		for (auto f : sortedForms)
-		{
-			formTrie.buildWithCaching(removeSpace(f->form), f, cache);
-		}
+		buildSortedTrie(formTrie, keys.size(), 
+			[&](size_t i) -> const KString& { return keys[i]; },
+			[&](size_t i) { return sortedForms[i]; },
+			buildPool);
 	}
 	// 오타 교정이 있는 경우 가능한 모든 오타에 대해 Trie 생성
 	else
 	{
 		using TypoInfo = tuple<uint32_t, float, uint16_t, CondVowel>;
-		UnorderedMap<KString, Vector<TypoInfo>> typoGroup;
+		using TypoGroup = UnorderedMap<KString, Vector<TypoInfo>>;
 		auto ptypos = typos.prepare();
 		ret.continualTypoCost = ptypos.getContinualTypoCost();
 		ret.lengtheningTypoCost = ptypos.getLengtheningTypoCost();
-		for (auto f : sortedForms)
+
+		// sortedForms를 연속된 조각으로 나누어 오타를 생성하고, 생성된 오타를 해시값에 따라 numParts개의 묶음으로 나눈다.
+		// 각 묶음은 조각 순서대로 합쳐지므로 같은 키에 대한 후보들의 순서는 하나씩 생성한 경우와 같다.
+		const size_t numParts = buildPool ? buildPool->size() : 1;
+		const size_t numShards = numParts > 1 ? std::max(std::min(numParts * 4, sortedForms.size() / 64), (size_t)1) : 1;
+		Vector<TypoGroup> shardGroups(numShards * numParts);
+		utils::parallelFor(buildPool, 0, numShards, [&](size_t, size_t s)
+		{
+			auto* groups = &shardGroups[s * numParts];
+			auto hasher = groups[0].hash_function();
+			const auto addTypo = [&](KString&& str, const TypoInfo& info)
+			{
+				auto& group = groups[numParts > 1 ? hasher(str) % numParts : 0];
+				group[move(str)].emplace_back(info);
+			};
+
+			const size_t b = sortedForms.size() * s / numShards, e = sortedForms.size() * (s + 1) / numShards;
+			for (size_t i = b; i < e; ++i)
+			{
+				auto f = sortedForms[i];
+				// 현재는 공백이 없는 단일 단어에 대해서만 오타 교정을 수행.
+				// 공백이 포함된 복합 명사류의 경우 오타 후보가 지나치게 많아져
+				// 메모리 요구량이 급격히 증가하기 때문.
+				if (f->numSpaces == 0)
+				{
+					for (auto t : ptypos._generate(f->form, typoCostThreshold))
+					{
+						if (t.leftCond != CondVowel::none && f->vowel != CondVowel::none && t.leftCond != f->vowel) continue;
+						addTypo(removeSpace(t.str), TypoInfo{ (uint32_t)(f - vocab->forms.data()), t.cost, f->numSpaces, t.leftCond });
+					}
+				}
+				else
+				{
+					addTypo(removeSpace(f->form), TypoInfo{ (uint32_t)(f - vocab->forms.data()), 0, f->numSpaces, CondVowel::none });
+				}
+			}
+		}, 1);
+
+		Vector<TypoGroup> typoGroups(numParts);
+		utils::parallelFor(buildPool, 0, numParts, [&](size_t, size_t p)
 		{
-			// 현재는 공백이 없는 단일 단어에 대해서만 오타 교정을 수행.
-			// 공백이 포함된 복합 명사류의 경우 오타 후보가 지나치게 많아져
-			// 메모리 요구량이 급격히 증가하기 때문.
-			if (f->numSpaces == 0)
+			auto& typoGroup = typoGroups[p];
+			for (size_t s = 0; s < numShards; ++s)
 			{
-				for (auto t : ptypos._generate(f->form, typoCostThreshold))
+				auto& src = shardGroups[s * numParts + p];
+				if (typoGroup.empty())
 				{
-					if (t.leftCond != CondVowel::none && f->vowel != CondVowel::none && t.leftCond != f->vowel) continue;
-					typoGroup[removeSpace(t.str)].emplace_back(f - ret.forms.data(), t.cost, f->numSpaces, t.leftCond);
+					typoGroup = move(src);
 				}
+				else
+				{
+					for (auto& g : src)
+					{
+						auto& v = typoGroup[g.first];
+						v.insert(v.end(), g.second.begin(), g.second.end());
+					}
+				}
+				src = TypoGroup{};
 			}
-			else
+
+			for (auto& v : typoGroup)
 			{
-				typoGroup[removeSpace(f->form)].emplace_back(f - ret.forms.data(), 0, f->numSpaces, CondVowel::none);
+				sort(v.second.begin(), v.second.end(), [](const TypoInfo& a, const TypoInfo& b)
+					{
+						if (get<1>(a) < get<1>(b)) return true;
+						if (get<1>(a) > get<1>(b)) return false;
+						return get<0>(a) < get<0>(b);
+					});
 			}
-		}
+		}, 1);
 
-		Vector<decltype(typoGroup)::pointer> typoGroupSorted;
+		Vector<TypoGroup::pointer> typoGroupSorted;
 		size_t totTfSize = 0;
-		for (auto& v : typoGroup)
+		for (auto& typoGroup : typoGroups)
 		{
-			typoGroupSorted.emplace_back(&v);
-			sort(v.second.begin(), v.second.end(), [](const TypoInfo& a, const TypoInfo& b)
-				{
-					if (get<1>(a) < get<1>(b)) return true;
-					if (get<1>(a) > get<1>(b)) return false;
-					return get<0>(a) < get<0>(b);
-				});
-			totTfSize += v.second.size();
+			for (auto& v : typoGroup)
+			{
+				typoGroupSorted.emplace_back(&v);
+				totTfSize += v.second.size();
+			}
 		}
 
-		sort(typoGroupSorted.begin(), typoGroupSorted.end(), [](decltype(typoGroup)::pointer a, decltype(typoGroup)::pointer b)
+		// 키가 모두 다르므로 병렬 정렬의 결과도 std::sort와 같다.
+		utils::parallelSort(buildPool, typoGroupSorted.begin(), typoGroupSorted.end(), [](TypoGroup::pointer a, TypoGroup::pointer b)
 			{
 				return a->first < b->first;
 			});
 
-		ret.typoForms.reserve(totTfSize + 1);
+		vocab->typoForms.reserve(totTfSize + 1);
 		
-		size_t estimatedNodeSize = 0;
-		const KString* prevForm = nullptr;
+		Vector<size_t> typoFormOffsets;
+		typoFormOffsets.reserve(typoGroupSorted.size());
 		bool hash = false;
 		for (auto f : typoGroupSorted)
 		{
-			ret.typoForms.insert(ret.typoForms.end(), f->second.begin(), f->second.end());
-			for (auto it = ret.typoForms.end() - f->second.size(); it != ret.typoForms.end(); ++it)
+			typoFormOffsets.emplace_back(vocab->typoForms.size());
+			vocab->typoForms.insert(vocab->typoForms.end(), f->second.begin(), f->second.end());
+			for (auto it = vocab->typoForms.end() - f->second.size(); it != vocab->typoForms.end(); ++it)
 			{
-				it->typoId = ret.typoPtrs.size();
+				it->typoId = vocab->typoPtrs.size();
 			}
-			ret.typoPtrs.emplace_back(ret.typoPool.size());
-			ret.typoPool += f->first;
+			vocab->typoPtrs.emplace_back(vocab->typoPool.size());
+			vocab->typoPool += f->first;
 
 			if (hash)
 			{
 				for (size_t i = 0; i < f->second.size(); ++i)
 				{
-					ret.typoForms.rbegin()[i].scoreHash = -ret.typoForms.rbegin()[i].scoreHash;
+					vocab->typoForms.rbegin()[i].scoreHash = -vocab->typoForms.rbegin()[i].scoreHash;
 				}
 			}
 
 			hash = !hash;
-			if (!prevForm)
-			{
-				estimatedNodeSize += f->first.size() - count(f->first.begin(), f->first.end(), u' ');
-				prevForm = &f->first;
-				continue;
-			}
-			size_t commonPrefix = 0;
-			while (commonPrefix < std::min(prevForm->size(), f->first.size())
-				&& (*prevForm)[commonPrefix] == f->first[commonPrefix]) ++commonPrefix;
-			estimatedNodeSize += f->first.size() - commonPrefix;
-			prevForm = &f->first;
 		}
-		ret.typoForms.emplace_back(0, 0, 0, hash);
-		ret.typoPtrs.emplace_back(ret.typoPool.size());
-		formTrie.reserveMore(estimatedNodeSize);
+		vocab->typoForms.emplace_back(0, 0, 0, hash);
+		vocab->typoPtrs.emplace_back(vocab->typoPool.size());
 
-		decltype(formTrie)::CacheStore<const KString*> cache;
-		size_t cumulated = 0;
-		for (auto f : typoGroupSorted)
-		{
-			formTrie.buildWithCaching(f->first, reinterpret_cast<const Form*>(&ret.typoForms[cumulated]), cache);
-			cumulated += f->second.size();
-		}
+		buildSortedTrie(formTrie, typoGroupSorted.size(),
+			[&](size_t i) -> const KString& { return typoGroupSorted[i]->first; },
+			[&](size_t i) { return reinterpret_cast<const Form*>(&vocab->typoForms[typoFormOffsets[i]]); },
+			buildPool);
 	}
 
-	ret.formTrie = freezeTrie(move(formTrie), archType);
+	vocab->formTrie = utils::freezeTrieAs<FormTrie>(move(formTrie), archType, buildPool);
 
-	for (auto& m : ret.morphemes)
+	for (auto& m : vocab->morphemes)
 	{
 		if (m.kform && *m.kform == u"'")
 		{
-			if (m.tag == POSTag::sso) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::singleQuoteOpen)] = &m - ret.morphemes.data();
-			else if (m.tag == POSTag::ssc) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::singleQuoteClose)] = &m - ret.morphemes.data();
-			else if (m.tag == POSTag::ss) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::singleQuoteNA)] = &m - ret.morphemes.data();
+			if (m.tag == POSTag::sso) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::singleQuoteOpen)] = &m - vocab->morphemes.data();
+			else if (m.tag == POSTag::ssc) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::singleQuoteClose)] = &m - vocab->morphemes.data();
+			else if (m.tag == POSTag::ss) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::singleQuoteNA)] = &m - vocab->morphemes.data();
 		}
 		else if (m.kform && *m.kform == u"\"")
 		{
-			if (m.tag == POSTag::sso) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::doubleQuoteOpen)] = &m - ret.morphemes.data();
-			else if (m.tag == POSTag::ssc) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::doubleQuoteClose)] = &m - ret.morphemes.data();
-			else if (m.tag == POSTag::ss) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::doubleQuoteNA)] = &m - ret.morphemes.data();
+			if (m.tag == POSTag::sso) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::doubleQuoteOpen)] = &m - vocab->morphemes.data();
+			else if (m.tag == POSTag::ssc) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::doubleQuoteClose)] = &m - vocab->morphemes.data();
+			else if (m.tag == POSTag::ss) ret.specialMorphIds[static_cast<size_t>(Kiwi::SpecialMorph::doubleQuoteNA)] = &m - vocab->morphemes.data();
 		}
 	}
+	ret.vocab = move(vocab);
+	ret.updateSentEndingSyllables();
 	return ret;
 }
 
@@ -0,0 +1,317 @@
+#include <fstream>
+
+#include <kiwi/Kiwi.h>
+#include <kiwi/Utils.h>
+#include "ArchAvailable.h"
+#include "Combiner.h"
+#include "FrozenTrie.hpp"
+#include "SkipBigramModel.hpp"
+#include "serializer.hpp"
+
+using namespace std;
+
+namespace kiwi
+{
+	namespace
+	{
+		static constexpr uint32_t bakedImageVersion = 1;
+		static constexpr size_t bakedSectionAlignment = lm::mappedLayoutAlignment;
+
+		struct BakedImageHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t arch;
+			uint32_t ptrSize;
+			uint64_t bodyOffset, bodySize;
+			uint64_t knlmOffset, knlmSize;
+			uint64_t sbgOffset, sbgSize;
+		};
+
+		/**
+		 * 매핑된 이미지 파일의 일부 구간을 가리키는 메모리 객체.
+		 * 여러 구간이 하나의 MMap을 공유하며, 마지막 참조가 사라질 때 매핑이 해제된다.
+		 */
+		class MappedSection
+		{
+			shared_ptr<utils::MMap> mm;
+			size_t offset = 0, length = 0;
+		public:
+			MappedSection(const shared_ptr<utils::MMap>& _mm, size_t _offset, size_t _length)
+				: mm{ _mm }, offset{ _offset }, length{ _length }
+			{
+			}
+
+			const void* get() const { return mm->get() + offset; }
+			size_t size() const { return length; }
+		};
+
+		inline void writeSection(ostream& ostr, const void* data, size_t size, uint64_t& offset, uint64_t& length)
+		{
+			const size_t pos = ostr.tellp();
+			const size_t padding = (bakedSectionAlignment - pos % bakedSectionAlignment) % bakedSectionAlignment;
+			static const char zeros[bakedSectionAlignment] = { 0, };
+			if (!ostr.write(zeros, padding) || !ostr.write((const char*)data, size))
+			{
+				throw serializer::SerializationException{ "writing a section of the baked image failed" };
+			}
+			offset = pos + padding;
+			length = size;
+		}
+
+		inline void writeForm(ostream& ostr, const Form& f, const Morpheme* morphBase)
+		{
+			Vector<uint32_t> cands;
+			for (auto* m : f.candidate) cands.emplace_back(m - morphBase);
+			serializer::writeMany(ostr, f.form, cands, f.numSpaces, f.vowel, f.polar, f.formHash,
+				(uint8_t)f.zCodaAppendable, (uint8_t)f.zSiotAppendable);
+		}
+
+		inline void readForm(istream& istr, Form& f, const Morpheme* morphBase, size_t numMorphemes)
+		{
+			Vector<uint32_t> cands;
+			uint8_t zCodaAppendable, zSiotAppendable;
+			serializer::readMany(istr, f.form, cands, f.numSpaces, f.vowel, f.polar, f.formHash,
+				zCodaAppendable, zSiotAppendable);
+			f.candidate = FixedVector<const Morpheme*>{ cands.size() };
+			for (size_t i = 0; i < cands.size(); ++i)
+			{
+				if (cands[i] >= numMorphemes) throw serializer::SerializationException{ "reading a form of the baked image failed" };
+				f.candidate[i] = morphBase + cands[i];
+			}
+			f.zCodaAppendable = zCodaAppendable;
+			f.zSiotAppendable = zSiotAppendable;
+		}
+
+		inline void writeMorpheme(ostream& ostr, const Morpheme& m, const Morpheme* morphBase, const Form* formBase)
+		{
+			// kform은 Form::form을 가리키므로 형태 인덱스 + 1로 저장하고, 0은 nullptr를 뜻한다.
+			const uint32_t kform = m.kform ? (uint32_t)((reinterpret_cast<const char*>(m.kform) - reinterpret_cast<const char*>(formBase)) / sizeof(Form) + 1) : 0;
+			Vector<uint32_t> chunks;
+			Vector<pair<uint8_t, uint8_t>> chunkPositions;
+			for (size_t i = 0; i < m.chunks.size(); ++i)
+			{
+				chunks.emplace_back(m.chunks[i] - morphBase);
+				chunkPositions.emplace_back(m.chunks.getSecond(i));
+			}
+			serializer::writeMany(ostr, kform, m.tag, (uint8_t)m.vowel, (uint8_t)m.polar, (uint8_t)m.complex, (uint8_t)m.saisiot,
+				m.senseId, m.combineSocket, m.combined, chunks, chunkPositions, m.userScore, m.lmMorphemeId, m.origMorphemeId);
+		}
+
+		inline void readMorpheme(istream& istr, Morpheme& m, const Morpheme* morphBase, size_t numMorphemes, const Form* formBase, size_t numForms)
+		{
+			uint32_t kform;
+			uint8_t vowel, polar, complex, saisiot;
+			Vector<uint32_t> chunks;
+			Vector<pair<uint8_t, uint8_t>> chunkPositions;
+			serializer::readMany(istr, kform, m.tag, vowel, polar, complex, saisiot,
+				m.senseId, m.combineSocket, m.combined, chunks, chunkPositions, m.userScore, m.lmMorphemeId, m.origMorphemeId);
+			const ptrdiff_t combinedId = (&m - morphBase) + (ptrdiff_t)m.combined;
+			if (chunks.size() != chunkPositions.size() || kform > numForms
+				|| combinedId < 0 || (size_t)combinedId >= numMorphemes
+				|| m.lmMorphemeId >= numMorphemes || m.origMorphemeId >= numMorphemes)
+			{
+				throw serializer::SerializationException{ "reading a morpheme of the baked image failed" };
+			}
+			m.kform = kform ? &formBase[kform - 1].form : nullptr;
+			m.vowel = (CondVowel)vowel;
+			m.polar = (CondPolarity)polar;
+			m.complex = !!complex;
+			m.saisiot = !!saisiot;
+			m.chunks = FixedPairVector<const Morpheme*, pair<uint8_t, uint8_t>>{ chunks.size() };
+			for (size_t i = 0; i < chunks.size(); ++i)
+			{
+				if (chunks[i] >= numMorphemes) throw serializer::SerializationException{ "reading a morpheme of the baked image failed" };
+				m.chunks[i] = morphBase + chunks[i];
+				m.chunks.getSecond(i) = chunkPositions[i];
+			}
+		}
+	}
+
+	void Kiwi::save(const string& path) const
+	{
+		if (!ready()) throw Exception{ "Cannot save a Kiwi instance which is not ready." };
+		const auto& forms = vocab->forms;
+		const auto& morphemes = vocab->morphemes;
+		const auto& typoForms = vocab->typoForms;
+		const auto& formTrie = vocab->formTrie;
+
+		ofstream ofs{ path, ios_base::binary };
+		if (!ofs) throw Exception{ "Failed to open file '" + path + "'." };
+
+		BakedImageHeader header = { { 'K', 'I', 'W', 'B' }, bakedImageVersion, static_cast<uint32_t>(selectedArch), (uint32_t)sizeof(void*) };
+		ofs.write((const char*)&header, sizeof(header));
+		header.bodyOffset = ofs.tellp();
+
+		serializer::writeMany(ofs, integrateAllomorph, cutOffThreshold, unkFormScoreScale, unkFormScoreBias,
+			spacePenalty, typoCostWeight, continualTypoCost, lengtheningTypoCost,
+			(uint64_t)maxUnkFormSize, (uint64_t)spaceTolerance, tagScorer.weight);
+
+		serializer::writeMany(ofs, (uint32_t)forms.size(), (uint32_t)morphemes.size());
+		for (auto& f : forms) writeForm(ofs, f, morphemes.data());
+		for (auto& m : morphemes) writeMorpheme(ofs, m, morphemes.data(), forms.data());
+
+		serializer::writeMany(ofs, vocab->typoPool, vocab->typoPtrs, (uint32_t)typoForms.size());
+		for (auto& t : typoForms)
+		{
+			serializer::writeMany(ofs, t.formId, t.scoreHash, t.typoId, t.numSpaces, t.leftCond);
+		}
+
+		// 형태 Trie의 값은 forms를 가리키거나, 오타 교정이 켜진 경우 typoForms를 가리킨다.
+		// forms 내의 위치는 1부터, typoForms 내의 위치는 forms.size() + 1부터 번호를 매겨 저장한다.
+		formTrie.writeRaw(ofs, [&](const Form* v) -> uint32_t
+		{
+			if (formTrie.isNull(v)) return 0;
+			if (formTrie.hasSubmatch(v)) return (uint32_t)-1;
+			if (forms.data() <= v && v < forms.data() + forms.size()) return v - forms.data() + 1;
+			return reinterpret_cast<const TypoForm*>(v) - typoForms.data() + forms.size() + 1;
+		});
+		serializer::writeMany(ofs, specialMorphIds, (uint8_t)(combiningRule ? 1 : 0));
+		if (combiningRule) combiningRule->serializerWrite(ofs);
+		header.bodySize = (size_t)ofs.tellp() - header.bodyOffset;
+
+		if (langMdl.knlm)
+		{
+			auto knlm = langMdl.knlm->exportMappedLayout();
+			writeSection(ofs, knlm.get(), knlm.size(), header.knlmOffset, header.knlmSize);
+		}
+		if (langMdl.sbg)
+		{
+			auto& sbg = langMdl.sbg->getMemory();
+			writeSection(ofs, sbg.get(), sbg.size(), header.sbgOffset, header.sbgSize);
+		}
+
+		ofs.seekp(0);
+		if (!ofs.write((const char*)&header, sizeof(header)))
+		{
+			throw serializer::SerializationException{ "writing the baked image failed" };
+		}
+	}
+
+	Kiwi Kiwi::loadBaked(const string& path, ArchType arch, size_t numThreads)
+	{
+		auto mm = make_shared<utils::MMap>(path);
+		if (mm->size() < sizeof(BakedImageHeader)) throw serializer::SerializationException{ "'" + path + "' is not a baked Kiwi image." };
+
+		BakedImageHeader header;
+		memcpy(&header, mm->get(), sizeof(header));
+		if (memcmp(header.magic, "KIWB", 4) != 0)
+		{
+			throw serializer::SerializationException{ "'" + path + "' is not a baked Kiwi image." };
+		}
+		if (header.version != bakedImageVersion)
+		{
+			throw serializer::SerializationException{ "Unsupported baked image version : " + to_string(header.version) };
+		}
+		if (header.ptrSize != sizeof(void*))
+		{
+			throw serializer::SerializationException{ "The baked image was saved on a platform with a different pointer size." };
+		}
+		if (header.bodyOffset + header.bodySize > mm->size()
+			|| header.knlmOffset + header.knlmSize > mm->size()
+			|| header.sbgOffset + header.sbgSize > mm->size())
+		{
+			throw serializer::SerializationException{ "The baked image '" + path + "' is truncated." };
+		}
+
+		arch = getSelectedArch(arch);
+		const ArchType savedArch = static_cast<ArchType>(header.arch);
+
+		LangModel langMdl;
+		if (header.knlmSize)
+		{
+			langMdl.knlm = lm::KnLangModelBase::create(MappedSection{ mm, header.knlmOffset, header.knlmSize }, arch);
+		}
+		if (header.sbgSize)
+		{
+			langMdl.sbg = sb::SkipBigramModelBase::create(MappedSection{ mm, header.sbgOffset, header.sbgSize }, arch);
+		}
+
+		utils::imstream istr{ mm->get() + header.bodyOffset, (ptrdiff_t)header.bodySize };
+		bool integrateAllomorph;
+		float cutOffThreshold, unkFormScoreScale, unkFormScoreBias, spacePenalty, typoCostWeight, continualTypoCost, lengtheningTypoCost, tagScorerWeight;
+		uint64_t maxUnkFormSize, spaceTolerance;
+		serializer::readMany(istr, integrateAllomorph, cutOffThreshold, unkFormScoreScale, unkFormScoreBias,
+			spacePenalty, typoCostWeight, continualTypoCost, lengtheningTypoCost,
+			maxUnkFormSize, spaceTolerance, tagScorerWeight);
+
+		// 형태와 형태소는 서로를 포인터로 참조하므로 두 배열의 크기를 먼저 확정한 뒤 채운다.
+		uint32_t numForms, numMorphemes;
+		serializer::readMany(istr, numForms, numMorphemes);
+		Vector<Form> forms(numForms);
+		Vector<Morpheme> morphemes(numMorphemes);
+		for (auto& f : forms) readForm(istr, f, morphemes.data(), morphemes.size());
+		for (auto& m : morphemes) readMorpheme(istr, m, morphemes.data(), morphemes.size(), forms.data(), forms.size());
+
+		KString typoPool;
+		Vector<size_t> typoPtrs;
+		Vector<TypoForm> typoForms;
+		serializer::readMany(istr, typoPool, typoPtrs);
+		for (auto p : typoPtrs)
+		{
+			if (p > typoPool.size()) throw serializer::SerializationException{ "reading typo forms of the baked image failed" };
+		}
+		typoForms.resize(serializer::readFromStream<uint32_t>(istr));
+		for (auto& t : typoForms)
+		{
+			serializer::readMany(istr, t.formId, t.scoreHash, t.typoId, t.numSpaces, t.leftCond);
+			// 오타 형태의 문자열은 typoPool[typoPtrs[typoId]:typoPtrs[typoId + 1]]이다. 마지막 항목은 끝을 표시하는 용도이다.
+			const size_t typoIdEnd = &t == &typoForms.back() ? typoPtrs.size() : typoPtrs.size() - 1;
+			if (t.formId >= numForms || typoPtrs.empty() || t.typoId >= typoIdEnd)
+			{
+				throw serializer::SerializationException{ "reading typo forms of the baked image failed" };
+			}
+		}
+
+		Kiwi ret{ arch, langMdl, !typoForms.empty(), isfinite(continualTypoCost), isfinite(lengtheningTypoCost) };
+		ret.integrateAllomorph = integrateAllomorph;
+		ret.cutOffThreshold = cutOffThreshold;
+		ret.unkFormScoreScale = unkFormScoreScale;
+		ret.unkFormScoreBias = unkFormScoreBias;
+		ret.spacePenalty = spacePenalty;
+		ret.typoCostWeight = typoCostWeight;
+		ret.continualTypoCost = continualTypoCost;
+		ret.lengtheningTypoCost = lengtheningTypoCost;
+		ret.maxUnkFormSize = maxUnkFormSize;
+		ret.spaceTolerance = spaceTolerance;
+		ret.tagScorer.weight = tagScorerWeight;
+		auto vocab = make_shared<Vocab>();
+		vocab->forms = move(forms);
+		vocab->morphemes = move(morphemes);
+		vocab->typoPool = move(typoPool);
+		vocab->typoPtrs = move(typoPtrs);
+		vocab->typoForms = move(typoForms);
+
+		const Form* formBase = vocab->forms.data();
+		const TypoForm* typoBase = vocab->typoForms.data();
+		const size_t numFormsInTrie = vocab->forms.size();
+		const size_t numTypoForms = vocab->typoForms.size();
+		vocab->formTrie.readRaw(istr, [&](uint32_t v) -> const Form*
+		{
+			if (v == 0) return nullptr;
+			if (v == (uint32_t)-1) return reinterpret_cast<const Form*>(-1);
+			if (v <= numFormsInTrie) return &formBase[v - 1];
+			if (v - numFormsInTrie > numTypoForms) throw serializer::SerializationException{ "reading the form trie of the baked image failed" };
+			return reinterpret_cast<const Form*>(&typoBase[v - numFormsInTrie - 1]);
+		});
+		if (savedArch != arch) vocab->formTrie.rearrangeKeys(arch);
+		ret.vocab = move(vocab);
+
+		uint8_t hasCombiningRule;
+		serializer::readMany(istr, ret.specialMorphIds, hasCombiningRule);
+		if (hasCombiningRule)
+		{
+			ret.combiningRule = make_shared<cmb::CompiledRule>();
+			ret.combiningRule->serializerRead(istr);
+		}
+		ret.updateSentEndingSyllables();
+
+		// 0이면 공용 스레드 풀을 사용한다
+		if (numThreads != 1)
+		{
+			ret.pool = utils::acquireThreadPool(numThreads);
+			if (ret.pool->size() <= 1) ret.pool.reset();
+		}
+		return ret;
+	}
+}
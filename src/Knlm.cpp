@@ -1,4 +1,5 @@
 #include "Knlm.hpp"
+#include <atomic>
 
 namespace kiwi
 {
@@ -35,6 +36,12 @@ namespace kiwi
 			};
 		};
 
+		uint64_t KnLangModelBase::newInstanceId()
+		{
+			static std::atomic<uint64_t> numInstances{ 0 };
+			return ++numInstances;
+		}
+
 		std::unique_ptr<KnLangModelBase> KnLangModelBase::create(utils::MemoryObject&& mem, ArchType archType)
 		{
 			static tp::Table<FnCreateOptimizedModel, AvailableArch> table{ CreateOptimizedModelGetter{} };
@@ -88,16 +88,25 @@ namespace kiwi
 			return reinterpret_cast<const void*>((addr + alignment - 1) & ~(alignment - 1));
 		}
 
+		inline size_t alignedOffsetInc(size_t& offset, size_t inc, size_t alignment = serialAlignment)
+		{
+			return offset = (offset + inc + alignment - 1) & ~(alignment - 1);
+		}
+
 		template<ArchType arch, class KeyType, class DiffType = int32_t>
 		class KnLangModel : public KnLangModelBase
 		{
 			using MyNode = Node<KeyType, DiffType>;
 
-			std::unique_ptr<MyNode[]> node_data;
-			std::unique_ptr<KeyType[]> key_data;
-			std::unique_ptr<DiffType[]> all_value_data;
+			std::unique_ptr<MyNode[]> node_buf;
+			std::unique_ptr<KeyType[]> key_buf;
+			std::unique_ptr<DiffType[]> value_buf;
+			const MyNode* node_data = nullptr;
+			const KeyType* key_data = nullptr;
+			const DiffType* all_value_data = nullptr;
 			size_t num_non_leaf_nodes = 0;
-			DiffType* value_data = nullptr;
+			size_t htx_vocab_size = 0;
+			const DiffType* value_data = nullptr;
 			const float* ll_data = nullptr;
 			const float* gamma_data = nullptr;
 			const KeyType* htx_data = nullptr;
@@ -105,8 +114,9 @@ namespace kiwi
 			Vector<float> restored_floats;
 			float unk_ll = 0;
 			ptrdiff_t bos_node_idx = 0;
+			bool mapped = false;
 
-			MyNode* findLowerNode(MyNode* node, KeyType k)
+			const MyNode* findLowerNode(const MyNode* node, KeyType k) const
 			{
 				while (node->lower)
 				{
@@ -164,8 +174,7 @@ namespace kiwi
 				);
 			}
 
-		public:
-			KnLangModel(utils::MemoryObject&& mem) : KnLangModelBase{ std::move(mem) }
+			void loadPacked()
 			{
 				auto* ptr = reinterpret_cast<const char*>(base.get());
 				auto& header = getHeader();
@@ -174,8 +183,9 @@ namespace kiwi
 
 				Vector<KeyType> d_node_size;
 				auto* node_sizes = reinterpret_cast<const KeyType*>(ptr + header.node_offset);
-				key_data = make_unique<KeyType[]>((header.ll_offset - header.key_offset) / sizeof(KeyType));
-				std::memcpy(&key_data[0], ptr + header.key_offset, header.ll_offset - header.key_offset);
+				key_buf = make_unique<KeyType[]>((header.ll_offset - header.key_offset) / sizeof(KeyType));
+				std::memcpy(&key_buf[0], ptr + header.key_offset, header.ll_offset - header.key_offset);
+				key_data = key_buf.get();
 				size_t num_leaf_nodes = 0;
 				if (compressed)
 				{
@@ -229,7 +239,7 @@ namespace kiwi
 					extra_buf = toAlignedPtr(gamma_data + num_non_leaf_nodes);
 				}
 
-				size_t htx_vocab_size = header.vocab_size;
+				htx_vocab_size = header.vocab_size;
 				if (header.htx_offset)
 				{
 					htx_data = reinterpret_cast<const KeyType*>(ptr + header.htx_offset);
@@ -243,10 +253,13 @@ namespace kiwi
 				}
 
 				// restore node's data
-				node_data = make_unique<MyNode[]>(num_non_leaf_nodes);
-				all_value_data = make_unique<DiffType[]>(header.num_nodes - 1 + htx_vocab_size);
-				value_data = &all_value_data[htx_vocab_size];
-				std::fill(&all_value_data[0], value_data, 0);
+				node_buf = make_unique<MyNode[]>(num_non_leaf_nodes);
+				value_buf = make_unique<DiffType[]>(header.num_nodes - 1 + htx_vocab_size);
+				node_data = node_buf.get();
+				all_value_data = value_buf.get();
+				auto* values = &value_buf[htx_vocab_size];
+				value_data = values;
+				std::fill(&value_buf[0], values, 0);
 
 				size_t non_leaf_idx = 0, leaf_idx = 0, next_offset = 0;
 				Vector<std::array<size_t, 3>> key_ranges;
@@ -254,11 +267,11 @@ namespace kiwi
 				{
 					if (node_sizes[i])
 					{
-						auto& node = node_data[non_leaf_idx];
+						auto& node = node_buf[non_leaf_idx];
 						if (!key_ranges.empty())
 						{
 							auto& back = key_ranges.back();
-							value_data[back[1]] = non_leaf_idx - back[0];
+							values[back[1]] = non_leaf_idx - back[0];
 						}
 						node.num_nexts = node_sizes[i];
 						node.next_offset = next_offset;
@@ -269,7 +282,7 @@ namespace kiwi
 					else
 					{
 						auto& back = key_ranges.back();
-						reinterpret_cast<float&>(value_data[back[1]]) = leaf_ll_data[leaf_idx];
+						reinterpret_cast<float&>(values[back[1]]) = leaf_ll_data[leaf_idx];
 						back[1]++;
 						while (key_ranges.back()[1] == key_ranges.back()[2])
 						{
@@ -281,18 +294,18 @@ namespace kiwi
 					}
 				}
 
-				for (size_t i = 0; i < node_data[0].num_nexts; ++i)
+				for (size_t i = 0; i < node_buf[0].num_nexts; ++i)
 				{
-					auto k = key_data[i];
-					auto v = value_data[i];
-					all_value_data[k] = v;
+					auto k = key_buf[i];
+					auto v = values[i];
+					value_buf[k] = v;
 				}
 
 				Vector<uint8_t> tempBuf;
 				for (size_t i = 0; i < non_leaf_idx; ++i)
 				{
-					auto& node = node_data[i];
-					nst::prepare<arch>(&key_data[node.next_offset], &value_data[node.next_offset], node.num_nexts, tempBuf);
+					auto& node = node_buf[i];
+					nst::prepare<arch>(&key_buf[node.next_offset], &values[node.next_offset], node.num_nexts, tempBuf);
 				}
 
 				if (htx_data)
@@ -311,7 +324,7 @@ namespace kiwi
 				}
 				
 				Deque<MyNode*> dq;
-				for (dq.emplace_back(&node_data[0]); !dq.empty(); dq.pop_front())
+				for (dq.emplace_back(&node_buf[0]); !dq.empty(); dq.pop_front())
 				{
 					auto p = dq.front();
 					for (size_t i = 0; i < p->num_nexts; ++i)
@@ -326,6 +339,166 @@ namespace kiwi
 				}
 			}
 
+			void loadMapped()
+			{
+				auto* ptr = reinterpret_cast<const char*>(base.get());
+				auto& header = getHeader();
+				auto& mheader = *reinterpret_cast<const MappedHeader*>(ptr + header.node_offset);
+				if (std::memcmp(mheader.magic, "KNMM", 4) != 0)
+				{
+					throw std::runtime_error{ "Invalid mapped KnLM layout." };
+				}
+				if (mheader.version != mappedLayoutVersion)
+				{
+					throw std::runtime_error{ "Unsupported mapped KnLM layout version : " + std::to_string(mheader.version) };
+				}
+				if (header.key_size != sizeof(KeyType) || header.diff_size != sizeof(DiffType))
+				{
+					throw std::runtime_error{ "Mismatched key or diff size of the mapped KnLM layout." };
+				}
+
+				num_non_leaf_nodes = mheader.num_non_leaf_nodes;
+				htx_vocab_size = mheader.htx_vocab_size;
+				node_data = reinterpret_cast<const MyNode*>(ptr + mheader.node_offset);
+				key_data = reinterpret_cast<const KeyType*>(ptr + mheader.key_offset);
+				all_value_data = reinterpret_cast<const DiffType*>(ptr + mheader.value_offset);
+				value_data = all_value_data + htx_vocab_size;
+				ll_data = reinterpret_cast<const float*>(ptr + mheader.ll_offset);
+				gamma_data = ll_data + num_non_leaf_nodes;
+				htx_data = mheader.htx_offset ? reinterpret_cast<const KeyType*>(ptr + mheader.htx_offset) : nullptr;
+				extra_buf = header.extra_buf_size ? (ptr + mheader.extra_offset) : nullptr;
+				unk_ll = mheader.unk_ll;
+				bos_node_idx = mheader.bos_node_idx;
+				mapped = true;
+
+				if (mheader.arch == static_cast<uint32_t>(arch)) return;
+
+				// The key order of each node depends on the search algorithm of the architecture,
+				// so the keys should be reordered when the layout was prepared for another one.
+				const size_t num_keys = header.num_nodes - 1;
+				key_buf = make_unique<KeyType[]>(num_keys);
+				value_buf = make_unique<DiffType[]>(num_keys + htx_vocab_size);
+				std::copy(key_data, key_data + num_keys, key_buf.get());
+				std::copy(all_value_data, all_value_data + num_keys + htx_vocab_size, value_buf.get());
+				auto* values = &value_buf[htx_vocab_size];
+				reorderKeys(key_buf.get(), values, arch);
+				key_data = key_buf.get();
+				all_value_data = value_buf.get();
+				value_data = values;
+				mapped = false;
+			}
+
+			/**
+			 * @brief 모든 노드의 키 배열을 `layoutArch`의 탐색 순서로 다시 배치한다.
+			 */
+			void reorderKeys(KeyType* keys, DiffType* values, ArchType layoutArch) const
+			{
+				Vector<std::pair<KeyType, DiffType>> sorted;
+				Vector<uint8_t> tempBuf;
+				for (size_t i = 0; i < num_non_leaf_nodes; ++i)
+				{
+					auto& node = node_data[i];
+					sorted.clear();
+					for (size_t j = 0; j < node.num_nexts; ++j)
+					{
+						sorted.emplace_back(keys[node.next_offset + j], values[node.next_offset + j]);
+					}
+					std::sort(sorted.begin(), sorted.end(), [](const std::pair<KeyType, DiffType>& a, const std::pair<KeyType, DiffType>& b)
+					{
+						return a.first < b.first;
+					});
+					for (size_t j = 0; j < node.num_nexts; ++j)
+					{
+						keys[node.next_offset + j] = sorted[j].first;
+						values[node.next_offset + j] = sorted[j].second;
+					}
+					nst::prepare(layoutArch, &keys[node.next_offset], &values[node.next_offset], node.num_nexts, tempBuf);
+				}
+			}
+
+		public:
+			KnLangModel(utils::MemoryObject&& mem) : KnLangModelBase{ std::move(mem) }
+			{
+				if (getHeader().quantized & mappedLayoutFlag)
+				{
+					loadMapped();
+				}
+				else
+				{
+					loadPacked();
+				}
+			}
+
+			bool isMapped() const final
+			{
+				return mapped;
+			}
+
+			utils::MemoryOwner exportMappedLayout(ArchType layoutArch = ArchType::default_) const final
+			{
+				if (layoutArch == ArchType::default_) layoutArch = arch;
+				auto& header = getHeader();
+				const size_t num_keys = header.num_nodes - 1;
+				Header nheader = header;
+				MappedHeader mheader = { { 'K', 'N', 'M', 'M' }, mappedLayoutVersion, static_cast<uint32_t>(layoutArch), };
+				mheader.num_non_leaf_nodes = num_non_leaf_nodes;
+				mheader.htx_vocab_size = htx_vocab_size;
+				mheader.bos_node_idx = bos_node_idx;
+				mheader.unk_ll = unk_ll;
+
+				size_t final_size = 0;
+				nheader.node_offset = alignedOffsetInc(final_size, sizeof(Header), mappedLayoutAlignment);
+				mheader.node_offset = alignedOffsetInc(final_size, sizeof(MappedHeader), mappedLayoutAlignment);
+				mheader.key_offset = alignedOffsetInc(final_size, sizeof(MyNode) * num_non_leaf_nodes, mappedLayoutAlignment);
+				mheader.value_offset = alignedOffsetInc(final_size, sizeof(KeyType) * num_keys, mappedLayoutAlignment);
+				mheader.ll_offset = alignedOffsetInc(final_size, sizeof(DiffType) * (num_keys + htx_vocab_size), mappedLayoutAlignment);
+				alignedOffsetInc(final_size, sizeof(float) * num_non_leaf_nodes * 2, mappedLayoutAlignment);
+				if (htx_data)
+				{
+					mheader.htx_offset = final_size;
+					alignedOffsetInc(final_size, sizeof(KeyType) * header.vocab_size, mappedLayoutAlignment);
+				}
+				else
+				{
+					mheader.htx_offset = 0;
+				}
+				mheader.extra_offset = final_size;
+
+				nheader.quantized = mappedLayoutFlag;
+				nheader.diff_size = sizeof(DiffType);
+				nheader.key_offset = mheader.key_offset;
+				nheader.ll_offset = mheader.ll_offset;
+				nheader.gamma_offset = mheader.ll_offset + sizeof(float) * num_non_leaf_nodes;
+				nheader.qtable_offset = 0;
+				nheader.htx_offset = mheader.htx_offset;
+
+				utils::MemoryOwner ret{ final_size + header.extra_buf_size };
+				std::memset(ret.get(), 0, ret.size());
+				auto* optr = reinterpret_cast<char*>(ret.get());
+				std::memcpy(optr, &nheader, sizeof(Header));
+				std::memcpy(optr + nheader.node_offset, &mheader, sizeof(MappedHeader));
+				std::memcpy(optr + mheader.node_offset, node_data, sizeof(MyNode) * num_non_leaf_nodes);
+				std::memcpy(optr + mheader.key_offset, key_data, sizeof(KeyType) * num_keys);
+				std::memcpy(optr + mheader.value_offset, all_value_data, sizeof(DiffType) * (num_keys + htx_vocab_size));
+				if (layoutArch != arch)
+				{
+					reorderKeys(reinterpret_cast<KeyType*>(optr + mheader.key_offset), 
+						reinterpret_cast<DiffType*>(optr + mheader.value_offset) + htx_vocab_size, 
+						layoutArch);
+				}
+				std::memcpy(optr + mheader.ll_offset, ll_data, sizeof(float) * num_non_leaf_nodes);
+				std::memcpy(optr + mheader.ll_offset + sizeof(float) * num_non_leaf_nodes, gamma_data, sizeof(float) * num_non_leaf_nodes);
+				if (htx_data)
+				{
+					std::memcpy(optr + mheader.htx_offset, htx_data, sizeof(KeyType) * header.vocab_size);
+				}
+				if (header.extra_buf_size)
+				{
+					std::memcpy(optr + mheader.extra_offset, extra_buf, header.extra_buf_size);
+				}
+				return ret;
+			}
+
 			float getLL(ptrdiff_t node_idx, KeyType next) const
 			{
 				DiffType v;
@@ -359,6 +532,107 @@ namespace kiwi
 				}
 			}
 
+			const MyNode* unkNextNode(KeyType next) const
+			{
+				if (htx_data)
+				{
+					DiffType lv;
+					if (nst::search<arch>(
+						&key_data[0],
+						value_data,
+						node_data[0].num_nexts, htx_data[next], lv
+					)) return &node_data[lv];
+				}
+				return &node_data[0];
+			}
+
+			/**
+			 * @brief progressN에서 하나의 상태가 진행 중인 탐색의 위치
+			 */
+			struct ProgressLane
+			{
+				const MyNode* node;
+				float acc;
+				float leaf_ll;
+				bool in_leaf;
+			};
+
+			/**
+			 * @brief progress의 탐색을 한 단계(search 한 번)만 진행한다.
+			 * @return 탐색이 끝났으면 true. 이 때 lane.node는 다음 상태, out은 progress의 반환값이 된다.
+			 */
+			bool progressStep(ProgressLane& lane, KeyType next, float& out) const
+			{
+				const MyNode* node = lane.node;
+				DiffType v;
+				if (lane.in_leaf)
+				{
+					// leaf 노드에 도달한 뒤 다음 상태로 사용할 non-leaf 노드를 하위 차수에서 찾는 중
+					if (nst::search<arch>(
+						&key_data[node->next_offset],
+						&value_data[node->next_offset],
+						node->num_nexts, next, v
+					) && v > 0)
+					{
+						lane.node = node + v;
+						out = lane.acc + lane.leaf_ll;
+						return true;
+					}
+					if (node->lower)
+					{
+						lane.node = node + node->lower;
+						PREFETCH_T0(&key_data[lane.node->next_offset]);
+						return false;
+					}
+					lane.node = unkNextNode(next);
+					out = lane.acc + lane.leaf_ll;
+					return true;
+				}
+
+				if (node == node_data)
+				{
+					v = all_value_data[next];
+					if (v == 0)
+					{
+						lane.node = unkNextNode(next);
+						out = lane.acc + unk_ll;
+						return true;
+					}
+				}
+				else if (!nst::search<arch>(
+					&key_data[node->next_offset],
+					&value_data[node->next_offset],
+					node->num_nexts, next, v
+				))
+				{
+					lane.acc += gamma_data[node - node_data];
+					lane.node = node + node->lower;
+					PREFETCH_T0(&key_data[lane.node->next_offset]);
+					return false;
+				}
+
+				// non-leaf node
+				if (v > 0)
+				{
+					lane.node = node + v;
+					out = lane.acc + ll_data[lane.node - node_data];
+					return true;
+				}
+
+				// leaf node
+				lane.leaf_ll = reinterpret_cast<const float&>(v);
+				if (node->lower)
+				{
+					lane.in_leaf = true;
+					lane.node = node + node->lower;
+					PREFETCH_T0(&key_data[lane.node->next_offset]);
+					return false;
+				}
+				lane.node = unkNextNode(next);
+				out = lane.acc + lane.leaf_ll;
+				return true;
+			}
+
 			template<class IdxType>
 			float progress(IdxType& node_idx, KeyType next) const
 			{
@@ -446,6 +720,48 @@ namespace kiwi
 				}
 			}
 
+			/**
+			 * @brief n개의 독립적인 상태에 대해 progress를 한꺼번에 수행한다.
+			 * @details 결과는 progress를 하나씩 호출한 것과 같다. 
+			 * 각 상태의 탐색을 한 단계씩 번갈아 진행하면서 다음 단계에 필요한 노드를 미리 prefetch해두므로
+			 * 메모리 접근 지연이 여러 상태에 걸쳐 겹쳐진다.
+			 */
+			template<class IdxType>
+			void progressN(IdxType* node_idx, const KeyType* next, float* out, size_t n) const
+			{
+				static constexpr size_t maxLanes = 16;
+				ProgressLane lanes[maxLanes];
+				uint8_t active[maxLanes];
+				for (size_t b = 0; b < n; b += maxLanes)
+				{
+					const size_t numLanes = std::min(n - b, maxLanes);
+					for (size_t i = 0; i < numLanes; ++i)
+					{
+						lanes[i].node = &node_data[node_idx[b + i]];
+						lanes[i].acc = 0;
+						lanes[i].leaf_ll = 0;
+						lanes[i].in_leaf = false;
+						active[i] = (uint8_t)i;
+						PREFETCH_T0(&key_data[lanes[i].node->next_offset]);
+					}
+
+					size_t numActive = numLanes;
+					while (numActive)
+					{
+						for (size_t j = 0; j < numActive;)
+						{
+							const size_t i = active[j];
+							if (progressStep(lanes[i], next[b + i], out[b + i]))
+							{
+								node_idx[b + i] = (IdxType)(lanes[i].node - node_data);
+								active[j] = active[--numActive];
+							}
+							else ++j;
+						}
+					}
+				}
+			}
+
 			float _progress(ptrdiff_t& node_idx, size_t next) const override
 			{
 				return progress(node_idx, (KeyType)next);
@@ -795,11 +1111,6 @@ namespace kiwi
 			return table[bits - 1](ll_table, gamma_table, ll, leaf_ll, gamma, llq, gammaq);
 		}
 
-		inline size_t alignedOffsetInc(size_t& offset, size_t inc, size_t alignment = serialAlignment)
-		{
-			return offset = (offset + inc + alignment - 1) & ~(alignment - 1);
-		}
-
 		inline std::ostream& writePadding(std::ostream& os, size_t alignment = serialAlignment)
 		{
 			const size_t pos = os.tellp();
@@ -7,6 +7,86 @@
 
 namespace kiwi
 {
+	/**
+	 * @brief (LM 노드, 다음 형태소) 쌍으로부터 (다음 LM 노드, 점수)를 기억해두는 스레드별 direct-mapped 캐시.
+	 * @details 같은 어간 뒤에 같은 조사/어미가 오는 전이는 문서 내에서 반복적으로 나타나므로 
+	 * 매번 trie를 탐색하는 대신 캐시를 한번 확인하는 것으로 대체한다.
+	 */
+	class LmTransitionCache
+	{
+		struct Entry
+		{
+			int32_t node = -1;
+			uint32_t next = 0;
+			int32_t nextNode = 0;
+			float ll = 0;
+		};
+
+		Vector<Entry> entries;
+		uint64_t owner = 0;
+		size_t mask = 0;
+
+		Entry& slot(int32_t node, uint32_t next)
+		{
+			const uint64_t key = ((uint64_t)(uint32_t)node << 32) | next;
+			return entries[(size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask];
+		}
+
+	public:
+		size_t hits = 0, misses = 0;
+
+		static LmTransitionCache& local()
+		{
+			thread_local LmTransitionCache cache;
+			return cache;
+		}
+
+		bool enabled() const { return !entries.empty(); }
+
+		/**
+		 * @brief 캐시를 model에 대해 사용할 수 있게 준비한다. 모델이나 크기가 바뀐 경우 기존 내용은 버린다.
+		 * @param modelId 모델의 `KnLangModelBase::getInstanceId()`. 주소와 달리 해제 후 재사용되지 않는다.
+		 * @param size 최대 항목 수. 2의 거듭제곱으로 내림하며, 0이면 캐시를 사용하지 않는다.
+		 */
+		void prepare(uint64_t modelId, size_t size)
+		{
+			size_t cap = 0;
+			if (size)
+			{
+				cap = 1;
+				while (cap * 2 <= size) cap *= 2;
+			}
+			if (modelId == owner && cap == entries.size()) return;
+			owner = modelId;
+			entries.clear();
+			entries.resize(cap);
+			mask = cap ? cap - 1 : 0;
+		}
+
+		bool find(int32_t node, uint32_t next, int32_t& nextNode, float& ll)
+		{
+			auto& e = slot(node, next);
+			if (e.node == node && e.next == next)
+			{
+				nextNode = e.nextNode;
+				ll = e.ll;
+				++hits;
+				return true;
+			}
+			++misses;
+			return false;
+		}
+
+		void store(int32_t node, uint32_t next, int32_t nextNode, float ll)
+		{
+			auto& e = slot(node, next);
+			e.node = node;
+			e.next = next;
+			e.nextNode = nextNode;
+			e.ll = ll;
+		}
+	};
+
 	template<ArchType _arch>
 	class VoidState
 	{
@@ -25,6 +105,11 @@ namespace kiwi
 		{
 			return 0;
 		}
+
+		static void nextN(const LangModel&, VoidState*, const uint32_t*, float* out, size_t n, LmTransitionCache* = nullptr)
+		{
+			std::fill(out, out + n, 0.f);
+		}
 	};
 
 	template<ArchType _arch, class VocabTy>
@@ -48,6 +133,44 @@ namespace kiwi
 			return static_cast<const lm::KnLangModel<arch, VocabTy>&>(*lm.knlm).progress(node, next);
 		}
 
+		/**
+		 * @brief states[i].next(lm, nexts[i])의 결과를 out[i]에 저장한다. 서로 독립적인 상태들의 LM 탐색을 겹쳐서 수행한다.
+		 * @param cache nullptr가 아니면 캐시에 있는 전이는 탐색을 생략하고, 새로 탐색한 전이는 캐시에 저장한다.
+		 */
+		template<class State>
+		static void nextN(const LangModel& lm, State* states, const uint32_t* nexts, float* out, size_t n, LmTransitionCache* cache = nullptr)
+		{
+			static constexpr size_t blockSize = 64;
+			auto& knlm = static_cast<const lm::KnLangModel<arch, VocabTy>&>(*lm.knlm);
+			int32_t nodes[blockSize];
+			VocabTy keys[blockSize];
+			float lls[blockSize];
+			uint8_t idx[blockSize];
+			for (size_t b = 0; b < n; b += blockSize)
+			{
+				const size_t m = std::min(n - b, blockSize);
+				size_t numMisses = 0;
+				for (size_t i = 0; i < m; ++i)
+				{
+					auto& state = states[b + i];
+					if (cache && cache->find(state.node, nexts[b + i], state.node, out[b + i])) continue;
+					nodes[numMisses] = state.node;
+					keys[numMisses] = (VocabTy)nexts[b + i];
+					idx[numMisses++] = (uint8_t)i;
+				}
+				if (!numMisses) continue;
+
+				knlm.progressN(nodes, keys, lls, numMisses);
+				for (size_t j = 0; j < numMisses; ++j)
+				{
+					auto& state = states[b + idx[j]];
+					if (cache) cache->store(state.node, nexts[b + idx[j]], nodes[j], lls[j]);
+					state.node = nodes[j];
+					out[b + idx[j]] = lls[j];
+				}
+			}
+		}
+
 		void predict(const LangModel& lm, float* out) const
 		{
 			
@@ -81,8 +204,24 @@ namespace kiwi
 
 		float next(const LangModel& lm, VocabTy next)
 		{
-			auto& sbg = static_cast<const sb::SkipBigramModel<arch, VocabTy, 8>&>(*lm.sbg);
 			float ll = KnLMState<arch, VocabTy>::next(lm, next);
+			return nextSbg(lm, next, ll);
+		}
+
+		static void nextN(const LangModel& lm, SbgState* states, const uint32_t* nexts, float* out, size_t n, LmTransitionCache* cache = nullptr)
+		{
+			// skip-bigram 보정은 history 전체에 의존하므로 KnLM 전이만 캐시한다.
+			KnLMState<arch, VocabTy>::nextN(lm, states, nexts, out, n, cache);
+			for (size_t i = 0; i < n; ++i)
+			{
+				out[i] = states[i].nextSbg(lm, (VocabTy)nexts[i], out[i]);
+			}
+		}
+
+	private:
+		float nextSbg(const LangModel& lm, VocabTy next, float ll)
+		{
+			auto& sbg = static_cast<const sb::SkipBigramModel<arch, VocabTy, 8>&>(*lm.sbg);
 			if (sbg.isValidVocab(next))
 			{
 				if (ll > -13)
@@ -95,6 +234,8 @@ namespace kiwi
 			return ll;
 		}
 
+	public:
+
 		void predict(const LangModel& lm, float* out) const
 		{
 
@@ -12,6 +12,7 @@
 #include "StrUtils.h"
 #include "SortUtils.hpp"
 #include "LimitedVector.hpp"
+#include "ArenaAllocator.hpp"
 
 using namespace std;
 
@@ -46,6 +47,11 @@ namespace kiwi
 	template<class LmState>
 	struct WordLL;
 
+	struct GraphColumns;
+
+	template<class LmState>
+	struct BeamColumns;
+
 	using Wid = uint32_t;
 
 	enum class PathEvaluatingMode
@@ -94,6 +100,13 @@ namespace kiwi
 		};
 		using Path = Vector<Result>;
 
+		/**
+		 * @brief 경로 탐색 중에만 사용되는 임시 컨테이너들. 스레드별 `utils::Arena`에서 할당받고 탐색이 끝나면 한꺼번에 회수한다.
+		 */
+		template<class LmState>
+		using PathCache = utils::ArenaVector<utils::ArenaVector<WordLL<LmState>>>;
+		using FormList = utils::ArenaVector<U16StringView>;
+
 		struct ChunkResult
 		{
 			Path path;
@@ -128,12 +141,14 @@ namespace kiwi
 			const KGraphNode* startNode,
 			const KGraphNode* node,
 			const size_t topN,
-			Vector<Vector<WordLL<LmState>>>& cache,
-			const Vector<U16StringView>& ownFormList,
+			PathCache<LmState>& cache,
+			const FormList& ownFormList,
 			size_t i,
 			size_t ownFormId,
 			CandTy&& cands,
 			bool unknownForm,
+			const GraphColumns& graphCols,
+			const BeamColumns<LmState>& beams,
 			const Vector<SpecialState>& prevSpStates,
 			bool splitComplex = false,
 			bool splitSaisiot = false,
@@ -143,10 +158,10 @@ namespace kiwi
 
 		template<PathEvaluatingMode mode, class LmState>
 		static void evalSingleMorpheme(
-			Vector<WordLL<LmState>>& resultOut,
+			utils::ArenaVector<WordLL<LmState>>& resultOut,
 			const Kiwi* kw,
-			const Vector<U16StringView>& ownForms,
-			const Vector<Vector<WordLL<LmState>>>& cache,
+			const FormList& ownForms,
+			const PathCache<LmState>& cache,
 			size_t ownFormId,
 			const Morpheme* curMorph,
 			const KGraphNode* node,
@@ -154,6 +169,8 @@ namespace kiwi
 			const size_t topN,
 			const float ignoreCondScore,
 			const float nodeLevelDiscount,
+			const GraphColumns& graphCols,
+			const BeamColumns<LmState>& beams,
 			const Vector<SpecialState>& prevSpStates
 		);
 	};
@@ -203,6 +220,32 @@ namespace kiwi
 		}
 	};
 
+	/**
+	 * @brief 경로 탐색 중 노드 사이의 연결을 따라갈 때 쓰는 그래프의 SoA 표현.
+	 * @details i번 노드의 이전 노드 번호들은 prevIdx[prevBegin[i]]부터 prevIdx[prevBegin[i + 1] - 1]까지에
+	 * KGraphNode의 sibling 순서대로 들어 있고, spaced에는 같은 순서로 두 노드 사이에 공백이 있는지가 들어 있다.
+	 */
+	struct GraphColumns
+	{
+		utils::ArenaVector<uint32_t> prevBegin, prevIdx;
+		utils::ArenaVector<uint8_t> spaced;
+
+		GraphColumns(const KGraphNode* graph, size_t graphSize)
+		{
+			prevBegin.reserve(graphSize + 1);
+			for (size_t i = 0; i < graphSize; ++i)
+			{
+				prevBegin.emplace_back(prevIdx.size());
+				for (auto* prev = graph[i].getPrev(); prev; prev = prev->getSibling())
+				{
+					prevIdx.emplace_back(prev - graph);
+					spaced.emplace_back(prev->endPos < graph[i].startPos ? 1 : 0);
+				}
+			}
+			prevBegin.emplace_back(prevIdx.size());
+		}
+	};
+
 	static constexpr uint8_t commonRootId = -1;
 
 	template<class LmState>
@@ -369,11 +412,26 @@ namespace kiwi
 
 	struct RuleBasedScorer
 	{
+		/**
+		 * @brief 선행 형태소에 대해 규칙 점수 계산에 쓰이는 성질들. `prevFeatures`가 이 비트들의 조합을 반환한다.
+		 */
+		enum : uint8_t
+		{
+			prevIrregular = 1 << 0,
+			prevInflectendaNP = 1 << 1,
+			prevVerbL = 1 << 2,
+			prevNotPositiveVerb = 1 << 3,
+			prevVerbVowel = 1 << 4,
+			prevAdjective = 1 << 5,
+			prevNonFinalE = 1 << 6,
+		};
+
 		Kiwi::SpecialMorph curMorphSpecialType;
 		size_t curMorphSbType;
 		int curMorphSbOrder;
 		bool vowelE, infJ, badPairOfL, positiveE, contractableE;
 		CondPolarity condP;
+		uint8_t ruleMask;
 
 		RuleBasedScorer(const Kiwi* kw, const Morpheme* curMorph, const KGraphNode* node)
 			:
@@ -385,44 +443,54 @@ namespace kiwi
 			badPairOfL{ isBadPairOfVerbL(curMorph) },
 			positiveE{ isEClass(curMorph->tag) && node->form && node->form->form[0] == u'아' },
 			contractableE{ isEClass(curMorph->tag) && curMorph->kform && !curMorph->kform->empty() && (*curMorph->kform)[0] == u'어' },
-			condP{ curMorph->polar }
+			condP{ curMorph->polar },
+			ruleMask{ (uint8_t)(
+				(vowelE ? prevIrregular : 0)
+				| (infJ ? prevInflectendaNP : 0)
+				| (badPairOfL ? prevVerbL : 0)
+				| (positiveE ? prevNotPositiveVerb : 0)
+				| (contractableE ? prevVerbVowel : 0)
+				| (condP == CondPolarity::non_adj ? prevAdjective : 0)
+				| (curMorphSbType ? prevNonFinalE : 0)
+			) }
+		{
+		}
+
+		static uint8_t prevFeatures(const Morpheme* prevMorpheme)
 		{
+			uint8_t ret = 0;
+			if (isIrregular(prevMorpheme->tag)) ret |= prevIrregular;
+			if (isInflectendaNP(prevMorpheme)) ret |= prevInflectendaNP;
+			if (isVerbL(prevMorpheme)) ret |= prevVerbL;
+			if (!isPositiveVerb(prevMorpheme)) ret |= prevNotPositiveVerb;
+			if (isVerbVowel(prevMorpheme)) ret |= prevVerbVowel;
+			if (prevMorpheme->tag == POSTag::va || prevMorpheme->tag == POSTag::xsa) ret |= prevAdjective;
+			if (isEClass(prevMorpheme->tag) && prevMorpheme->tag != POSTag::ef) ret |= prevNonFinalE;
+			return ret;
 		}
 
 		float operator()(const Morpheme* prevMorpheme, const SpecialState prevSpState) const
 		{
+			return (*this)(prevFeatures(prevMorpheme), prevSpState);
+		}
+
+		float operator()(uint8_t prevFeats, const SpecialState prevSpState) const
+		{
+			const uint8_t hit = prevFeats & ruleMask;
 			float accScore = 0;
 
 			// 불규칙 활용 형태소 뒤에 모음 어미가 붙는 경우 벌점 부여
-			if (vowelE && isIrregular(prevMorpheme->tag))
-			{
-				accScore -= 10;
-			}
+			accScore -= (hit & prevIrregular) ? 10 : 0;
 			// 나/너/저 뒤에 주격 조사 '가'가 붙는 경우 벌점 부여
-			if (infJ && isInflectendaNP(prevMorpheme))
-			{
-				accScore -= 5;
-			}
+			accScore -= (hit & prevInflectendaNP) ? 5 : 0;
 			// ㄹ 받침 용언 뒤에 으/느/ㅅ으로 시작하는 형태소가 올 경우 벌점 부여
-			if (badPairOfL && isVerbL(prevMorpheme))
-			{
-				accScore -= 7;
-			}
+			accScore -= (hit & prevVerbL) ? 7 : 0;
 			// 동사 뒤가 아니거나, 앞의 동사가 양성이 아닌데, 양성모음용 어미가 등장한 경우 벌점 부여
-			if (positiveE && !isPositiveVerb(prevMorpheme))
-			{
-				accScore -= 100;
-			}
+			accScore -= (hit & prevNotPositiveVerb) ? 100 : 0;
 			// 아/어로 시작하는 어미가 받침 없는 동사 뒤에서 축약되지 않은 경우 벌점 부여
-			if (contractableE && isVerbVowel(prevMorpheme))
-			{
-				accScore -= 3;
-			}
+			accScore -= (hit & prevVerbVowel) ? 3 : 0;
 			// 형용사 사용 불가 어미인데 형용사 뒤에 등장
-			if (condP == CondPolarity::non_adj && (prevMorpheme->tag == POSTag::va || prevMorpheme->tag == POSTag::xsa))
-			{
-				accScore -= 10;
-			}
+			accScore -= (hit & prevAdjective) ? 10 : 0;
 			if (curMorphSpecialType <= Kiwi::SpecialMorph::singleQuoteNA)
 			{
 				if (static_cast<uint8_t>(curMorphSpecialType) != prevSpState.singleQuote)
@@ -444,10 +512,7 @@ namespace kiwi
 				accScore -= 5;
 			}
 
-			if (curMorphSbType && isEClass(prevMorpheme->tag) && prevMorpheme->tag != POSTag::ef)
-			{
-				accScore -= 10;
-			}
+			accScore -= (hit & prevNonFinalE) ? 10 : 0;
 
 			if (curMorphSbType && prevSpState.bulletHash == hashSbTypeOrder(curMorphSbType, curMorphSbOrder))
 			{
@@ -458,6 +523,66 @@ namespace kiwi
 		}
 	};
 
+	/**
+	 * @brief 탐색이 끝난 노드들의 경로 중 다음 형태소 후보를 거를 때 필요한 값만 모아둔 SoA 저장소.
+	 * @details i번 노드의 경로들은 begin[i]부터 begin[i + 1] - 1까지에 cache[i]와 같은 순서로 들어 있다.
+	 * 노드의 탐색이 끝날 때마다 `append`로 차례대로 추가되므로 아직 탐색 중인 노드의 경로는 들어 있지 않다.
+	 */
+	template<class LmState>
+	struct BeamColumns
+	{
+		enum : uint8_t
+		{
+			zSiot = 1, /**< 사이시옷으로 끝나는 경로 */
+			leftSsc = 2, /**< 닫는 괄호로 끝나서 좌측 결합조건을 적용하지 않는 경로 */
+		};
+
+		utils::ArenaVector<uint32_t> begin;
+		utils::ArenaVector<float> accScore;
+		utils::ArenaVector<uint8_t> flags, combineSocket, ruleFeatures;
+		utils::ArenaVector<uint16_t> condMask;
+
+		BeamColumns(size_t graphSize)
+		{
+			begin.reserve(graphSize + 1);
+			begin.emplace_back(0);
+		}
+
+		void append(const utils::ArenaVector<WordLL<LmState>>& paths, const Morpheme* morphBase, const PathEvaluator::FormList& ownForms)
+		{
+			for (auto& p : paths)
+			{
+				const kchar_t* first, * last;
+				if (p.ownFormId)
+				{
+					first = ownForms[p.ownFormId - 1].data();
+					last = first + ownForms[0].size();
+				}
+				else if (morphBase[p.wid].kform && !morphBase[p.wid].kform->empty())
+				{
+					first = morphBase[p.wid].kform->data();
+					last = first + morphBase[p.wid].kform->size();
+				}
+				else
+				{
+					first = p.morpheme->getForm().data();
+					last = first + p.morpheme->getForm().size();
+				}
+
+				uint8_t f = 0;
+				if (p.morpheme->tag == POSTag::z_siot) f |= zSiot;
+				if (p.morpheme->tag == POSTag::ssc || (first < last && identifySpecialChr(last[-1]) == POSTag::ssc)) f |= leftSsc;
+
+				accScore.emplace_back(p.accScore);
+				flags.emplace_back(f);
+				combineSocket.emplace_back(p.combineSocket);
+				ruleFeatures.emplace_back(RuleBasedScorer::prevFeatures(&morphBase[p.wid]));
+				condMask.emplace_back(FeatureTestor::condMask(first, last));
+			}
+			begin.emplace_back(accScore.size());
+		}
+	};
+
 	inline bool isQuote(Kiwi::SpecialMorph m)
 	{
 		return m == Kiwi::SpecialMorph::singleQuoteOpen || m == Kiwi::SpecialMorph::singleQuoteClose
@@ -514,7 +639,7 @@ namespace kiwi
 			}
 		}
 
-		inline void writeTo(Vector<WordLL<LmState>>& resultOut, const Morpheme* curMorph, Wid lastSeqId, size_t ownFormId)
+		inline void writeTo(utils::ArenaVector<WordLL<LmState>>& resultOut, const Morpheme* curMorph, Wid lastSeqId, size_t ownFormId)
 		{
 			for (auto& p : bestPathIndex)
 			{
@@ -563,7 +688,7 @@ namespace kiwi
 			}
 		}
 
-		inline void writeTo(Vector<WordLL<LmState>>& resultOut, const Morpheme* curMorph, Wid lastSeqId, size_t ownFormId)
+		inline void writeTo(utils::ArenaVector<WordLL<LmState>>& resultOut, const Morpheme* curMorph, Wid lastSeqId, size_t ownFormId)
 		{
 			for (auto& p : bestPathes)
 			{
@@ -615,7 +740,7 @@ namespace kiwi
 			}
 		}
 
-		inline void writeTo(Vector<WordLL<LmState>>& resultOut, const Morpheme* curMorph, Wid lastSeqId, size_t ownFormId)
+		inline void writeTo(utils::ArenaVector<WordLL<LmState>>& resultOut, const Morpheme* curMorph, Wid lastSeqId, size_t ownFormId)
 		{
 			for (auto& p : bestPathValuesSmall)
 			{
@@ -635,10 +760,10 @@ namespace kiwi
 
 	template<PathEvaluatingMode mode, class LmState>
 	void PathEvaluator::evalSingleMorpheme(
-		Vector<WordLL<LmState>>& resultOut,
+		utils::ArenaVector<WordLL<LmState>>& resultOut,
 		const Kiwi* kw,
-		const Vector<U16StringView>& ownForms,
-		const Vector<Vector<WordLL<LmState>>>& cache,
+		const FormList& ownForms,
+		const PathCache<LmState>& cache,
 		size_t ownFormId,
 		const Morpheme* curMorph,
 		const KGraphNode* node,
@@ -646,6 +771,8 @@ namespace kiwi
 		const size_t topN,
 		const float ignoreCondScore,
 		const float nodeLevelDiscount,
+		const GraphColumns& graphCols,
+		const BeamColumns<LmState>& beams,
 		const Vector<SpecialState>& prevSpStates
 	)
 	{
@@ -653,7 +780,7 @@ namespace kiwi
 		thread_local Vector<uint8_t> rootIds;
 
 		const LangModel& langMdl = kw->langMdl;
-		const Morpheme* morphBase = kw->morphemes.data();
+		const Morpheme* morphBase = kw->vocab->morphemes.data();
 		const auto spacePenalty = kw->spacePenalty;
 		const bool allowedSpaceBetweenChunk = kw->spaceTolerance > 0;
 
@@ -674,9 +801,9 @@ namespace kiwi
 		}
 
 		Wid lastSeqId;
-		if (within(lastMorph, kw->morphemes.data() + langVocabSize, kw->morphemes.data() + kw->morphemes.size()))
+		if (within(lastMorph, kw->vocab->morphemes.data() + langVocabSize, kw->vocab->morphemes.data() + kw->vocab->morphemes.size()))
 		{
-			lastSeqId = lastMorph - kw->morphemes.data();
+			lastSeqId = lastMorph - kw->vocab->morphemes.data();
 		}
 		else
 		{
@@ -689,133 +816,167 @@ namespace kiwi
 
 		RuleBasedScorer ruleBasedScorer{ kw, curMorph, node };
 
-		for (auto* prev = node->getPrev(); prev; prev = prev->getSibling())
+		const bool hasChunks = !(curMorph->chunks.empty() || curMorph->complex || curMorph->saisiot);
+		const bool skipLm = curMorph->combineSocket && !hasChunks;
+		bool prohibitedChunk = false;
+		if (hasChunks)
 		{
-			for (auto& prevPath : cache[prev - startNode])
+			for (size_t i = 1; i < curMorph->chunks.size(); ++i)
 			{
-				// 사이시옷 뒤에 명사가 아닌 태그가 오거나 공백이 있는 경우 제외
-				if (prevPath.morpheme->tag == POSTag::z_siot && (
-					!isNNClass(curMorph->tag) || prev->endPos < node->startPos
-					))
-				{
-					continue;
-				}
+				// prohibit <v> without <chunk>
+				if (morphBase[curMorph->chunks[i]->lmMorphemeId].tag == POSTag::p) prohibitedChunk = true;
+			}
+		}
 
-				float candScore = prevPath.accScore + additionalScore;
-				if (prevPath.combineSocket)
+		// 이전 경로들로부터 현재 형태소로 이어지는 후보를 먼저 모두 모은 뒤, LM 점수를 한꺼번에 계산한다.
+		thread_local Vector<const WordLL<LmState>*> candPrevs;
+		thread_local Vector<float> candScores;
+		thread_local Vector<LmState> candStates;
+		thread_local Vector<Wid> candWids;
+		thread_local Vector<float> candLls;
+		candPrevs.clear();
+		candScores.clear();
+		candStates.clear();
+		candWids.clear();
+
+		thread_local Vector<uint8_t> candRuleFeats;
+		thread_local Vector<uint8_t> beamStates;
+		thread_local Vector<float> beamAdjs;
+		candRuleFeats.clear();
+
+		// 아래 조건을 만족하면 어떤 이전 경로도 후보가 될 수 없으므로 탐색을 생략한다.
+		const bool noCands = !skipLm && prohibitedChunk;
+
+		const CondVowel cvowel = curMorph->vowel;
+		const CondPolarity cpolar = curMorph->polar;
+		const uint8_t curSocket = curMorph->combineSocket;
+		const bool curIsNN = isNNClass(curMorph->tag);
+		const size_t nodeIdx = node - startNode;
+		for (size_t e = graphCols.prevBegin[nodeIdx]; !noCands && e < graphCols.prevBegin[nodeIdx + 1]; ++e)
+		{
+			const size_t prevIdx = graphCols.prevIdx[e];
+			const bool spaced = !!graphCols.spaced[e];
+			const auto* prevPaths = cache[prevIdx].data();
+			const size_t beamFirst = beams.begin[prevIdx], beamLast = beams.begin[prevIdx + 1];
+			const size_t beamSize = beamLast - beamFirst;
+			const uint8_t* flags = beams.flags.data() + beamFirst;
+			const uint8_t* sockets = beams.combineSocket.data() + beamFirst;
+			const uint16_t* condMasks = beams.condMask.data() + beamFirst;
+			const float* accScores = beams.accScore.data() + beamFirst;
+
+			// 사이시옷 뒤에 명사가 아닌 태그가 오거나 공백이 있는 경우 제외
+			const uint8_t siotBlocked = (!curIsNN || spaced) ? BeamColumns<LmState>::zSiot : 0;
+			// merge <v> <chunk> with only the same socket
+			const bool socketSpaceOk = !spaced || allowedSpaceBetweenChunk;
+			const float socketPenalty = spaced ? spacePenalty : 0;
+
+			// 1단계: 분기 없이 경로 전체에 대해 통과 여부와 점수 보정값을 계산한다.
+			// beamStates는 0이면 제외, 1이면 소켓 검사까지만 통과, 2이면 모든 조건을 통과함을 뜻한다.
+			beamStates.resize(beamSize);
+			beamAdjs.resize(beamSize);
+			for (size_t b = 0; b < beamSize; ++b)
+			{
+				const uint8_t f = flags[b];
+				const uint8_t socket = sockets[b];
+				const bool siotOk = !(f & siotBlocked);
+				const bool socketOk = !socket || (socket == curSocket && hasChunks && socketSpaceOk);
+				// 이전 형태소가 닫는 괄호인 경우 좌측 결합조건을 적용하지 않음
+				const bool condOk = (f & BeamColumns<LmState>::leftSsc) || FeatureTestor::isMatched(condMasks[b], cvowel, cpolar);
+				const bool pre = siotOk && socketOk;
+				beamStates[b] = (uint8_t)pre + (uint8_t)(pre && (condOk || ignoreCondScore));
+				beamAdjs[b] = accScores[b] + additionalScore
+					- (socket ? socketPenalty : 0)
+					+ (condOk ? 0 : ignoreCondScore);
+			}
+
+			// 2단계: 통과한 경로만 후보로 모은다.
+			for (size_t b = 0; b < beamSize; ++b)
+			{
+				if (!beamStates[b]) continue;
+				const auto& prevPath = prevPaths[b];
+				if (sockets[b])
 				{
-					// merge <v> <chunk> with only the same socket
-					if (prevPath.combineSocket != curMorph->combineSocket || (curMorph->chunks.empty() || curMorph->complex || curMorph->saisiot))
-					{
-						continue;
-					}
-					if (prev->endPos < node->startPos)
-					{
-						if (allowedSpaceBetweenChunk) candScore -= spacePenalty;
-						else continue;
-					}
 					firstWid = morphBase[prevPath.wid].getCombined()->lmMorphemeId;
 				}
+				if (beamStates[b] < 2) continue;
 
-				const kchar_t* leftFormFirst, * leftFormLast;
-				if (prevPath.ownFormId)
+				if (!skipLm)
 				{
-					leftFormFirst = ownForms[prevPath.ownFormId - 1].data();
-					leftFormLast = leftFormFirst + ownForms[0].size();
-				}
-				else if (morphBase[prevPath.wid].kform && !morphBase[prevPath.wid].kform->empty())
-				{
-					leftFormFirst = morphBase[prevPath.wid].kform->data();
-					leftFormLast = leftFormFirst + morphBase[prevPath.wid].kform->size();
-				}
-				else
-				{
-					leftFormFirst = prevPath.morpheme->getForm().data();
-					leftFormLast = leftFormFirst + prevPath.morpheme->getForm().size();
+					// prohibit <v> without <chunk>
+					if (morphBase[firstWid].tag == POSTag::p) continue;
 				}
 
-				const CondVowel cvowel = curMorph->vowel;
-				const CondPolarity cpolar = curMorph->polar;
-				const bool leftFormEndswithSSC = leftFormFirst < leftFormLast && identifySpecialChr(leftFormLast[-1]) == POSTag::ssc;
-				if (prevPath.morpheme->tag == POSTag::ssc || leftFormEndswithSSC)
-				{
-					// 이전 형태소가 닫는 괄호인 경우 좌측 결합조건을 적용하지 않음
-				}
-				else if (ignoreCondScore)
-				{
-					candScore += FeatureTestor::isMatched(leftFormFirst, leftFormLast, cvowel, cpolar) ? 0 : ignoreCondScore;
-				}
-				else
-				{
-					if (!FeatureTestor::isMatched(leftFormFirst, leftFormLast, cvowel, cpolar)) continue;
-				}
+				candPrevs.emplace_back(&prevPath);
+				candScores.emplace_back(beamAdjs[b]);
+				candStates.emplace_back(prevPath.lmState);
+				candWids.emplace_back(firstWid);
+				candRuleFeats.emplace_back(beams.ruleFeatures[beamFirst + b]);
+			}
+		}
 
-				auto cLmState = prevPath.lmState;
-				if (curMorph->combineSocket && (curMorph->chunks.empty() || curMorph->complex || curMorph->saisiot))
-				{
-					// no-op
-				}
-				else
+		const size_t numCands = candPrevs.size();
+		if (kw->collectStats)
+		{
+			auto& stats = Kiwi::localStats();
+			stats[Kiwi::statNumPathsEvaluated] += numCands;
+			if (!skipLm) stats[Kiwi::statNumLmCalls] += numCands * (hasChunks ? curMorph->chunks.size() : 1);
+		}
+		if (!skipLm && numCands)
+		{
+			auto& lmCache = LmTransitionCache::local();
+			auto* lmCachePtr = lmCache.enabled() ? &lmCache : nullptr;
+			candLls.resize(numCands);
+			LmState::nextN(langMdl, candStates.data(), candWids.data(), candLls.data(), numCands, lmCachePtr);
+			for (size_t k = 0; k < numCands; ++k) candScores[k] += candLls[k];
+			if (hasChunks)
+			{
+				for (size_t i = 1; i < curMorph->chunks.size(); ++i)
 				{
-					if (morphBase[firstWid].tag == POSTag::p)
-					{
-						// prohibit <v> without <chunk>
-						goto continueFor;
-					}
-					float ll = cLmState.next(langMdl, firstWid);
-					candScore += ll;
-					if (!(curMorph->chunks.empty() || curMorph->complex || curMorph->saisiot))
-					{
-						for (size_t i = 1; i < curMorph->chunks.size(); ++i)
-						{
-							const auto wid = curMorph->chunks[i]->lmMorphemeId;
-							if (morphBase[wid].tag == POSTag::p)
-							{
-								// prohibit <v> without <chunk>
-								goto continueFor;
-							}
-							ll = cLmState.next(langMdl, wid);
-							candScore += ll;
-						}
-					}
+					std::fill(candWids.begin(), candWids.end(), curMorph->chunks[i]->lmMorphemeId);
+					LmState::nextN(langMdl, candStates.data(), candWids.data(), candLls.data(), numCands, lmCachePtr);
+					for (size_t k = 0; k < numCands; ++k) candScores[k] += candLls[k];
 				}
+			}
+		}
 
-				if ((ruleBasedScorer.curMorphSbType || isQuote(ruleBasedScorer.curMorphSpecialType)) && prevPath.rootId == commonRootId)
-				{
-					rootIds.resize(prevSpStates.size());
-					iota(rootIds.begin(), rootIds.end(), 0);
-				}
-				else
+		for (size_t k = 0; k < numCands; ++k)
+		{
+			auto& prevPath = *candPrevs[k];
+			const float candScore = candScores[k];
+			auto& cLmState = candStates[k];
+
+			if ((ruleBasedScorer.curMorphSbType || isQuote(ruleBasedScorer.curMorphSpecialType)) && prevPath.rootId == commonRootId)
+			{
+				rootIds.resize(prevSpStates.size());
+				iota(rootIds.begin(), rootIds.end(), 0);
+			}
+			else
+			{
+				rootIds.resize(1);
+				rootIds[0] = commonRootId;
+			}
+
+			for (auto rootId : rootIds)
+			{
+				auto spState = prevPath.spState;
+				if (rootId != commonRootId)
 				{
-					rootIds.resize(1);
-					rootIds[0] = commonRootId;
+					spState = prevSpStates[rootId];
 				}
-
-				for (auto rootId : rootIds)
+				const float candScoreWithRule = candScore + ruleBasedScorer(candRuleFeats[k], spState);
+
+				// update special state
+				if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::singleQuoteOpen) spState.singleQuote = 1;
+				else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::singleQuoteClose) spState.singleQuote = 0;
+				else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::doubleQuoteOpen) spState.doubleQuote = 1;
+				else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::doubleQuoteClose) spState.doubleQuote = 0;
+				if (ruleBasedScorer.curMorphSbType)
 				{
-					const auto* prevMorpheme = &morphBase[prevPath.wid];
-					auto spState = prevPath.spState;
-					if (rootId != commonRootId)
-					{
-						spState = prevSpStates[rootId];
-					}
-					const float candScoreWithRule = candScore + ruleBasedScorer(prevMorpheme, spState);
-
-					// update special state
-					if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::singleQuoteOpen) spState.singleQuote = 1;
-					else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::singleQuoteClose) spState.singleQuote = 0;
-					else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::doubleQuoteOpen) spState.doubleQuote = 1;
-					else if (ruleBasedScorer.curMorphSpecialType == Kiwi::SpecialMorph::doubleQuoteClose) spState.doubleQuote = 0;
-					if (ruleBasedScorer.curMorphSbType)
-					{
-						spState.bulletHash = hashSbTypeOrder(ruleBasedScorer.curMorphSbType, ruleBasedScorer.curMorphSbOrder + 1);
-					}
-
-					PathHash<LmState> ph{ cLmState, prevPath.rootId, spState };
-					bestPathCont.insert(ph, topN, rootId, curMorph, candScoreWithRule, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState);
+					spState.bulletHash = hashSbTypeOrder(ruleBasedScorer.curMorphSbType, ruleBasedScorer.curMorphSbOrder + 1);
 				}
 
-			continueFor:;
+				PathHash<LmState> ph{ cLmState, prevPath.rootId, spState };
+				bestPathCont.insert(ph, topN, rootId, curMorph, candScoreWithRule, prevPath.accTypoCost + node->typoCost, &prevPath, move(cLmState), spState);
 			}
 		}
 
@@ -828,12 +989,14 @@ namespace kiwi
 		const KGraphNode* startNode,
 		const KGraphNode* node,
 		const size_t topN,
-		Vector<Vector<WordLL<LmState>>>& cache,
-		const Vector<U16StringView>& ownFormList,
+		PathCache<LmState>& cache,
+		const FormList& ownFormList,
 		size_t i,
 		size_t ownFormId,
 		CandTy&& cands,
 		bool unknownForm,
+		const GraphColumns& graphCols,
+		const BeamColumns<LmState>& beams,
 		const Vector<SpecialState>& prevSpStates,
 		bool splitComplex,
 		bool splitSaisiot,
@@ -861,9 +1024,10 @@ namespace kiwi
 		const float nodeLevelDiscount = whitespaceDiscount + typoDiscount + unknownFormDiscount;
 
 		size_t totalPrevPathes = 0;
-		for (auto* prev = node->getPrev(); prev; prev = prev->getSibling())
+		for (size_t e = graphCols.prevBegin[i]; e < graphCols.prevBegin[i + 1]; ++e)
 		{
-			totalPrevPathes += cache[prev - startNode].size();
+			const size_t prevIdx = graphCols.prevIdx[e];
+			totalPrevPathes += beams.begin[prevIdx + 1] - beams.begin[prevIdx];
 		}
 		const bool useContainerForSmall = totalPrevPathes <= 48;
 
@@ -881,14 +1045,14 @@ namespace kiwi
 					{
 						for (auto& p : cache[prev - startNode])
 						{
-							auto lastTag = kw->morphemes[p.wid].tag;
+							auto lastTag = kw->vocab->morphemes[p.wid].tag;
 							if (!isJClass(lastTag) && !isEClass(lastTag)) continue;
 							nCache.emplace_back(p);
 							auto& newPath = nCache.back();
 							newPath.accScore += curMorph->userScore * kw->typoCostWeight;
 							newPath.accTypoCost -= curMorph->userScore;
 							newPath.parent = &p;
-							newPath.morpheme = &kw->morphemes[curMorph->lmMorphemeId];
+							newPath.morpheme = &kw->vocab->morphemes[curMorph->lmMorphemeId];
 							newPath.wid = curMorph->lmMorphemeId;
 						}
 					}
@@ -906,14 +1070,14 @@ namespace kiwi
 					{
 						for (auto& p : cache[prev - startNode])
 						{
-							auto lastTag = kw->morphemes[p.wid].tag;
+							auto lastTag = kw->vocab->morphemes[p.wid].tag;
 							if (!isNNClass(lastTag)) continue;
 							nCache.emplace_back(p);
 							auto& newPath = nCache.back();
 							newPath.accScore += curMorph->userScore * kw->typoCostWeight;
 							newPath.accTypoCost -= curMorph->userScore;
 							newPath.parent = &p;
-							newPath.morpheme = &kw->morphemes[curMorph->lmMorphemeId];
+							newPath.morpheme = &kw->vocab->morphemes[curMorph->lmMorphemeId];
 							newPath.wid = curMorph->lmMorphemeId;
 						}
 					}
@@ -940,19 +1104,19 @@ namespace kiwi
 				{
 					evalSingleMorpheme<PathEvaluatingMode::topN>(nCache, kw, ownFormList, cache, 
 						ownFormId, curMorph, 
-						node, startNode, topN, ignoreCond ? -10 : 0, nodeLevelDiscount, prevSpStates);
+						node, startNode, topN, ignoreCond ? -10 : 0, nodeLevelDiscount, graphCols, beams, prevSpStates);
 				}
 				else if (useContainerForSmall)
 				{
 					evalSingleMorpheme<PathEvaluatingMode::top1Small>(nCache, kw, ownFormList, cache, 
 						ownFormId, curMorph, 
-						node, startNode, topN, ignoreCond ? -10 : 0, nodeLevelDiscount, prevSpStates);
+						node, startNode, topN, ignoreCond ? -10 : 0, nodeLevelDiscount, graphCols, beams, prevSpStates);
 				}
 				else
 				{
 					evalSingleMorpheme<PathEvaluatingMode::top1>(nCache, kw, ownFormList, cache,
 						ownFormId, curMorph,
-						node, startNode, topN, ignoreCond ? -10 : 0, nodeLevelDiscount, prevSpStates);
+						node, startNode, topN, ignoreCond ? -10 : 0, nodeLevelDiscount, graphCols, beams, prevSpStates);
 				}
 				
 			}
@@ -995,6 +1159,7 @@ namespace kiwi
 			if (validCount != i) nCache[validCount] = move(nCache[i]);
 			validCount++;
 		}
+		if (kw->collectStats) Kiwi::localStats()[Kiwi::statNumPathsPruned] += nCache.size() - validCount;
 		nCache.resize(validCount);
 	}
 
@@ -1003,13 +1168,13 @@ namespace kiwi
 	inline PathEvaluator::Path generateTokenList(const WordLL<LmState>* result,
 		const utils::ContainerSearcher<WordLL<LmState>>& csearcher,
 		const KGraphNode* graph,
-		const Vector<U16StringView>& ownFormList,
+		const PathEvaluator::FormList& ownFormList,
 		float typoCostWeight,
 		const Morpheme* morphFirst,
 		size_t langVocabSize,
 		bool splitSaisiot)
 	{
-		Vector<const WordLL<LmState>*> steps;
+		utils::ArenaVector<const WordLL<LmState>*> steps;
 		for (auto s = result->parent; s->parent; s = s->parent)
 		{
 			steps.emplace_back(s);
@@ -1128,9 +1293,10 @@ namespace kiwi
 	{
 		static constexpr size_t eosId = 1;
 
-		Vector<Vector<WordLL<LmState>>> cache(graphSize);
-		Vector<U16StringView> ownFormList;
-		Vector<const Morpheme*> unknownNodeCands, unknownNodeLCands;
+		utils::Arena::Scope arenaScope{ utils::Arena::local() };
+		PathCache<LmState> cache(graphSize);
+		FormList ownFormList;
+		utils::ArenaVector<const Morpheme*> unknownNodeCands, unknownNodeLCands;
 
 		const size_t langVocabSize = kw->langMdl.knlm->getHeader().vocab_size;
 
@@ -1141,6 +1307,9 @@ namespace kiwi
 		unknownNodeCands.emplace_back(kw->getDefaultMorpheme(POSTag::nnp));
 		unknownNodeLCands.emplace_back(kw->getDefaultMorpheme(POSTag::nnp));
 
+		auto& lmCache = LmTransitionCache::local();
+		lmCache.prepare(kw->langMdl.knlm->getInstanceId(), kw->lmCacheSize);
+
 		auto uniqStates = prevSpStates;
 		sort(uniqStates.begin(), uniqStates.end());
 		uniqStates.erase(unique(uniqStates.begin(), uniqStates.end()), uniqStates.end());
@@ -1150,9 +1319,13 @@ namespace kiwi
 		}
 
 		// start node
-		cache[0].emplace_back(&kw->morphemes[0], 0.f, 0.f, nullptr, LmState{ kw->langMdl }, SpecialState{});
+		cache[0].emplace_back(&kw->vocab->morphemes[0], 0.f, 0.f, nullptr, LmState{ kw->langMdl }, SpecialState{});
 		cache[0].back().rootId = commonRootId;
 
+		const GraphColumns graphCols{ graph, graphSize };
+		BeamColumns<LmState> beams{ graphSize };
+		beams.append(cache[0], kw->vocab->morphemes.data(), ownFormList);
+
 #ifdef DEBUG_PRINT
 		cerr << "Token[" << 0 << "]" << endl;
 		for (auto& tt : cache[0])
@@ -1178,7 +1351,7 @@ namespace kiwi
 			{
 				evalPath<LmState>(kw, startNode, node, topN, cache, 
 					ownFormList, i, ownFormId, node->form->candidate, 
-					false, uniqStates, splitComplex, splitSaisiot, mergeSaisiot, blocklist);
+					false, graphCols, beams, uniqStates, splitComplex, splitSaisiot, mergeSaisiot, blocklist);
 				if (all_of(node->form->candidate.begin(), node->form->candidate.end(), [](const Morpheme* m)
 				{
 					return m->combineSocket || !(m->chunks.empty() || m->complex || m->saisiot);
@@ -1188,15 +1361,16 @@ namespace kiwi
 					ownFormId = ownFormList.size();
 					evalPath<LmState>(kw, startNode, node, topN, cache, 
 						ownFormList, i, ownFormId, unknownNodeLCands, 
-						true, uniqStates, splitComplex, splitSaisiot, mergeSaisiot, blocklist);
+						true, graphCols, beams, uniqStates, splitComplex, splitSaisiot, mergeSaisiot, blocklist);
 				};
 			}
 			else
 			{
 				evalPath<LmState>(kw, startNode, node, topN, cache, 
 					ownFormList, i, ownFormId, unknownNodeCands, 
-					true, uniqStates, splitComplex, splitSaisiot, mergeSaisiot, blocklist);
+					true, graphCols, beams, uniqStates, splitComplex, splitSaisiot, mergeSaisiot, blocklist);
 			}
+			beams.append(cache[i], kw->vocab->morphemes.data(), ownFormList);
 
 #ifdef DEBUG_PRINT
 			cerr << "Token[" << i << "]" << endl;
@@ -1209,6 +1383,13 @@ namespace kiwi
 #endif
 		}
 
+		if (lmCache.hits || lmCache.misses)
+		{
+			kw->lmCacheCounters[0].fetch_add(lmCache.hits, std::memory_order_relaxed);
+			kw->lmCacheCounters[1].fetch_add(lmCache.misses, std::memory_order_relaxed);
+			lmCache.hits = lmCache.misses = 0;
+		}
+
 		// end node		
 		auto& cand = cache.back();
 		for (auto prev = endNode->getPrev(); prev; prev = prev->getSibling())
@@ -1293,7 +1474,7 @@ namespace kiwi
 			{
 				auto tokens = generateTokenList(
 					&cand[i], csearcher, graph, ownFormList, kw->typoCostWeight,
-					kw->morphemes.data(), langVocabSize, splitSaisiot
+					kw->vocab->morphemes.data(), langVocabSize, splitSaisiot
 				);
 				ret.emplace_back(move(tokens), cand[i].accScore, uniqStates[cand[i].rootId], cand[i].spState);
 			}
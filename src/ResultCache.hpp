@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+#include <kiwi/Kiwi.h>
+
+namespace kiwi
+{
+	/**
+	 * @brief `Kiwi::analyze`의 결과를 입력별로 기억해두는 LRU 캐시.
+	 * @details 여러 스레드에서 동시에 접근할 수 있도록 키의 해시값에 따라 여러 조각(shard)으로 나누고
+	 * 조각마다 별도의 mutex로 보호한다. 키에는 입력 문자열뿐만 아니라 분석 결과에 영향을 주는
+	 * 모든 인자와 `Kiwi`의 설정 버전이 포함되므로, 설정이 바뀐 뒤에는 이전 항목이 다시 사용되지 않고
+	 * LRU 순서에 따라 밀려난다.
+	 */
+	class ResultCache
+	{
+		using Value = std::shared_ptr<const std::vector<TokenResult>>;
+
+		struct Entry
+		{
+			std::u16string key;
+			size_t hash;
+			Value value;
+		};
+
+		struct Shard
+		{
+			std::mutex mtx;
+			std::list<Entry> entries;
+			std::unordered_multimap<size_t, std::list<Entry>::iterator> index;
+			size_t hits = 0, misses = 0, evictions = 0;
+		};
+
+		static constexpr size_t numShards = 16;
+		std::unique_ptr<Shard[]> shards;
+		size_t shardCapacity = 0;
+
+		Shard& shardOf(size_t hash) const
+		{
+			return shards[(hash >> 8) % numShards];
+		}
+
+		static void appendRaw(std::u16string& out, const void* data, size_t size)
+		{
+			const size_t pos = out.size();
+			out.resize(pos + (size + 1) / 2);
+			std::memcpy(&out[pos], data, size);
+		}
+
+		template<class Ty>
+		static void appendValue(std::u16string& out, const Ty& v)
+		{
+			appendRaw(out, &v, sizeof(Ty));
+		}
+
+	public:
+		/**
+		 * @brief blocklist에 담긴 형태소들을 정렬된 순서로 키에 덧붙인다.
+		 * @details 집합의 주소가 아니라 내용으로 구분해야 같은 집합을 제자리에서 수정했거나
+		 * 해제된 집합의 주소에 새 집합이 할당된 경우에도 이전 결과가 잘못 재사용되지 않는다.
+		 * 형태소 포인터는 한 `Kiwi` 안에서 형태소마다 고유하므로 그 값을 형태소 id로 사용한다.
+		 */
+		static void appendBlocklist(std::u16string& out, const std::unordered_set<const Morpheme*>* blocklist)
+		{
+			if (!blocklist || blocklist->empty())
+			{
+				appendValue(out, (uint64_t)0);
+				return;
+			}
+			std::vector<uintptr_t> ids;
+			ids.reserve(blocklist->size());
+			for (auto* m : *blocklist) ids.emplace_back(reinterpret_cast<uintptr_t>(m));
+			std::sort(ids.begin(), ids.end());
+			appendValue(out, (uint64_t)ids.size());
+			appendRaw(out, ids.data(), ids.size() * sizeof(uintptr_t));
+		}
+
+		ResultCache(size_t capacity)
+			: shards{ new Shard[numShards] }, shardCapacity{ std::max((capacity + numShards - 1) / numShards, (size_t)1) }
+		{
+		}
+
+		/**
+		 * @brief `analyze`의 인자들로부터 캐시 키를 생성한다.
+		 */
+		static void makeKey(std::u16string& out,
+			const std::u16string& str, size_t topN, Match matchOptions,
+			const std::unordered_set<const Morpheme*>* blocklist,
+			const std::vector<PretokenizedSpan>& pretokenized,
+			size_t configVersion,
+			uint64_t overlayGeneration = 0)
+		{
+			out.clear();
+			out.reserve(str.size() + 16);
+			appendValue(out, configVersion);
+			appendValue(out, overlayGeneration);
+			appendValue(out, (uint64_t)topN);
+			appendValue(out, matchOptions);
+			appendBlocklist(out, blocklist);
+			appendValue(out, (uint64_t)pretokenized.size());
+			for (auto& span : pretokenized)
+			{
+				appendValue(out, span.begin);
+				appendValue(out, span.end);
+				appendValue(out, (uint64_t)span.tokenization.size());
+				for (auto& t : span.tokenization)
+				{
+					appendValue(out, t.begin);
+					appendValue(out, t.end);
+					appendValue(out, t.tag);
+					appendValue(out, t.inferRegularity);
+					appendValue(out, (uint64_t)t.form.size());
+					out += t.form;
+				}
+			}
+			out += str;
+		}
+
+		Value find(const std::u16string& key) const
+		{
+			const size_t hash = std::hash<std::u16string>{}(key);
+			auto& shard = shardOf(hash);
+			std::lock_guard<std::mutex> lock{ shard.mtx };
+			auto range = shard.index.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second->key != key) continue;
+				shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+				shard.hits++;
+				return it->second->value;
+			}
+			shard.misses++;
+			return {};
+		}
+
+		void store(std::u16string&& key, Value value)
+		{
+			const size_t hash = std::hash<std::u16string>{}(key);
+			auto& shard = shardOf(hash);
+			std::lock_guard<std::mutex> lock{ shard.mtx };
+			auto range = shard.index.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second->key != key) continue;
+				it->second->value = std::move(value);
+				shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+				return;
+			}
+
+			if (shard.entries.size() >= shardCapacity)
+			{
+				auto last = std::prev(shard.entries.end());
+				auto lr = shard.index.equal_range(last->hash);
+				for (auto it = lr.first; it != lr.second; ++it)
+				{
+					if (it->second != last) continue;
+					shard.index.erase(it);
+					break;
+				}
+				shard.entries.pop_back();
+				shard.evictions++;
+			}
+			shard.entries.emplace_front(Entry{ std::move(key), hash, std::move(value) });
+			shard.index.emplace(hash, shard.entries.begin());
+		}
+
+		ResultCacheStats getStats() const
+		{
+			ResultCacheStats ret;
+			for (size_t i = 0; i < numShards; ++i)
+			{
+				std::lock_guard<std::mutex> lock{ shards[i].mtx };
+				ret.hits += shards[i].hits;
+				ret.misses += shards[i].misses;
+				ret.evictions += shards[i].evictions;
+				ret.size += shards[i].entries.size();
+			}
+			return ret;
+		}
+
+		void resetStats()
+		{
+			for (size_t i = 0; i < numShards; ++i)
+			{
+				std::lock_guard<std::mutex> lock{ shards[i].mtx };
+				shards[i].hits = shards[i].misses = shards[i].evictions = 0;
+			}
+		}
+	};
+}
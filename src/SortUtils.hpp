@@ -5,6 +5,7 @@
 #include <type_traits>
 #include <tuple>
 #include <functional>
+#include <kiwi/ThreadPool.h>
 
 namespace kiwi
 {
@@ -231,8 +232,40 @@ namespace kiwi
 			}
 		}
 
+		/**
+		 * @brief [first, last)를 작업자 수만큼의 구간으로 나누어 각각 정렬한 뒤 병합한다.
+		 * @details 서로 동등한 원소가 없다면 결과는 `std::sort`와 같다. pool이 nullptr이거나 원소가 적으면 `std::sort`를 그대로 호출한다.
+		 */
+		template<class RandomIt, class Cmp = detail::Less>
+		void parallelSort(ThreadPool* pool, RandomIt first, RandomIt last, Cmp cmp = {}, size_t minPartSize = 4096)
+		{
+			const size_t n = std::distance(first, last);
+			const size_t numParts = pool ? std::min(pool->size(), n / std::max(minPartSize, (size_t)1)) : 1;
+			if (numParts <= 1)
+			{
+				std::sort(first, last, cmp);
+				return;
+			}
+
+			std::vector<size_t> bounds(numParts + 1);
+			for (size_t i = 0; i <= numParts; ++i) bounds[i] = n * i / numParts;
+			parallelFor(pool, 0, numParts, [&](size_t, size_t i)
+			{
+				std::sort(first + bounds[i], first + bounds[i + 1], cmp);
+			}, 1);
+
+			for (size_t width = 1; width < numParts; width *= 2)
+			{
+				parallelFor(pool, 0, (numParts + width * 2 - 1) / (width * 2), [&](size_t, size_t i)
+				{
+					const size_t b = i * width * 2, m = std::min(b + width, numParts), e = std::min(b + width * 2, numParts);
+					if (m < e) std::inplace_merge(first + bounds[b], first + bounds[m], first + bounds[e], cmp);
+				}, 1);
+			}
+		}
+
 		template<class InIt, class OutIt, class IdxTy = size_t, class Cmp = detail::Less>
-		void sortWriteInvIdx(InIt first, InIt last, OutIt dest, IdxTy startIdx = 0, Cmp cmp = {})
+		void sortWriteInvIdx(InIt first, InIt last, OutIt dest, IdxTy startIdx = 0, Cmp cmp = {}, ThreadPool* pool = nullptr)
 		{
 			/*std::vector<detail::MovingPair<typename InIt::reference, IdxTy>> sorter;
 			for (IdxTy i = startIdx; first != last; ++first, ++i)
@@ -252,7 +285,7 @@ namespace kiwi
 			{
 				sorter.emplace_back(std::move(*first), i);
 			}
-			std::sort(sorter.begin(), sorter.end());
+			parallelSort(pool, sorter.begin(), sorter.end());
 			for (size_t i = 0; i < sorter.size(); ++i)
 			{
 				*ofirst++ = std::move(sorter[i].first);
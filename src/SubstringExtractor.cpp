@@ -185,7 +185,7 @@ namespace kiwi
 		if (_numWorkers == (size_t)-1) _numWorkers = min(thread::hardware_concurrency(), 8u);
 		if (_numWorkers > 1)
 		{
-			threadPool = make_unique<mp::ThreadPool>(_numWorkers);
+			threadPool = utils::acquireThreadPool(_numWorkers);
 		}
 
 		if (clusters.empty()) return;
@@ -547,11 +547,11 @@ namespace kiwi
 
 	std::vector<NgramExtractor::Candidate> NgramExtractor::extract(size_t maxCandidates, size_t minCnt, size_t maxLength, float minScore, size_t numWorkers) const
 	{
-		unique_ptr<mp::ThreadPool> threadPool;
+		shared_ptr<utils::ThreadPool> threadPool;
 		unique_ptr<mutex> mtx;
 		if (numWorkers > 1)
 		{
-			threadPool = make_unique<mp::ThreadPool>(numWorkers);
+			threadPool = utils::acquireThreadPool(numWorkers);
 			mtx = make_unique<mutex>();
 		}
 
@@ -616,131 +616,128 @@ namespace kiwi
 			ngrams.emplace_back(move(cand));
 			return true;
 		}, threadPool.get());
-		
+
 		const double allTokenCnt = (double)accumulate(unigramCnts.begin(), unigramCnts.end(), (size_t)0);
 
-		mp::runParallel(threadPool.get(), [&](const size_t start, const size_t numWorkers, mp::Barrier*)
+		utils::parallelFor(threadPool.get(), 0, ngrams.size(), [&](size_t, size_t i)
 		{
-			for (size_t i = start; i < ngrams.size(); i += numWorkers)
-			{
-				auto& cand = ngrams[i];
-				const double total = cand.cnt;
-				double invalidLeftCnts = 0, invalidRightCnts = 0;
-				thread_local Vector<double> validLeftTokens, validRightTokens;
-				validLeftTokens.clear();
-				validRightTokens.clear();
-				fi.enumSufficesOfString(0, cand.text.rbegin(), cand.text.rend(), [&](const sais::FmIndex<char16_t>::SuffixTy& s, const sais::FmIndex<char16_t>::TraceTy& t)
+			auto& cand = ngrams[i];
+			const double total = cand.cnt;
+			double invalidLeftCnts = 0, invalidRightCnts = 0;
+			thread_local Vector<double> validLeftTokens, validRightTokens;
+			validLeftTokens.clear();
+			validRightTokens.clear();
+			fi.enumSufficesOfString(0, cand.text.rbegin(), cand.text.rend(), [&](const sais::FmIndex<char16_t>::SuffixTy& s, const sais::FmIndex<char16_t>::TraceTy& t)
+			{
+				if (s.size() != 1) return false;
+				const auto cnt = (double)(t.back().second - t.back().first);
+				if (s[0] > 1)
 				{
-					if (s.size() != 1) return false;
-					const auto cnt = (double)(t.back().second - t.back().first);
-					if (s[0] > 1)
-					{
-						validLeftTokens.push_back(cnt);
-					}
-					else
-					{
-						invalidLeftCnts += cnt;
-					}
-					return false;
-				});
-
-				revFi.enumSufficesOfString(0, cand.text.begin(), cand.text.end(), [&](const sais::FmIndex<char16_t>::SuffixTy& s, const sais::FmIndex<char16_t>::TraceTy& t)
+					validLeftTokens.push_back(cnt);
+				}
+				else
 				{
-					if (s.size() != 1) return false;
-					const auto cnt = (double)(t.back().second - t.back().first);
-					if (s[0] > 1)
-					{
-						validRightTokens.push_back(cnt);
-					}
-					else
-					{
-						invalidRightCnts += cnt;
-					}
-					return false;
-				});
-
-				cand.leftBranch = computeBranchingEntropy(total, invalidLeftCnts, validLeftTokens);
-				cand.rightBranch = computeBranchingEntropy(total, invalidRightCnts, validRightTokens);
+					invalidLeftCnts += cnt;
+				}
+				return false;
+			});
 
-				thread_local Vector<uint32_t> restoredIds;
-				restoredIds.clear();
-				for (auto rit = cand.text.begin(); rit != cand.text.end(); ++rit)
+			revFi.enumSufficesOfString(0, cand.text.begin(), cand.text.end(), [&](const sais::FmIndex<char16_t>::SuffixTy& s, const sais::FmIndex<char16_t>::TraceTy& t)
+			{
+				if (s.size() != 1) return false;
+				const auto cnt = (double)(t.back().second - t.back().first);
+				if (s[0] > 1)
 				{
-					if ((*rit & 0x4000))
-					{
-						const auto merged = (rit[0] & 0x3FFF) | ((rit[1] & 0x3FFF) << 14);
-						restoredIds.push_back(merged);
-						++rit;
-					}
-					else if ((*rit & 0x8000))
-					{
-						throw runtime_error("Invalid token");
-					}
-					else
-					{
-						restoredIds.push_back(*rit);
-					}
+					validRightTokens.push_back(cnt);
 				}
-				cand.tokens.resize(restoredIds.size());
-				for (size_t i = 0; i < restoredIds.size(); ++i)
+				else
 				{
-					cand.tokens[i] = id2morph[restoredIds[i]];
+					invalidRightCnts += cnt;
 				}
+				return false;
+			});
 
-				double pmi = log(cand.cnt / allTokenCnt);
-				for (auto id : restoredIds)
-				{
-					pmi -= log(unigramCnts[id] / allTokenCnt);
-				}
-				cand.npmi = pmi / log(allTokenCnt / cand.cnt) / (restoredIds.size() - 1);
-				const double maxBE = log((double)cand.cnt);
-				cand.score = cand.npmi * min(sqrt(cand.leftBranch * cand.rightBranch) / maxBE, 1.0);
+			cand.leftBranch = computeBranchingEntropy(total, invalidLeftCnts, validLeftTokens);
+			cand.rightBranch = computeBranchingEntropy(total, invalidRightCnts, validRightTokens);
 
-				thread_local Vector<size_t> trace;
-				if (!gatherLmScore)
+			thread_local Vector<uint32_t> restoredIds;
+			restoredIds.clear();
+			for (auto rit = cand.text.begin(); rit != cand.text.end(); ++rit)
+			{
+				if ((*rit & 0x4000))
 				{
-					const auto r = fi.findRange(cand.text.rbegin(), cand.text.rend());
-					const size_t u16size = cand.text.size();
-					cand.text.resize(12);
-					auto* ptr = reinterpret_cast<size_t*>(&cand.text[0]);
-					ptr[0] = r.first;
-					ptr[1] = r.second;
-					ptr[2] = u16size;
+					const auto merged = (rit[0] & 0x3FFF) | ((rit[1] & 0x3FFF) << 14);
+					restoredIds.push_back(merged);
+					++rit;
 				}
-				else if (fi.findTrace(trace, cand.text.rbegin(), cand.text.rend()))
+				else if ((*rit & 0x8000))
 				{
-					cand.tokenScores.resize(cand.tokens.size());
-					int totalAccum = 0;
-					size_t i = 0, t = cand.tokens.size();
-					for (auto it = cand.text.rbegin(); it != cand.text.rend(); ++it, ++i)
-					{
-						if ((*it & 0x8000))
-						{
-							continue;
-						}
-
-						int tokenAccum = 0;
-						for (size_t j = i * cand.cnt; j < (i + 1) * cand.cnt; ++j)
-						{
-							totalAccum += scores[sa[trace[j]]];
-							tokenAccum += scores[sa[trace[j]]];
-						}
-						cand.tokenScores[--t] = (tokenAccum / 1024.f) / cand.cnt;
-					}
-					cand.lmScore = (totalAccum / 1024.f) / cand.cnt / cand.tokens.size();
-					const size_t b = trace.rbegin()[cand.cnt - 1];
-					const size_t e = trace.rbegin()[0] + 1;
-					const size_t u16size = cand.text.size();
-					cand.text.resize(12);
-					auto* ptr = reinterpret_cast<size_t*>(&cand.text[0]);
-					ptr[0] = b;
-					ptr[1] = e;
-					ptr[2] = u16size;
+					throw runtime_error("Invalid token");
 				}
 				else
 				{
-					cand.text.clear();
+					restoredIds.push_back(*rit);
+				}
+			}
+			cand.tokens.resize(restoredIds.size());
+			for (size_t i = 0; i < restoredIds.size(); ++i)
+			{
+				cand.tokens[i] = id2morph[restoredIds[i]];
+			}
+
+			double pmi = log(cand.cnt / allTokenCnt);
+			for (auto id : restoredIds)
+			{
+				pmi -= log(unigramCnts[id] / allTokenCnt);
+			}
+			cand.npmi = pmi / log(allTokenCnt / cand.cnt) / (restoredIds.size() - 1);
+			const double maxBE = log((double)cand.cnt);
+			cand.score = cand.npmi * min(sqrt(cand.leftBranch * cand.rightBranch) / maxBE, 1.0);
+
+			thread_local Vector<size_t> trace;
+			if (!gatherLmScore)
+			{
+				const auto r = fi.findRange(cand.text.rbegin(), cand.text.rend());
+				const size_t u16size = cand.text.size();
+				cand.text.resize(12);
+				auto* ptr = reinterpret_cast<size_t*>(&cand.text[0]);
+				ptr[0] = r.first;
+				ptr[1] = r.second;
+				ptr[2] = u16size;
+			}
+			else if (fi.findTrace(trace, cand.text.rbegin(), cand.text.rend()))
+			{
+				cand.tokenScores.resize(cand.tokens.size());
+				int totalAccum = 0;
+				size_t i = 0, t = cand.tokens.size();
+				for (auto it = cand.text.rbegin(); it != cand.text.rend(); ++it, ++i)
+				{
+					if ((*it & 0x8000))
+					{
+						continue;
+					}
+
+					int tokenAccum = 0;
+					for (size_t j = i * cand.cnt; j < (i + 1) * cand.cnt; ++j)
+					{
+						totalAccum += scores[sa[trace[j]]];
+						tokenAccum += scores[sa[trace[j]]];
+					}
+					cand.tokenScores[--t] = (tokenAccum / 1024.f) / cand.cnt;
 				}
+				cand.lmScore = (totalAccum / 1024.f) / cand.cnt / cand.tokens.size();
+				const size_t b = trace.rbegin()[cand.cnt - 1];
+				const size_t e = trace.rbegin()[0] + 1;
+				const size_t u16size = cand.text.size();
+				cand.text.resize(12);
+				auto* ptr = reinterpret_cast<size_t*>(&cand.text[0]);
+				ptr[0] = b;
+				ptr[1] = e;
+				ptr[2] = u16size;
+			}
+			else
+			{
+				cand.text.clear();
 			}
 		});
 
@@ -759,44 +756,40 @@ namespace kiwi
 
 		maxCandidates = min(maxCandidates, numCandsGreaterThanMinScore);
 
-		mp::runParallel(threadPool.get(), [&](const size_t start, const size_t numWorkers, mp::Barrier*)
+		utils::parallelFor(threadPool.get(), 0, min(maxCandidates, ngrams.size()), [&](size_t, size_t i)
 		{
-			const size_t end = min(maxCandidates, ngrams.size());
-			for (size_t i = start; i < end; i += numWorkers)
-			{
-				auto& cand = ngrams[i];
-				if (cand.text.empty()) continue;
-				auto* ptr = reinterpret_cast<size_t*>(&cand.text[0]);
-				const size_t b = ptr[0];
-				const size_t e = ptr[1];
-				const size_t u16size = ptr[2];
-				thread_local UnorderedMap<u16string, size_t> formCnt;
-				formCnt.clear();
-				thread_local UnorderedSet<size_t> docIds;
-				docIds.clear();
-				for (size_t j = b; j < e; ++j)
+			auto& cand = ngrams[i];
+			if (cand.text.empty()) return;
+			auto* ptr = reinterpret_cast<size_t*>(&cand.text[0]);
+			const size_t b = ptr[0];
+			const size_t e = ptr[1];
+			const size_t u16size = ptr[2];
+			thread_local UnorderedMap<u16string, size_t> formCnt;
+			formCnt.clear();
+			thread_local UnorderedSet<size_t> docIds;
+			docIds.clear();
+			for (size_t j = b; j < e; ++j)
+			{
+				const auto origIdx = sa[j];
+				const size_t docId = upper_bound(docBoundaries.begin(), docBoundaries.end(), origIdx) - docBoundaries.begin() - 1;
+				docIds.emplace(docId);
+				const auto& text = rawDocs[docId];
+				const size_t tokenStart = positions[origIdx];
+				const size_t tokenEnd = positions[origIdx + u16size];
+				auto form = text.substr(tokenStart, tokenEnd - tokenStart);
+				while (!form.empty() && isSpace(form.back()))
 				{
-					const auto origIdx = sa[j];
-					const size_t docId = upper_bound(docBoundaries.begin(), docBoundaries.end(), origIdx) - docBoundaries.begin() - 1;
-					docIds.emplace(docId);
-					const auto& text = rawDocs[docId];
-					const size_t tokenStart = positions[origIdx];
-					const size_t tokenEnd = positions[origIdx + u16size];
-					auto form = text.substr(tokenStart, tokenEnd - tokenStart);
-					while (!form.empty() && isSpace(form.back()))
-					{
-						form.pop_back();
-					}
-					formCnt[form]++;
+					form.pop_back();
 				}
-				cand.df = docIds.size();
-				
-				auto it = max_element(formCnt.begin(), formCnt.end(), [](const pair<u16string, size_t>& a, const pair<u16string, size_t>& b)
-				{
-					return a.second < b.second;
-				});
-				cand.text = move(it->first);
+				formCnt[form]++;
 			}
+			cand.df = docIds.size();
+			
+			auto it = max_element(formCnt.begin(), formCnt.end(), [](const pair<u16string, size_t>& a, const pair<u16string, size_t>& b)
+			{
+				return a.second < b.second;
+			});
+			cand.text = move(it->first);
 		});
 
 		return { make_move_iterator(ngrams.begin()), make_move_iterator(ngrams.begin() + min(maxCandidates, ngrams.size())) };
@@ -0,0 +1,159 @@
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <kiwi/ThreadPool.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+using namespace kiwi::utils;
+
+namespace
+{
+	// "0-3,8,10-11" 형태의 목록을 펼친다
+	std::vector<size_t> parseCpuList(const std::string& str)
+	{
+		std::vector<size_t> ret;
+		size_t pos = 0;
+		while (pos < str.size())
+		{
+			const size_t end = std::min(str.find(',', pos), str.size());
+			const std::string item = str.substr(pos, end - pos);
+			pos = end + 1;
+			if (item.empty() || !isdigit((unsigned char)item[0])) continue;
+			const size_t dash = item.find('-');
+			const size_t first = std::stoul(item.substr(0, dash));
+			const size_t last = dash == std::string::npos ? first : std::stoul(item.substr(dash + 1));
+			for (size_t i = first; i <= last; ++i) ret.emplace_back(i);
+		}
+		return ret;
+	}
+
+	std::string readLine(const std::string& path)
+	{
+		std::ifstream ifs{ path };
+		std::string line;
+		std::getline(ifs, line);
+		return line;
+	}
+
+	size_t getEnvSize(const char* name, size_t def)
+	{
+		const char* env = std::getenv(name);
+		if (!env || !*env) return def;
+		char* end = nullptr;
+		const unsigned long v = std::strtoul(env, &end, 10);
+		return *end ? def : (size_t)v;
+	}
+
+	struct SharedPoolHolder
+	{
+		std::mutex mtx;
+		std::shared_ptr<ThreadPool> pool;
+	};
+
+	SharedPoolHolder& sharedPoolHolder()
+	{
+		static SharedPoolHolder holder;
+		return holder;
+	}
+
+	size_t configuredSharedSize()
+	{
+		return std::max(getEnvSize("KIWI_NUM_THREADS", std::max(std::thread::hardware_concurrency(), 1u)), (size_t)1);
+	}
+
+	// holder.mtx를 잡은 상태에서 호출해야 한다
+	std::shared_ptr<ThreadPool>& sharedPoolLocked(SharedPoolHolder& holder)
+	{
+		if (!holder.pool)
+		{
+			const bool pin = getEnvSize("KIWI_THREAD_AFFINITY", 0) != 0;
+			holder.pool = std::make_shared<ThreadPool>(configuredSharedSize(), 0, pin);
+		}
+		return holder.pool;
+	}
+}
+
+std::vector<size_t> kiwi::utils::detail::getCoresByNumaNode()
+{
+	std::vector<size_t> ret;
+#if defined(__linux__)
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed)) return ret;
+
+	std::vector<bool> visited(CPU_SETSIZE);
+	for (size_t node : parseCpuList(readLine("/sys/devices/system/node/online")))
+	{
+		for (size_t cpu : parseCpuList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")))
+		{
+			if (cpu >= CPU_SETSIZE || visited[cpu] || !CPU_ISSET(cpu, &allowed)) continue;
+			visited[cpu] = true;
+			ret.emplace_back(cpu);
+		}
+	}
+
+	// NUMA 정보를 얻을 수 없는 경우 나머지 코어는 번호 순서대로 배치한다
+	for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+	{
+		if (visited[cpu] || !CPU_ISSET(cpu, &allowed)) continue;
+		ret.emplace_back(cpu);
+	}
+#elif defined(_WIN32)
+	DWORD_PTR processMask = 0, systemMask = 0;
+	if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) return ret;
+	for (size_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu)
+	{
+		if (processMask & ((DWORD_PTR)1 << cpu)) ret.emplace_back(cpu);
+	}
+#endif
+	return ret;
+}
+
+bool kiwi::utils::detail::pinCurrentThread(size_t core)
+{
+#if defined(__linux__)
+	if (core >= CPU_SETSIZE) return false;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+	if (core >= sizeof(DWORD_PTR) * 8) return false;
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) != 0;
+#else
+	return false;
+#endif
+}
+
+std::shared_ptr<ThreadPool> kiwi::utils::getSharedThreadPool()
+{
+	auto& holder = sharedPoolHolder();
+	std::lock_guard<std::mutex> lock{ holder.mtx };
+	return sharedPoolLocked(holder);
+}
+
+void kiwi::utils::setSharedThreadPool(std::shared_ptr<ThreadPool> pool)
+{
+	auto& holder = sharedPoolHolder();
+	std::lock_guard<std::mutex> lock{ holder.mtx };
+	holder.pool = std::move(pool);
+}
+
+std::shared_ptr<ThreadPool> kiwi::utils::acquireThreadPool(size_t numThreads)
+{
+	{
+		auto& holder = sharedPoolHolder();
+		std::lock_guard<std::mutex> lock{ holder.mtx };
+		// 크기가 다른 전용 풀을 요청한 경우에는 쓰이지 않을 공유 풀을 만들지 않는다
+		const size_t sharedSize = holder.pool ? holder.pool->size() : configuredSharedSize();
+		if (!numThreads || numThreads == sharedSize) return sharedPoolLocked(holder);
+	}
+	return std::make_shared<ThreadPool>(numThreads);
+}
@@ -254,7 +254,7 @@ namespace kiwi
 		return 0;
 	}
 
-	size_t getSBType(const std::u16string& form)
+	size_t getSBType(U16StringView form)
 	{
 		size_t format = 0, group = 0;
 		char32_t chr = form[0];
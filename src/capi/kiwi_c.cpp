@@ -23,6 +23,10 @@ struct kiwi_res : public pair<vector<TokenResult>, ResultBuffer>
 	using pair<vector<TokenResult>, ResultBuffer>::pair;
 };
 
+struct kiwi_cres : public ColumnarTokenResult
+{
+};
+
 struct kiwi_ws : public pair<vector<WordInfo>, ResultBuffer>
 {
 	using pair<vector<WordInfo>, ResultBuffer>::pair;
@@ -563,6 +567,21 @@ void kiwi_set_option(kiwi_h handle, int option, int value)
 	case KIWI_SPACE_TOLERANCE:
 		kiwi->setSpaceTolerance(value);
 		break;
+	case KIWI_PARALLEL_CHUNK_SIZE:
+		kiwi->setParallelChunkSize(value);
+		break;
+	case KIWI_LM_CACHE_SIZE:
+		kiwi->setLmCacheSize(value);
+		break;
+	case KIWI_COLLECT_STATS:
+		kiwi->setCollectStats(!!value);
+		break;
+	case KIWI_RESULT_CACHE_SIZE:
+		kiwi->setResultCacheSize(value);
+		break;
+	case KIWI_CHUNK_MEMO_SIZE:
+		kiwi->setChunkMemoSize(value);
+		break;
 	default:
 		currentError = make_exception_ptr(invalid_argument{ "Invalid option value: " + to_string(option)});
 		break;
@@ -583,6 +602,16 @@ int kiwi_get_option(kiwi_h handle, int option)
 		return kiwi->getMaxUnkFormSize();
 	case KIWI_SPACE_TOLERANCE:
 		return kiwi->getSpaceTolerance();
+	case KIWI_PARALLEL_CHUNK_SIZE:
+		return kiwi->getParallelChunkSize();
+	case KIWI_LM_CACHE_SIZE:
+		return kiwi->getLmCacheSize();
+	case KIWI_COLLECT_STATS:
+		return kiwi->getCollectStats() ? 1 : 0;
+	case KIWI_RESULT_CACHE_SIZE:
+		return kiwi->getResultCacheSize();
+	case KIWI_CHUNK_MEMO_SIZE:
+		return kiwi->getChunkMemoSize();
 	default:
 		currentError = make_exception_ptr(invalid_argument{ "Invalid option value: " + to_string(option) });
 		break;
@@ -640,6 +669,44 @@ float kiwi_get_option_f(kiwi_h handle, int option)
 	return KIWIERR_INVALID_INDEX;
 }
 
+int kiwi_get_stats(kiwi_h handle, kiwi_stats_t* stats)
+{
+	if (!handle) return KIWIERR_INVALID_HANDLE;
+	if (!stats)
+	{
+		currentError = make_exception_ptr(invalid_argument{ "`stats` must not be null." });
+		return KIWIERR_FAIL;
+	}
+	Kiwi* kiwi = (Kiwi*)handle;
+	auto s = kiwi->getStats();
+	stats->num_analyzed = s.numAnalyzed;
+	stats->num_chars = s.numChars;
+	stats->normalize_time = s.normalizeTime;
+	stats->split_time = s.splitTime;
+	stats->path_time = s.pathTime;
+	stats->insert_time = s.insertTime;
+	stats->num_splits = s.numSplits;
+	stats->num_nodes = s.numNodes;
+	stats->num_typo_nodes = s.numTypoNodes;
+	stats->num_paths_evaluated = s.numPathsEvaluated;
+	stats->num_paths_pruned = s.numPathsPruned;
+	stats->num_lm_calls = s.numLmCalls;
+	stats->num_memo_hits = s.numMemoHits;
+	stats->lm_cache_hits = s.lmCache.hits;
+	stats->lm_cache_misses = s.lmCache.misses;
+	stats->result_cache_hits = s.resultCache.hits;
+	stats->result_cache_misses = s.resultCache.misses;
+	return 0;
+}
+
+int kiwi_reset_stats(kiwi_h handle)
+{
+	if (!handle) return KIWIERR_INVALID_HANDLE;
+	Kiwi* kiwi = (Kiwi*)handle;
+	kiwi->resetStats();
+	return 0;
+}
+
 kiwi_morphset_h kiwi_new_morphset(kiwi_h handle)
 {
 	if (!handle) return nullptr;
@@ -693,6 +760,48 @@ kiwi_res_h kiwi_analyze(kiwi_h handle, const char * text, int topN, int matchOpt
 	}
 }
 
+kiwi_cres_h kiwi_analyze_columnar_w(kiwi_h handle, const kchar16_t* text, int topN, int matchOptions, kiwi_morphset_h blocklilst, kiwi_pretokenized_h pretokenized)
+{
+	if (!handle) return nullptr;
+	Kiwi* kiwi = (Kiwi*)handle;
+	try
+	{
+		auto ret = std::make_unique<kiwi_cres>();
+		kiwi->analyze(
+			(const char16_t*)text, *ret, topN, (Match)matchOptions,
+			blocklilst ? &blocklilst->morphemes : nullptr,
+			pretokenized ? *pretokenized : std::vector<PretokenizedSpan>{}
+		);
+		return ret.release();
+	}
+	catch (...)
+	{
+		currentError = current_exception();
+		return nullptr;
+	}
+}
+
+kiwi_cres_h kiwi_analyze_columnar(kiwi_h handle, const char* text, int topN, int matchOptions, kiwi_morphset_h blocklilst, kiwi_pretokenized_h pretokenized)
+{
+	if (!handle) return nullptr;
+	Kiwi* kiwi = (Kiwi*)handle;
+	try
+	{
+		auto ret = std::make_unique<kiwi_cres>();
+		kiwi->analyze(
+			text, *ret, topN, (Match)matchOptions,
+			blocklilst ? &blocklilst->morphemes : nullptr,
+			pretokenized ? *pretokenized : std::vector<PretokenizedSpan>{}
+		);
+		return ret.release();
+	}
+	catch (...)
+	{
+		currentError = current_exception();
+		return nullptr;
+	}
+}
+
 int kiwi_analyze_mw(kiwi_h handle, kiwi_reader_w_t reader, kiwi_receiver_t receiver, void * userData, int topN, int matchOptions, kiwi_morphset_h blocklilst)
 {
 	if (!handle) return KIWIERR_INVALID_HANDLE;
@@ -787,6 +896,82 @@ kiwi_ss_h kiwi_split_into_sents(kiwi_h handle, const char* text, int matchOption
 	}
 }
 
+kiwi_ss_h kiwi_split_into_sents_fast_w(kiwi_h handle, const kchar16_t* text, int matchOptions)
+{
+	if (!handle) return nullptr;
+	Kiwi* kiwi = (Kiwi*)handle;
+	try
+	{
+		return new kiwi_ss{ kiwi->splitIntoSentsFast((const char16_t*)text, (Match)matchOptions) };
+	}
+	catch (...)
+	{
+		currentError = current_exception();
+		return nullptr;
+	}
+}
+
+kiwi_ss_h kiwi_split_into_sents_fast(kiwi_h handle, const char* text, int matchOptions)
+{
+	if (!handle) return nullptr;
+	Kiwi* kiwi = (Kiwi*)handle;
+	try
+	{
+		return new kiwi_ss{ kiwi->splitIntoSentsFast(text, (Match)matchOptions) };
+	}
+	catch (...)
+	{
+		currentError = current_exception();
+		return nullptr;
+	}
+}
+
+int kiwi_add_user_word(kiwi_h handle, const char* word, const char* pos, float score)
+{
+	if (!handle) return KIWIERR_INVALID_HANDLE;
+	Kiwi* kiwi = (Kiwi*)handle;
+	try
+	{
+		return kiwi->addUserWords({ UserOverlay::Word{ utf8To16(word), parse_tag(pos), score } }) ? 0 : 1;
+	}
+	catch (...)
+	{
+		currentError = current_exception();
+		return KIWIERR_FAIL;
+	}
+}
+
+int kiwi_clear_user_words(kiwi_h handle)
+{
+	if (!handle) return KIWIERR_INVALID_HANDLE;
+	Kiwi* kiwi = (Kiwi*)handle;
+	try
+	{
+		kiwi->setUserOverlay(nullptr);
+		return 0;
+	}
+	catch (...)
+	{
+		currentError = current_exception();
+		return KIWIERR_FAIL;
+	}
+}
+
+kiwi_h kiwi_clone(kiwi_h handle)
+{
+	if (!handle) return nullptr;
+	Kiwi* kiwi = (Kiwi*)handle;
+	try
+	{
+		return (kiwi_h)new Kiwi{ kiwi->clone() };
+	}
+	catch (...)
+	{
+		currentError = current_exception();
+		return nullptr;
+	}
+}
+
 DECL_DLL kiwi_joiner_h kiwi_new_joiner(kiwi_h handle, int lm_search)
 {
 	if (!handle) return nullptr;
@@ -1043,6 +1228,94 @@ int kiwi_res_close(kiwi_res_h result)
 	}
 }
 
+int kiwi_cres_size(kiwi_cres_h result)
+{
+	if (!result) return KIWIERR_INVALID_HANDLE;
+	return (int)result->numResults();
+}
+
+float kiwi_cres_prob(kiwi_cres_h result, int index)
+{
+	if (!result) return 0;
+	if (index < 0 || index >= result->numResults()) return 0;
+	return result->resultScores[index];
+}
+
+int kiwi_cres_token_num(kiwi_cres_h result)
+{
+	if (!result) return KIWIERR_INVALID_HANDLE;
+	return (int)result->numTokens();
+}
+
+const uint32_t* kiwi_cres_result_offsets(kiwi_cres_h result)
+{
+	if (!result) return nullptr;
+	return result->resultOffsets.data();
+}
+
+const kchar16_t* kiwi_cres_forms_w(kiwi_cres_h result)
+{
+	if (!result) return nullptr;
+	return (const kchar16_t*)result->formPool.c_str();
+}
+
+const uint32_t* kiwi_cres_form_offsets(kiwi_cres_h result)
+{
+	if (!result) return nullptr;
+	return result->formOffsets.data();
+}
+
+const uint32_t* kiwi_cres_positions(kiwi_cres_h result)
+{
+	if (!result) return nullptr;
+	return result->positions.data();
+}
+
+const uint16_t* kiwi_cres_lengths(kiwi_cres_h result)
+{
+	if (!result) return nullptr;
+	return result->lengths.data();
+}
+
+const uint8_t* kiwi_cres_tags(kiwi_cres_h result)
+{
+	if (!result) return nullptr;
+	return (const uint8_t*)result->tags.data();
+}
+
+const uint32_t* kiwi_cres_word_positions(kiwi_cres_h result)
+{
+	if (!result) return nullptr;
+	return result->wordPositions.data();
+}
+
+const uint32_t* kiwi_cres_sent_positions(kiwi_cres_h result)
+{
+	if (!result) return nullptr;
+	return result->sentPositions.data();
+}
+
+const float* kiwi_cres_scores(kiwi_cres_h result)
+{
+	if (!result) return nullptr;
+	return result->scores.data();
+}
+
+int kiwi_cres_close(kiwi_cres_h result)
+{
+	if (!result) return KIWIERR_INVALID_HANDLE;
+	try
+	{
+		delete result;
+		return 0;
+	}
+	catch (...)
+	{
+		currentError = current_exception();
+		return KIWIERR_FAIL;
+	}
+}
+
 int kiwi_ws_size(kiwi_ws_h result)
 {
 	if (!result) return KIWIERR_INVALID_HANDLE;
@@ -276,17 +276,20 @@ namespace kiwi
 			{
 				for (size_t s = data.size(); s > 1; s = (s + 1) / 2)
 				{
-					std::vector<std::future<void>> futures;
 					size_t h = (s + 1) / 2;
+					WaitGroup wg{ s - h };
 					for (size_t i = h; i < s; ++i)
 					{
-						futures.emplace_back(pool->enqueue([&, i, h](size_t)
+						pool->submit([&, i, h](size_t)
 						{
-							_LocalData d = std::move(data[i]);
-							fn(data[i - h], std::move(d));
-						}));
+							wg.run([&]()
+							{
+								_LocalData d = std::move(data[i]);
+								fn(data[i - h], std::move(d));
+							});
+						});
 					}
-					for (auto& f : futures) f.get();
+					wg.wait();
 				}
 			}
 			else
@@ -318,21 +321,25 @@ namespace kiwi
 					decltype(unigramDf)
 				>;
 				std::vector<LocalCfDf> localdata(pool->size());
-				std::vector<std::future<void>> futures;
 				const size_t stride = pool->size() * 8;
 				auto docIt = docBegin;
+				WaitGroup wg;
 				for (size_t i = 0; i < stride && docIt != docEnd; ++i, ++docIt)
 				{
-					futures.emplace_back(pool->enqueue([&, docIt, stride](size_t tid)
+					wg.add();
+					pool->submit([&, docIt, stride](size_t tid)
 					{
-						countUnigrams(localdata[tid].first, localdata[tid].second,
-							makeStrideIter(docIt, stride, docEnd),
-							makeStrideIter(docEnd, stride, docEnd)
-						);
-					}));
+						wg.run([&]()
+						{
+							countUnigrams(localdata[tid].first, localdata[tid].second,
+								makeStrideIter(docIt, stride, docEnd),
+								makeStrideIter(docEnd, stride, docEnd)
+							);
+						});
+					});
 				}
 
-				for (auto& f : futures) f.get();
+				wg.wait();
 
 				auto r = parallelReduce(std::move(localdata), [](LocalCfDf& dest, LocalCfDf&& src)
 				{
@@ -361,24 +368,28 @@ namespace kiwi
 					decltype(bigramDf)
 				>;
 				std::vector<LocalCfDf> localdata(pool->size());
-				std::vector<std::future<void>> futures;
 				const size_t stride = pool->size() * 8;
 				auto docIt = docBegin;
+				WaitGroup wg;
 				for (size_t i = 0; i < stride && docIt != docEnd; ++i, ++docIt)
 				{
-					futures.emplace_back(pool->enqueue([&, docIt, stride](size_t tid)
+					wg.add();
+					pool->submit([&, docIt, stride](size_t tid)
 					{
-						countBigrams(localdata[tid].first, localdata[tid].second,
-							makeStrideIter(docIt, stride, docEnd),
-							makeStrideIter(docEnd, stride, docEnd),
-							unigramCf, unigramDf,
-							minCf, minDf,
-							historyTransformer
-						);
-					}));
+						wg.run([&]()
+						{
+							countBigrams(localdata[tid].first, localdata[tid].second,
+								makeStrideIter(docIt, stride, docEnd),
+								makeStrideIter(docEnd, stride, docEnd),
+								unigramCf, unigramDf,
+								minCf, minDf,
+								historyTransformer
+							);
+						});
+					});
 				}
 
-				for (auto& f : futures) f.get();
+				wg.wait();
 
 				auto r = parallelReduce(std::move(localdata), [](LocalCfDf& dest, LocalCfDf&& src)
 				{
@@ -444,23 +455,27 @@ namespace kiwi
 				{
 					using LocalFw = ContinuousTrie<CTrieNode>;
 					std::vector<LocalFw> localdata(pool->size());
-					std::vector<std::future<void>> futures;
 					const size_t stride = pool->size() * 8;
 					auto docIt = docBegin;
+					WaitGroup wg;
 					for (size_t i = 0; i < stride && docIt != docEnd; ++i, ++docIt)
 					{
-						futures.emplace_back(pool->enqueue([&, docIt, stride](size_t tid)
+						wg.add();
+						pool->submit([&, docIt, stride](size_t tid)
 						{
-							countNgrams<false>(localdata[tid],
-								makeStrideIter(docIt, stride, docEnd),
-								makeStrideIter(docEnd, stride, docEnd),
-								unigramCf, unigramDf, validPairs, minCf, minDf, maxNgrams,
-								historyTransformer
-							);
-						}));
+							wg.run([&]()
+							{
+								countNgrams<false>(localdata[tid],
+									makeStrideIter(docIt, stride, docEnd),
+									makeStrideIter(docEnd, stride, docEnd),
+									unigramCf, unigramDf, validPairs, minCf, minDf, maxNgrams,
+									historyTransformer
+								);
+							});
+						});
 					}
 
-					for (auto& f : futures) f.get();
+					wg.wait();
 
 					auto r = parallelReduce(std::move(localdata), [&](LocalFw& dest, LocalFw&& src)
 					{
@@ -3,7 +3,6 @@
 #include <vector>
 #include <tuple>
 #include <type_traits>
-#include <queue>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -11,143 +10,44 @@
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <kiwi/ThreadPool.h>
 
 namespace mp
 {
-	class Barrier {
-	public:
-		explicit Barrier(std::mutex* _mutex, std::condition_variable* _cond, size_t _count) :
-			mutex(_mutex),
-			cond(_cond),
-			threshold(_count),
-			count(_count),
-			generation(0) 
-		{
-		}
-
-		void wait()
-		{
-			std::unique_lock<std::mutex> lLock{ *mutex };
-			auto gen = generation;
-			if (!--count) 
-			{
-				generation++;
-				count = threshold;
-				cond->notify_all();
-			}
-			else 
-			{
-				cond->wait(lLock, [this, gen] { return gen != generation; });
-			}
-		}
-
-	private:
-		std::mutex* mutex;
-		std::condition_variable* cond;
-		std::size_t threshold;
-		std::size_t count;
-		std::size_t generation;
-	};
-
-	class OverrideLimitedSize;
+	// sais와 FmIndex는 Kiwi의 공용 스레드 풀 위에서 실행된다
+	using ThreadPool = kiwi::utils::ThreadPool;
+	using Barrier = kiwi::utils::Barrier;
 
-	class ThreadPool
+	inline size_t getPoolSize(ThreadPool* pool)
 	{
-		friend class OverrideLimitedSize;
-	public:
-		ThreadPool(size_t threads = 0);
-		template<class F, class... Args>
-		auto runParallel(size_t workers, F&& f, Args&&... args)
-			-> std::vector<std::future<typename std::result_of<F(size_t, size_t, Barrier*, Args...)>::type>>;
-		~ThreadPool();
-		size_t size() const { return workers.size(); }
-		size_t limitedSize() const { return std::min(size(), _limitedSize); };
-		void joinAll();
-		
-		Barrier getBarrier(size_t count = -1)
-		{
-			return Barrier{ &barrier_mutex, &barrier_condition, std::min(count, tasks.size()) };
-		}
-
-	private:
-		std::vector<std::thread> workers;
-		std::vector<std::queue<std::function<void(size_t)>>> tasks;
-
-		std::mutex queue_mutex, barrier_mutex;
-		std::condition_variable condition, barrier_condition;
-		size_t _limitedSize = -1;
-		bool stop;
-	};
+		if (!pool) return 1;
+		return pool->size();
+	}
 
-	inline ThreadPool::ThreadPool(size_t threads)
-		: stop(false)
+	namespace detail
 	{
-		tasks.resize(threads);
-		for (size_t i = 0; i < threads; ++i)
+		// 풀이 여러 구성 요소 사이에 공유될 수 있으므로 병렬도 제한은 호출한 스레드에만 적용한다
+		inline size_t& limitedSize()
 		{
-			workers.emplace_back([this, i, threads]
-			{
-				for (;;)
-				{
-					std::function<void(size_t)> task;
-					{
-						std::unique_lock<std::mutex> lock(this->queue_mutex);
-						this->condition.wait(lock,
-							[this, i] { return this->stop || !this->tasks[i].empty(); });
-						if (this->stop && this->tasks[i].empty()) return;
-						task = std::move(this->tasks[i].front());
-						this->tasks[i].pop();
-					}
-					task(i);
-				}
-			});
+			static thread_local size_t size = -1;
+			return size;
 		}
-	}
 
-	template<class F, class... Args>
-	auto ThreadPool::runParallel(size_t workers, F&& f, Args&&... args)
-		-> std::vector<std::future<typename std::result_of<F(size_t, size_t, Barrier*, Args...)>::type>>
-	{
-		using return_type = typename std::result_of<F(size_t, size_t, Barrier*, Args...)>::type;
-		std::vector<std::future<return_type>> ret;
+		inline size_t limitedSize(ThreadPool* pool)
 		{
-			auto b = std::make_shared<Barrier>(getBarrier(workers));
-			std::unique_lock<std::mutex> lock(queue_mutex);
-			for (size_t i = 0; i < workers && i < tasks.size(); ++i)
-			{
-				auto task = std::make_shared< std::packaged_task<return_type(size_t, size_t, Barrier*)> >(
-					std::bind(std::forward<F>(f), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::forward<Args>(args)...));
-				if (stop) throw std::runtime_error("enqueue on stopped ThreadPool");
-				ret.emplace_back(task->get_future());
-				tasks[i].emplace([&, task, workers, b](size_t id) { (*task)(id, std::min(workers, tasks.size()), b.get()); });
-			}
+			return std::min(pool->size(), limitedSize());
 		}
-		condition.notify_all();
-		return ret;
-	}
-
-	inline void ThreadPool::joinAll()
-	{
-		if (stop) return;
 
+		/**
+		 * 실제로 함께 실행될 스레드 수를 반환한다. 1이면 호출한 스레드에서 func(0, 1, nullptr)가 바로 실행되며,
+		 * 이때는 병렬 분기의 결과를 모으는 parallelFinal을 호출해서는 안 된다.
+		 * `ThreadPool::runParallel`은 작업자 스레드에서 호출되면 혼자 실행하므로 여기서도 같은 조건을 따른다.
+		 */
+		inline size_t effectiveWorkers(ThreadPool* pool, size_t maximumWorkers, bool parallelCond)
 		{
-			std::unique_lock<std::mutex> lock(queue_mutex);
-			stop = true;
+			if (!pool || !parallelCond || pool->isWorkerThread()) return 1;
+			return std::min(maximumWorkers, limitedSize(pool));
 		}
-		condition.notify_all();
-		for (std::thread& worker : workers)
-			worker.join();
-	}
-
-	inline ThreadPool::~ThreadPool()
-	{
-		joinAll();
-	}
-
-	inline size_t getPoolSize(ThreadPool* pool)
-	{
-		if (!pool) return 1;
-		return pool->size();
 	}
 
 	namespace detail
@@ -315,13 +215,14 @@ namespace mp
 		auto parallelFinalFn = detail::extractValueFrom<ParallelFinal>(detail::NoOp{}, argTuple);
 
 		std::vector<decltype(func(0, 0, nullptr))> ret;
-		if (!pool || !parallelCond || maximumWorkers == 1)
+		const size_t numWorkers = detail::effectiveWorkers(pool, maximumWorkers, parallelCond);
+		if (numWorkers <= 1)
 		{
 			ret.emplace_back(func(0, 1, nullptr));
 		}
 		else
 		{
-			for (auto& f : pool->runParallel(std::min(maximumWorkers, pool->limitedSize()), func))
+			for (auto& f : pool->runParallel(numWorkers, func))
 			{
 				ret.emplace_back(f.get());
 			}
@@ -340,13 +241,14 @@ namespace mp
 		bool parallelCond = detail::extractValueFrom<ParallelCond>(true, argTuple);
 		auto parallelFinalFn = detail::extractValueFrom<ParallelFinal>(detail::NoOp{}, argTuple);
 
-		if (!pool || !parallelCond || maximumWorkers == 1)
+		const size_t numWorkers = detail::effectiveWorkers(pool, maximumWorkers, parallelCond);
+		if (numWorkers <= 1)
 		{
 			func(0, 1, nullptr);
 		}
 		else
 		{
-			for (auto& f : pool->runParallel(std::min(maximumWorkers, pool->limitedSize()), func))
+			for (auto& f : pool->runParallel(numWorkers, func))
 			{
 				f.get();
 			}
@@ -369,13 +271,14 @@ namespace mp
 		bool parallelCond = detail::extractValueFrom<ParallelCond>(true, argTuple);
 		auto parallelFinalFn = detail::extractValueFrom<ParallelFinal>(detail::NoOp{}, argTuple);
 
-		if (!pool || !parallelCond || maximumWorkers == 1)
+		const size_t numWorkers = detail::effectiveWorkers(pool, maximumWorkers, parallelCond);
+		if (numWorkers <= 1)
 		{
 			func(0, 1, start, stop, step, nullptr);
 		}
 		else
 		{
-			for (auto& f : pool->runParallel(std::min(maximumWorkers, pool->limitedSize()), [&](ptrdiff_t tid, ptrdiff_t numThreads, Barrier* barrier)
+			for (auto& f : pool->runParallel(numWorkers, [&](ptrdiff_t tid, ptrdiff_t numThreads, Barrier* barrier)
 				{
 					ptrdiff_t pstart = start + ((stop - start) * tid / numThreads) / step * step;
 					ptrdiff_t pstop = start + ((stop - start) * (tid + 1) / numThreads) / step * step;
@@ -396,14 +299,14 @@ namespace mp
 		ThreadPool* pool;
 	public:
 		OverrideLimitedSize(ThreadPool* _pool, size_t newSize)
-			: pool{ _pool }, prevSize{ pool ? pool->limitedSize() : -1 }
+			: prevSize{ detail::limitedSize() }, pool{ _pool }
 		{
-			if (pool) pool->_limitedSize = newSize;
+			if (pool) detail::limitedSize() = newSize;
 		}
 
 		~OverrideLimitedSize()
 		{
-			if (pool) pool->_limitedSize = prevSize;
+			if (pool) detail::limitedSize() = prevSize;
 		}
 	};
 
@@ -1,6 +1,12 @@
 
 #include <algorithm>
 #include <numeric>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
 
 #include <kiwi/Types.h>
 #include <kiwi/BitUtils.h>
@@ -1041,3 +1047,159 @@ namespace kiwi
 	}
 }
 #endif
+
+namespace kiwi
+{
+	namespace nst
+	{
+		template<ArchType arch, class IntTy>
+		float measureSearch(size_t size, size_t lookups, std::mt19937_64& rng)
+		{
+			size = std::min(size, (size_t)std::numeric_limits<IntTy>::max());
+			// SIMD 커널은 배열 끝을 넘어 한 블록까지 읽을 수 있으므로 여유 공간을 둔다
+			Vector<IntTy> keys(size + 64);
+			Vector<uint32_t> values(size);
+			Vector<uint8_t> tempBuf;
+			{
+				Vector<IntTy> pool;
+				std::uniform_int_distribution<uint64_t> dist{ 1, std::numeric_limits<IntTy>::max() };
+				while (pool.size() < size)
+				{
+					pool.emplace_back((IntTy)dist(rng));
+					if (pool.size() == size)
+					{
+						std::sort(pool.begin(), pool.end());
+						pool.erase(std::unique(pool.begin(), pool.end()), pool.end());
+					}
+				}
+				std::copy(pool.begin(), pool.end(), keys.begin());
+			}
+			std::iota(values.begin(), values.end(), 0);
+
+			// 실제 사용에서처럼 대부분은 존재하는 키를, 일부는 존재하지 않을 수 있는 키를 찾는다
+			Vector<IntTy> targets(lookups);
+			for (auto& t : targets)
+			{
+				t = (rng() & 3) ? keys[rng() % size] : (IntTy)rng();
+			}
+			prepare<arch>(keys.data(), values.data(), size, tempBuf);
+
+			float best = std::numeric_limits<float>::infinity();
+			size_t found = 0;
+			for (size_t r = 0; r < 3; ++r)
+			{
+				auto start = std::chrono::steady_clock::now();
+				for (auto t : targets)
+				{
+					uint32_t v = 0;
+					if (search<arch>(keys.data(), values.data(), size, t, v)) found += v + 1;
+				}
+				const float elapsed = std::chrono::duration<float, std::nano>(std::chrono::steady_clock::now() - start).count();
+				best = std::min(best, elapsed / lookups);
+			}
+			// 탐색 결과를 사용하지 않으면 컴파일러가 루프 전체를 제거할 수 있다
+			volatile size_t sink = found;
+			(void)sink;
+			return std::max(best, 1e-3f);
+		}
+
+		template<ArchType arch>
+		float measureSearchOf(size_t keyWidth, size_t size, size_t lookups, std::mt19937_64& rng)
+		{
+			switch (keyWidth)
+			{
+			case 1:
+				return measureSearch<arch, uint8_t>(size, lookups, rng);
+			case 2:
+				return measureSearch<arch, uint16_t>(size, lookups, rng);
+			default:
+				return measureSearch<arch, uint32_t>(size, lookups, rng);
+			}
+		}
+
+		template<class IntTy>
+		struct ReorderGetter
+		{
+			template<std::ptrdiff_t i>
+			struct Wrapper
+			{
+				static constexpr Vector<size_t>(*value)(const IntTy*, size_t) = &detail::reorderImpl<static_cast<ArchType>(i), IntTy>;
+			};
+		};
+
+		template<class IntTy>
+		Vector<size_t> detail::reorderImpl(ArchType arch, const IntTy* keys, size_t size)
+		{
+			using FnReorder = Vector<size_t>(*)(const IntTy*, size_t);
+			static tp::Table<FnReorder, AvailableArch> table{ ReorderGetter<IntTy>{} };
+			const auto a = static_cast<std::ptrdiff_t>(arch);
+			auto fn = (a <= tp::SeqMax<AvailableArch>::value) ? table[a] : nullptr;
+			if (!fn) throw std::runtime_error{ std::string{ "Unsupported architecture : " } + archToStr(arch) };
+			return (*fn)(keys, size);
+		}
+
+		template Vector<size_t> detail::reorderImpl(ArchType, const uint8_t*, size_t);
+		template Vector<size_t> detail::reorderImpl(ArchType, const uint16_t*, size_t);
+		template Vector<size_t> detail::reorderImpl(ArchType, const uint32_t*, size_t);
+		template Vector<size_t> detail::reorderImpl(ArchType, const uint64_t*, size_t);
+		template Vector<size_t> detail::reorderImpl(ArchType, const char16_t*, size_t);
+
+		using FnMeasureSearch = decltype(&measureSearchOf<ArchType::none>);
+
+		struct MeasureSearchGetter
+		{
+			template<std::ptrdiff_t i>
+			struct Wrapper
+			{
+				static constexpr FnMeasureSearch value = &measureSearchOf<static_cast<ArchType>(i)>;
+			};
+		};
+
+		SearchTuneResult tuneSearch(ArchType maxArch, size_t lookupsPerBucket)
+		{
+			static tp::Table<FnMeasureSearch, AvailableArch> table{ MeasureSearchGetter{} };
+			static constexpr size_t numArchs = tp::SeqMax<AvailableArch>::value + 1;
+
+			SearchTuneResult ret;
+			std::mt19937_64 rng{ 42 };
+			double logRatioSum[numArchs] = { 0, };
+			for (size_t w = 0; w < SearchTuneResult::numKeyWidths; ++w)
+			{
+				for (size_t b = 0; b < SearchTuneResult::numSizeBuckets; ++b)
+				{
+					float bestTime = std::numeric_limits<float>::infinity();
+					for (size_t a = static_cast<size_t>(ArchType::none); a < numArchs; ++a)
+					{
+						auto fn = table[a];
+						if (!fn || (a > static_cast<size_t>(ArchType::balanced) && a > static_cast<size_t>(maxArch))) continue;
+						const float t = (*fn)(SearchTuneResult::keyWidth(w), SearchTuneResult::bucketSize(b), lookupsPerBucket, rng);
+						ret.nsPerSearch[a][w][b] = t;
+						if (t < bestTime)
+						{
+							bestTime = t;
+							ret.bucketBest[w][b] = static_cast<ArchType>(a);
+						}
+					}
+
+					for (size_t a = 0; a < numArchs; ++a)
+					{
+						if (ret.nsPerSearch[a][w][b] <= 0) continue;
+						logRatioSum[a] += std::log(ret.nsPerSearch[a][w][b] / bestTime);
+					}
+				}
+			}
+
+			double bestScore = std::numeric_limits<double>::infinity();
+			for (size_t a = static_cast<size_t>(ArchType::none); a < numArchs; ++a)
+			{
+				if (ret.nsPerSearch[a][0][0] <= 0) continue;
+				if (logRatioSum[a] < bestScore)
+				{
+					bestScore = logRatioSum[a];
+					ret.best = static_cast<ArchType>(a);
+				}
+			}
+			return ret;
+		}
+	}
+}
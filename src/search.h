@@ -22,32 +22,80 @@ namespace kiwi
 
 			template<ArchType arch, class IntTy>
 			Vector<size_t> reorderImpl(const IntTy* keys, size_t size);
+
+			template<class IntTy>
+			Vector<size_t> reorderImpl(ArchType arch, const IntTy* keys, size_t size);
+
+			template<class IntTy, class Value>
+			void applyOrder(const Vector<size_t>& order, IntTy* keys, Value* values, size_t size, Vector<uint8_t>& tempBuf)
+			{
+				if (order.empty()) return;
+
+				if (tempBuf.size() < std::max(sizeof(IntTy), sizeof(Value)) * size)
+				{
+					tempBuf.resize(std::max(sizeof(IntTy), sizeof(Value)) * size);
+				}
+				auto tempKeys = (IntTy*)tempBuf.data();
+				auto tempValues = (Value*)tempBuf.data();
+				std::copy(keys, keys + size, tempKeys);
+				for (size_t i = 0; i < size; ++i)
+				{
+					keys[i] = tempKeys[order[i]];
+				}
+
+				std::copy(values, values + size, tempValues);
+				for (size_t i = 0; i < size; ++i)
+				{
+					values[i] = tempValues[order[i]];
+				}
+			}
 		}
 
+		/**
+		 * @brief 키 크기와 배열 길이 구간별로 각 ArchType의 탐색 커널 속도를 측정한 결과
+		 */
+		struct SearchTuneResult
+		{
+			static constexpr size_t numKeyWidths = 3, numSizeBuckets = 4;
+
+			ArchType best = ArchType::none;
+			ArchType bucketBest[numKeyWidths][numSizeBuckets] = {};
+			float nsPerSearch[static_cast<size_t>(ArchType::last) + 1][numKeyWidths][numSizeBuckets] = {};
+
+			/**
+			 * @brief i번째 키 크기(바이트). 1, 2, 4 순서이다.
+			 */
+			static size_t keyWidth(size_t i) { return (size_t)1 << i; }
+
+			/**
+			 * @brief i번째 구간에서 측정에 사용하는 배열 길이. 8, 32, 128, 512 순서이다.
+			 */
+			static size_t bucketSize(size_t i) { return (size_t)8 << (i * 2); }
+		};
+
+		/**
+		 * @brief 현재 기기에서 maxArch 이하의 사용 가능한 모든 ArchType에 대해 탐색 커널을 실제로 실행해보고 가장 빠른 것을 고른다.
+		 * @details 각 구간마다 가장 빠른 커널 대비 상대 시간을 구하고, 그 기하평균이 가장 작은 ArchType을 `best`로 선택한다.
+		 * 키 배열의 배치 순서는 ArchType마다 다르고 모델을 읽어들일 때 한번 정해지므로, 구간마다 서로 다른 커널을 섞어 쓰지는 않는다.
+		 */
+		SearchTuneResult tuneSearch(ArchType maxArch, size_t lookupsPerBucket = 4096);
+
 		template<ArchType arch, class IntTy, class Value>
 		void prepare(IntTy* keys, Value* values, size_t size, Vector<uint8_t>& tempBuf)
 		{
 			if (size <= 1) return;
-			auto order = detail::reorderImpl<arch>(keys, size);
-			if (order.empty()) return;
-
-			if (tempBuf.size() < std::max(sizeof(IntTy), sizeof(Value)) * size)
-			{
-				tempBuf.resize(std::max(sizeof(IntTy), sizeof(Value)) * size);
-			}
-			auto tempKeys = (IntTy*)tempBuf.data();
-			auto tempValues = (Value*)tempBuf.data();
-			std::copy(keys, keys + size, tempKeys);
-			for (size_t i = 0; i < size; ++i)
-			{
-				keys[i] = tempKeys[order[i]];
-			}
+			detail::applyOrder(detail::reorderImpl<arch>(keys, size), keys, values, size, tempBuf);
+		}
 
-			std::copy(values, values + size, tempValues);
-			for (size_t i = 0; i < size; ++i)
-			{
-				values[i] = tempValues[order[i]];
-			}
+		/**
+		 * @brief 정렬된 키 배열을 실행 시점에 주어진 arch의 탐색 순서로 재배열한다.
+		 * @details 재배열 자체는 SIMD 명령어를 사용하지 않으므로, 현재 기기가 지원하지 않는 arch를 위한 배치도 만들 수 있다.
+		 */
+		template<class IntTy, class Value>
+		void prepare(ArchType arch, IntTy* keys, Value* values, size_t size, Vector<uint8_t>& tempBuf)
+		{
+			if (size <= 1) return;
+			detail::applyOrder(detail::reorderImpl(arch, keys, size), keys, values, size, tempBuf);
 		}
 
 		template<ArchType arch, class IntTy, class Value, class Out>
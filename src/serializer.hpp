@@ -7,6 +7,7 @@
 #include <vector>
 #include <map>
 #include <unordered_map>
+#include <tuple>
 #include <cstdio>
 
 namespace kiwi
@@ -354,10 +355,38 @@ namespace kiwi
 			}
 		};
 
-		template<class _Ty1, class Ty2>
-		struct Serializer<std::unordered_map<_Ty1, Ty2>>
+		template<class ... Ty>
+		struct Serializer<std::tuple<Ty...>>
 		{
-			using VTy = std::unordered_map<_Ty1, Ty2>;
+			using VTy = std::tuple<Ty...>;
+
+			template<size_t ... i>
+			void write(std::ostream& ostr, const VTy& v, detail::seq<i...>)
+			{
+				writeMany(ostr, std::get<i>(v)...);
+			}
+
+			template<size_t ... i>
+			void read(std::istream& istr, VTy& v, detail::seq<i...>)
+			{
+				readMany(istr, std::get<i>(v)...);
+			}
+
+			void write(std::ostream& ostr, const VTy& v)
+			{
+				write(ostr, v, detail::GenSeq<sizeof...(Ty)>{});
+			}
+
+			void read(std::istream& istr, VTy& v)
+			{
+				read(istr, v, detail::GenSeq<sizeof...(Ty)>{});
+			}
+		};
+
+		template<class _Ty1, class Ty2, class Hash, class Eq, class Alloc>
+		struct Serializer<std::unordered_map<_Ty1, Ty2, Hash, Eq, Alloc>>
+		{
+			using VTy = std::unordered_map<_Ty1, Ty2, Hash, Eq, Alloc>;
 			void write(std::ostream& ostr, const VTy& v)
 			{
 				writeToStream(ostr, (uint32_t)v.size());
@@ -375,10 +404,10 @@ namespace kiwi
 			}
 		};
 
-		template<class _Ty1, class Ty2>
-		struct Serializer<std::map<_Ty1, Ty2>>
+		template<class _Ty1, class Ty2, class Cmp, class Alloc>
+		struct Serializer<std::map<_Ty1, Ty2, Cmp, Alloc>>
 		{
-			using VTy = std::map<_Ty1, Ty2>;
+			using VTy = std::map<_Ty1, Ty2, Cmp, Alloc>;
 			void write(std::ostream& ostr, const VTy& v)
 			{
 				writeToStream(ostr, (uint32_t)v.size());
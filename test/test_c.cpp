@@ -68,6 +68,39 @@ TEST(KiwiC, AnalyzeMultithread)
 	EXPECT_EQ(kiwi_close(kw), 0);
 }
 
+TEST(KiwiC, AnalyzeColumnar)
+{
+	kiwi_h kw = reuse_kiwi_instance();
+	const char16_t text[] = u"나는 학교에 갔다. (그리고) 집에 왔다.";
+	kiwi_res_h res = kiwi_analyze_w(kw, (const kchar16_t*)text, 2, KIWI_MATCH_ALL, nullptr, nullptr);
+	kiwi_cres_h cres = kiwi_analyze_columnar_w(kw, (const kchar16_t*)text, 2, KIWI_MATCH_ALL, nullptr, nullptr);
+	ASSERT_NE(res, nullptr);
+	ASSERT_NE(cres, nullptr);
+	ASSERT_EQ(kiwi_cres_size(cres), kiwi_res_size(res));
+
+	const uint32_t* resultOffsets = kiwi_cres_result_offsets(cres);
+	const uint32_t* formOffsets = kiwi_cres_form_offsets(cres);
+	const kchar16_t* forms = kiwi_cres_forms_w(cres);
+	const uint32_t* positions = kiwi_cres_positions(cres);
+	const uint8_t* tags = kiwi_cres_tags(cres);
+	EXPECT_EQ(resultOffsets[kiwi_cres_size(cres)], kiwi_cres_token_num(cres));
+	for (int i = 0; i < kiwi_res_size(res); ++i)
+	{
+		EXPECT_EQ(kiwi_cres_prob(cres, i), kiwi_res_prob(res, i));
+		ASSERT_EQ(resultOffsets[i + 1] - resultOffsets[i], kiwi_res_word_num(res, i));
+		for (int j = 0; j < kiwi_res_word_num(res, i); ++j)
+		{
+			const uint32_t t = resultOffsets[i] + j;
+			const kchar16_t* form = kiwi_res_form_w(res, i, j);
+			EXPECT_EQ(std::u16string((const char16_t*)forms + formOffsets[t], formOffsets[t + 1] - formOffsets[t]), std::u16string((const char16_t*)form));
+			EXPECT_EQ(positions[t], kiwi_res_position(res, i, j));
+			EXPECT_EQ(tags[t], kiwi_res_token_info(res, i, j)->tag);
+		}
+	}
+	EXPECT_EQ(kiwi_res_close(res), 0);
+	EXPECT_EQ(kiwi_cres_close(cres), 0);
+}
+
 TEST(KiwiC, Issue71_SentenceSplit_u16)
 {
 	kiwi_h kw = reuse_kiwi_instance();
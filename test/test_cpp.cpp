@@ -3,6 +3,8 @@
 #include <kiwi/Dataset.h>
 #include <kiwi/SubstringExtractor.h>
 #include "common.h"
+#include <random>
+#include "../src/LmState.hpp"
 
 class TestInitializer
 {
@@ -889,6 +891,64 @@ TEST(KiwiCpp, BuilderAddWords)
 	EXPECT_EQ(res.first[0].str, KWORD);
 }
 
+TEST(KiwiCpp, UserOverlay)
+{
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH }.build();
+	auto res = kiwi.analyze(KWORD, Match::all);
+	EXPECT_NE(res.first[0].str, KWORD);
+
+	EXPECT_EQ(kiwi.addUserWords({ { KWORD, POSTag::nnp, 0.f } }), 1);
+	EXPECT_EQ(kiwi.addUserWords({ { KWORD, POSTag::nnp, 1.f } }), 0);
+	EXPECT_EQ(kiwi.getUserOverlay()->size(), 1);
+
+	res = kiwi.analyze(KWORD, Match::all);
+	EXPECT_EQ(res.first[0].str, KWORD);
+	EXPECT_EQ(res.first[0].tag, POSTag::nnp);
+	EXPECT_EQ(res.first[0].morph, nullptr);
+
+	res = kiwi.analyze(std::u16string{ KWORD } + u"에서 만나요", Match::all);
+	EXPECT_EQ(res.first[0].str, KWORD);
+
+	// 오버레이를 교체하더라도 이전 결과가 캐시에 남아있어서는 안 된다
+	kiwi.setUserOverlay(nullptr);
+	res = kiwi.analyze(KWORD, Match::all);
+	EXPECT_NE(res.first[0].str, KWORD);
+
+	EXPECT_THROW(kiwi.addUserWords({ { u"띄어 쓴 단어", POSTag::nnp, 0.f } }), std::invalid_argument);
+	EXPECT_THROW(kiwi.addUserWords({ { u"팜파스하", POSTag::vv, 0.f } }), std::invalid_argument);
+	EXPECT_EQ(kiwi.getUserOverlay(), nullptr);
+}
+
+TEST(KiwiCpp, CloneSharesVocab)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	Kiwi tenant = kiwi.clone();
+	EXPECT_TRUE(tenant.ready());
+	EXPECT_TRUE(tenant.sharesVocabWith(kiwi));
+	EXPECT_EQ(tenant.getMorphemeSize(), kiwi.getMorphemeSize());
+
+	const std::u16string sent = u"이 예쁜 꽃은 독을 품었지만 진짜 아름다움을 가지고 있어요.";
+	auto expected = kiwi.analyze(sent, Match::all).first;
+	auto actual = tenant.analyze(sent, Match::all).first;
+	ASSERT_EQ(actual.size(), expected.size());
+	for (size_t i = 0; i < actual.size(); ++i)
+	{
+		EXPECT_EQ(actual[i].str, expected[i].str);
+		EXPECT_EQ(actual[i].tag, expected[i].tag);
+		EXPECT_EQ(actual[i].morph, expected[i].morph);
+	}
+
+	// 파생된 인스턴스에 추가한 단어는 원본에 영향을 주지 않는다
+	tenant.addUserWords({ { KWORD, POSTag::nnp, 0.f } });
+	EXPECT_EQ(tenant.analyze(KWORD, Match::all).first[0].str, KWORD);
+	EXPECT_NE(kiwi.analyze(KWORD, Match::all).first[0].str, KWORD);
+	EXPECT_EQ(kiwi.getUserOverlay(), nullptr);
+
+	Kiwi other = tenant.clone();
+	EXPECT_TRUE(other.sharesVocabWith(kiwi));
+	EXPECT_EQ(other.getUserOverlay(), tenant.getUserOverlay());
+}
+
 #define TEST_SENT u"이 예쁜 꽃은 독을 품었지만 진짜 아름다움을 가지고 있어요."
 
 TEST(KiwiCpp, AnalyzeWithNone)
@@ -919,6 +979,236 @@ TEST(KiwiCpp, AnalyzeSBG)
 	EXPECT_EQ(tokens[8].str, u"걸");
 }
 
+TEST(KiwiCpp, MappedKnLM)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	auto* knlm = kiwi.getKnLM();
+	EXPECT_FALSE(knlm->isMapped());
+	
+	std::vector<uint32_t> seq;
+	for (size_t i = 0; i < 200; ++i) seq.emplace_back((i * 7919) % knlm->getHeader().vocab_size);
+	std::vector<float> expected(seq.size()), ll(seq.size());
+	knlm->evaluate(seq.begin(), seq.end(), expected.begin());
+
+	auto mem = knlm->exportMappedLayout();
+	auto mapped = lm::KnLangModelBase::create(utils::MemoryObject{ std::move(mem) }, kiwi.archType());
+	EXPECT_TRUE(mapped->isMapped());
+	mapped->evaluate(seq.begin(), seq.end(), ll.begin());
+	EXPECT_EQ(expected, ll);
+
+	// loading the layout on another architecture should reorder keys instead of failing
+	const ArchType otherArch = kiwi.archType() == ArchType::balanced ? ArchType::none : ArchType::balanced;
+	auto reordered = lm::KnLangModelBase::create(knlm->exportMappedLayout(), otherArch);
+	EXPECT_FALSE(reordered->isMapped());
+	reordered->evaluate(seq.begin(), seq.end(), ll.begin());
+	EXPECT_EQ(expected, ll);
+
+	// the layout can also be exported in the key order of another architecture
+	auto otherLayout = lm::KnLangModelBase::create(knlm->exportMappedLayout(otherArch), otherArch);
+	EXPECT_TRUE(otherLayout->isMapped());
+	otherLayout->evaluate(seq.begin(), seq.end(), ll.begin());
+	EXPECT_EQ(expected, ll);
+}
+
+TEST(KiwiCpp, TunedArch)
+{
+	const ArchType tuned = getTunedArch();
+	EXPECT_NE(tuned, ArchType::default_);
+	EXPECT_EQ(tuned, getSelectedArch(tuned));
+	EXPECT_EQ(tuned, getTunedArch());
+
+	// the tuned architecture only changes the search kernel, not the results
+	Kiwi& kiwi = reuseKiwiInstance();
+	auto* knlm = kiwi.getKnLM();
+	std::vector<uint32_t> seq;
+	for (size_t i = 0; i < 200; ++i) seq.emplace_back((i * 7919) % knlm->getHeader().vocab_size);
+	std::vector<float> expected(seq.size()), ll(seq.size());
+	knlm->evaluate(seq.begin(), seq.end(), expected.begin());
+
+	auto tunedLm = lm::KnLangModelBase::create(knlm->exportMappedLayout(), tuned);
+	tunedLm->evaluate(seq.begin(), seq.end(), ll.begin());
+	EXPECT_EQ(expected, ll);
+}
+
+namespace
+{
+	template<class KeyTy>
+	void testBatchedProgress(const lm::KnLangModelBase* base)
+	{
+		// 탐색 순서가 같은 none 아키텍처로 다시 불러와서 구체 타입의 progressN과 nextN을 직접 호출한다
+		LangModel langMdl;
+		langMdl.knlm = lm::KnLangModelBase::create(base->exportMappedLayout(ArchType::none), ArchType::none);
+		auto* knlm = dynamic_cast<const lm::KnLangModel<ArchType::none, KeyTy>*>(langMdl.knlm.get());
+		ASSERT_NE(knlm, nullptr);
+		using State = KnLMState<ArchType::none, KeyTy>;
+
+		// 무작위 길이의 무작위 문맥을 거쳐 루트, leaf 직전, 하위 차수로 backoff된 노드 등 다양한 상태를 만든다
+		const size_t vocabSize = knlm->getHeader().vocab_size;
+		std::mt19937_64 rng{ 42 };
+		const size_t n = 1000;
+		std::vector<State> states(n, State{ langMdl });
+		std::vector<ptrdiff_t> nodes(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			ptrdiff_t node = i % 7 ? knlm->getBosNodeIdx() : 0;
+			for (size_t s = rng() % 6; s > 0; --s)
+			{
+				const KeyTy key = (KeyTy)(rng() % vocabSize);
+				knlm->progress(node, key);
+				states[i].next(langMdl, key);
+			}
+			nodes[i] = node;
+		}
+
+		LmTransitionCache cache;
+		cache.prepare(knlm->getInstanceId(), 256);
+		for (size_t round = 0; round < 4; ++round)
+		{
+			std::vector<uint32_t> keys(n);
+			std::vector<KeyTy> typedKeys(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				// 일부는 같은 키를 반복해 캐시 적중과 미적중이 섞이도록 한다
+				keys[i] = (uint32_t)(round % 2 && i % 3 ? keys[i / 3] : rng() % vocabSize);
+				typedKeys[i] = (KeyTy)keys[i];
+			}
+
+			std::vector<ptrdiff_t> expectedNodes = nodes;
+			std::vector<float> expectedLl(n), ll(n), stateLl(n);
+			for (size_t i = 0; i < n; ++i) expectedLl[i] = knlm->progress(expectedNodes[i], typedKeys[i]);
+			knlm->progressN(nodes.data(), typedKeys.data(), ll.data(), n);
+			EXPECT_EQ(expectedNodes, nodes);
+			EXPECT_EQ(expectedLl, ll);
+
+			std::vector<State> expectedStates = states;
+			for (size_t i = 0; i < n; ++i) expectedLl[i] = expectedStates[i].next(langMdl, typedKeys[i]);
+			State::nextN(langMdl, states.data(), keys.data(), stateLl.data(), n, round < 2 ? nullptr : &cache);
+			EXPECT_EQ(expectedLl, stateLl);
+			for (size_t i = 0; i < n; ++i) EXPECT_TRUE(expectedStates[i] == states[i]);
+		}
+	}
+}
+
+TEST(KiwiCpp, BatchedLmProgress)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	auto* knlm = kiwi.getKnLM();
+	switch (knlm->getHeader().key_size)
+	{
+	case 1:
+		return testBatchedProgress<uint8_t>(knlm);
+	case 2:
+		return testBatchedProgress<uint16_t>(knlm);
+	case 4:
+		return testBatchedProgress<uint32_t>(knlm);
+	default:
+		FAIL() << "unexpected key size";
+	}
+}
+
+TEST(KiwiCpp, BakedImage)
+{
+	KiwiBuilder builder{ MODEL_PATH, 0, BuildOption::default_, };
+	builder.addWord(KWORD, POSTag::nnp, 0.0);
+	for (auto typos : { DefaultTypoSet::withoutTypo, DefaultTypoSet::basicTypoSetWithContinual })
+	{
+		Kiwi kiwi = builder.build(typos);
+		kiwi.save("baked_test.kiwi");
+		Kiwi baked = Kiwi::loadBaked("baked_test.kiwi");
+		EXPECT_TRUE(baked.ready());
+		EXPECT_EQ(kiwi.isTypoTolerant(), baked.isTypoTolerant());
+
+		for (auto str : {
+			u"" KWORD u"는 형태소 분석기입니다.",
+			u"시간을 좀 더 달라고 해도 될까요?",
+			u"감사합니다 -친구들과 도와줬어",
+		})
+		{
+			auto expected = kiwi.analyze(str, 3, Match::allWithNormalizing);
+			auto res = baked.analyze(str, 3, Match::allWithNormalizing);
+			ASSERT_EQ(expected.size(), res.size());
+			for (size_t i = 0; i < res.size(); ++i)
+			{
+				EXPECT_EQ(expected[i].second, res[i].second);
+				ASSERT_EQ(expected[i].first.size(), res[i].first.size());
+				for (size_t j = 0; j < res[i].first.size(); ++j)
+				{
+					EXPECT_EQ(expected[i].first[j].str, res[i].first[j].str);
+					EXPECT_EQ(expected[i].first[j].tag, res[i].first[j].tag);
+					EXPECT_EQ(expected[i].first[j].position, res[i].first[j].position);
+				}
+			}
+		}
+
+		auto joiner = baked.newJoiner();
+		joiner.add(u"돕", POSTag::vvi);
+		joiner.add(u"어", POSTag::ec);
+		EXPECT_EQ(joiner.getU16(), u"도와");
+	}
+	std::remove("baked_test.kiwi");
+}
+
+TEST(KiwiCpp, ParallelBuildIsDeterministic)
+{
+	// 병렬 빌드는 형태 트라이, 오타 형태의 순서, 형태소 표를 단일 스레드 빌드와 똑같이 만들어야 한다
+	Kiwi serial = KiwiBuilder{ MODEL_PATH, 1 }.build(DefaultTypoSet::basicTypoSetWithContinual);
+	Kiwi parallel = KiwiBuilder{ MODEL_PATH, 4 }.build(DefaultTypoSet::basicTypoSetWithContinual);
+	ASSERT_EQ(serial.getNumThreads(), 1);
+	ASSERT_GT(parallel.getNumThreads(), 1);
+
+	ASSERT_EQ(serial.getMorphemeSize(), parallel.getMorphemeSize());
+	for (size_t i = 0; i < serial.getMorphemeSize(); ++i)
+	{
+		const Morpheme* a = serial.idToMorph(i);
+		const Morpheme* b = parallel.idToMorph(i);
+		EXPECT_EQ(a->kform == nullptr, b->kform == nullptr);
+		if (a->kform && b->kform) EXPECT_EQ(a->getForm(), b->getForm());
+		EXPECT_EQ(a->tag, b->tag);
+		EXPECT_EQ(a->senseId, b->senseId);
+		EXPECT_EQ(a->combined, b->combined);
+		EXPECT_EQ(a->lmMorphemeId, b->lmMorphemeId);
+		EXPECT_EQ(a->origMorphemeId, b->origMorphemeId);
+		ASSERT_EQ(a->chunks.size(), b->chunks.size());
+		for (size_t j = 0; j < a->chunks.size(); ++j)
+		{
+			EXPECT_EQ(serial.morphToId(a->chunks[j]), parallel.morphToId(b->chunks[j]));
+		}
+	}
+
+	auto data = loadTestCorpus();
+	for (auto s : { "외않됀데?", "ㅈ금 어디얌?", "사랑햌ㅋㅋ 진짜 고마어", "일찍 들어올께요" }) data.emplace_back(s);
+	size_t numTypos = 0;
+	for (auto& line : data)
+	{
+		const auto str = utf8To16(line);
+		auto expected = serial.analyze(str, 2, Match::allWithNormalizing);
+		auto res = parallel.analyze(str, 2, Match::allWithNormalizing);
+		ASSERT_EQ(expected.size(), res.size());
+		for (size_t i = 0; i < res.size(); ++i)
+		{
+			EXPECT_EQ(expected[i].second, res[i].second);
+			ASSERT_EQ(expected[i].first.size(), res[i].first.size());
+			for (size_t j = 0; j < res[i].first.size(); ++j)
+			{
+				auto& e = expected[i].first[j];
+				auto& r = res[i].first[j];
+				EXPECT_EQ(e.str, r.str);
+				EXPECT_EQ(e.tag, r.tag);
+				EXPECT_EQ(e.position, r.position);
+				EXPECT_EQ(serial.morphToId(e.morph), parallel.morphToId(r.morph));
+				EXPECT_EQ(e.typoCost, r.typoCost);
+				if (e.typoCost > 0)
+				{
+					EXPECT_EQ(e.typoFormId, r.typoFormId);
+					EXPECT_EQ(serial.getTypoForm(e.typoFormId), parallel.getTypoForm(r.typoFormId));
+					++numTypos;
+				}
+			}
+		}
+	}
+	EXPECT_GT(numTypos, 0);
+}
+
 TEST(KiwiCpp, AnalyzeMultithread)
 {
 	auto data = loadTestCorpus();
@@ -936,6 +1226,480 @@ TEST(KiwiCpp, AnalyzeMultithread)
 	EXPECT_EQ(data.size(), results.size());
 }
 
+TEST(KiwiCpp, AnalyzeStream)
+{
+	auto data = loadTestCorpus();
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 4 }.build();
+
+	std::vector<TokenResult> results;
+	size_t idx = 0;
+	auto stats = kiwi.analyzeStream(1, [&]() -> std::u16string
+	{
+		if (idx >= data.size()) return {};
+		return utf8To16(data[idx++]);
+	}, [&](std::vector<TokenResult>&& res)
+	{
+		results.emplace_back(std::move(res[0]));
+	}, Match::all, StreamOptions{ 3 });
+	EXPECT_EQ(stats.numInputs, data.size());
+	EXPECT_EQ(stats.numChunks, data.size());
+	EXPECT_LT(stats.maxReordered, 3);
+	ASSERT_EQ(results.size(), data.size());
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		auto expected = kiwi.analyze(data[i], Match::all);
+		ASSERT_EQ(results[i].first.size(), expected.first.size());
+		for (size_t j = 0; j < expected.first.size(); ++j)
+		{
+			EXPECT_EQ(results[i].first[j].str, expected.first[j].str);
+			EXPECT_EQ(results[i].first[j].position, expected.first[j].position);
+		}
+	}
+
+	// 긴 문서는 문장 경계에서 잘라 분석한 뒤 합쳐진다.
+	std::u16string longDoc;
+	for (size_t i = 0; i < 50; ++i)
+	{
+		longDoc += u"이 문장은 긴 문서를 나누어 분석하기 위한 시험용 문장입니다. (괄호 안의 내용) ";
+	}
+	bool done = false;
+	std::vector<TokenResult> chunked;
+	stats = kiwi.analyzeStream(1, [&]() -> std::u16string
+	{
+		if (done) return {};
+		done = true;
+		return longDoc;
+	}, [&](std::vector<TokenResult>&& res)
+	{
+		chunked = std::move(res);
+	}, Match::all, StreamOptions{ 0, 200 });
+	EXPECT_EQ(stats.numInputs, 1);
+	EXPECT_GT(stats.numChunks, 1);
+	ASSERT_EQ(chunked.size(), 1);
+	auto whole = kiwi.analyze(longDoc, Match::all);
+	ASSERT_EQ(chunked[0].first.size(), whole.first.size());
+	for (size_t j = 0; j < whole.first.size(); ++j)
+	{
+		auto& t = chunked[0].first[j];
+		EXPECT_EQ(t.str, whole.first[j].str);
+		EXPECT_EQ(t.position, whole.first[j].position);
+		EXPECT_EQ(t.sentPosition, whole.first[j].sentPosition);
+		EXPECT_EQ(t.wordPosition, whole.first[j].wordPosition);
+		EXPECT_EQ(t.pairedToken, whole.first[j].pairedToken);
+	}
+}
+
+TEST(KiwiCpp, AnalyzeParallelChunks)
+{
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 4 }.build();
+	std::u16string longDoc;
+	for (size_t i = 0; i < 50; ++i)
+	{
+		longDoc += u"이 문장은 긴 문서를 나누어 분석하기 위한 시험용 문장입니다. \"따옴표 안의 내용\"도 있습니다.\n";
+	}
+	auto whole = kiwi.analyze(longDoc, Match::all);
+
+	kiwi.setParallelChunkSize(300);
+	EXPECT_EQ(kiwi.getParallelChunkSize(), 300);
+	auto chunked = kiwi.analyze(longDoc, Match::all);
+	ASSERT_EQ(chunked.first.size(), whole.first.size());
+	for (size_t j = 0; j < whole.first.size(); ++j)
+	{
+		auto& t = chunked.first[j];
+		EXPECT_EQ(t.str, whole.first[j].str);
+		EXPECT_EQ(t.position, whole.first[j].position);
+		EXPECT_EQ(t.wordPosition, whole.first[j].wordPosition);
+		EXPECT_EQ(t.sentPosition, whole.first[j].sentPosition);
+		EXPECT_EQ(t.lineNumber, whole.first[j].lineNumber);
+		EXPECT_EQ(t.pairedToken, whole.first[j].pairedToken);
+	}
+
+	// 사전 분석된 구간은 잘리지 않으며, 그 ID는 전체 텍스트 기준으로 매겨진다.
+	std::vector<PretokenizedSpan> pretokenized;
+	for (size_t i = 0; i < 50; ++i)
+	{
+		const uint32_t b = (uint32_t)longDoc.find(u"시험용", i * (longDoc.size() / 50));
+		pretokenized.emplace_back(b, b + 3, std::vector<BasicToken>{ BasicToken{ u"시험용", 0, 3, POSTag::nng } });
+	}
+	auto chunkedPt = kiwi.analyze(longDoc, 1, Match::all, nullptr, pretokenized)[0];
+	size_t ptId = 0;
+	for (auto& t : chunkedPt.first)
+	{
+		if (t.str != u"시험용") continue;
+		EXPECT_EQ(t.typoFormId, ++ptId);
+	}
+	EXPECT_EQ(ptId, pretokenized.size());
+}
+
+TEST(KiwiCpp, LmTransitionCache)
+{
+	auto data = loadTestCorpus();
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 1 }.build();
+	kiwi.setLmCacheSize(0);
+	std::vector<TokenResult> uncached;
+	for (auto& line : data) uncached.emplace_back(kiwi.analyze(line, Match::all));
+	EXPECT_EQ(kiwi.getLmCacheStats().hits + kiwi.getLmCacheStats().misses, 0);
+
+	kiwi.setLmCacheSize(1024);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		auto res = kiwi.analyze(data[i], Match::all);
+		ASSERT_EQ(res.first.size(), uncached[i].first.size());
+		for (size_t j = 0; j < res.first.size(); ++j)
+		{
+			EXPECT_EQ(res.first[j].str, uncached[i].first[j].str);
+			EXPECT_EQ(res.first[j].tag, uncached[i].first[j].tag);
+		}
+		EXPECT_FLOAT_EQ(res.second, uncached[i].second);
+	}
+	auto stats = kiwi.getLmCacheStats();
+	EXPECT_GT(stats.hits, 0);
+	EXPECT_GT(stats.misses, 0);
+	kiwi.resetLmCacheStats();
+	EXPECT_EQ(kiwi.getLmCacheStats().hits, 0);
+}
+
+TEST(KiwiCpp, AnalyzeStats)
+{
+	auto data = loadTestCorpus();
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 1 }.build();
+	for (size_t i = 0; i < 10 && i < data.size(); ++i) kiwi.analyze(data[i], Match::all);
+	EXPECT_EQ(kiwi.getStats().numAnalyzed, 0);
+
+	kiwi.setCollectStats(true);
+	size_t numChars = 0;
+	for (size_t i = 0; i < 10 && i < data.size(); ++i)
+	{
+		kiwi.analyze(data[i], Match::all);
+		numChars += data[i].size();
+	}
+	auto stats = kiwi.getStats();
+	EXPECT_EQ(stats.numAnalyzed, std::min(data.size(), (size_t)10));
+	EXPECT_EQ(stats.numChars, numChars);
+	EXPECT_GT(stats.numSplits, 0);
+	EXPECT_GT(stats.numNodes, stats.numSplits);
+	EXPECT_GT(stats.numPathsEvaluated, 0);
+	EXPECT_GT(stats.numLmCalls, 0);
+	EXPECT_GT(stats.pathTime, 0);
+
+	kiwi.resetStats();
+	EXPECT_EQ(kiwi.getStats().numAnalyzed, 0);
+	EXPECT_EQ(kiwi.getStats().numLmCalls, 0);
+}
+
+TEST(KiwiCpp, ResultCache)
+{
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 1 }.build();
+	const std::u16string str = u"오늘 날씨가 좋아서 공원에 산책을 갔다.";
+	auto expected = kiwi.analyze(str, 3, Match::all);
+
+	kiwi.setResultCacheSize(64);
+	for (int i = 0; i < 3; ++i)
+	{
+		auto res = kiwi.analyze(str, 3, Match::all);
+		ASSERT_EQ(res.size(), expected.size());
+		for (size_t j = 0; j < res.size(); ++j)
+		{
+			ASSERT_EQ(res[j].first.size(), expected[j].first.size());
+			for (size_t k = 0; k < res[j].first.size(); ++k)
+			{
+				EXPECT_EQ(res[j].first[k].str, expected[j].first[k].str);
+				EXPECT_EQ(res[j].first[k].tag, expected[j].first[k].tag);
+			}
+			EXPECT_FLOAT_EQ(res[j].second, expected[j].second);
+		}
+	}
+	auto stats = kiwi.getResultCacheStats();
+	EXPECT_EQ(stats.misses, 1);
+	EXPECT_EQ(stats.hits, 2);
+
+	// different options are cached separately
+	kiwi.analyze(str, 1, Match::all);
+	kiwi.analyze(str, 3, Match::allWithNormalizing);
+	EXPECT_EQ(kiwi.getResultCacheStats().misses, 3);
+
+	// changing a setting must not return stale results
+	kiwi.setSpacePenalty(kiwi.getSpacePenalty() + 1);
+	kiwi.analyze(str, 3, Match::all);
+	EXPECT_EQ(kiwi.getResultCacheStats().misses, 4);
+
+	// modifying a blocklist in place must not return the result computed for its old contents
+	std::unordered_set<const Morpheme*> blocklist;
+	auto unblocked = kiwi.analyze(str, 1, Match::all, &blocklist);
+	ASSERT_FALSE(unblocked[0].first.empty());
+	const Morpheme* blocked = unblocked[0].first[0].morph;
+	ASSERT_NE(blocked, nullptr);
+	blocklist.insert(blocked);
+	auto res = kiwi.analyze(str, 1, Match::all, &blocklist);
+	for (auto& t : res[0].first) EXPECT_NE(t.morph, blocked);
+	blocklist.clear();
+	res = kiwi.analyze(str, 1, Match::all, &blocklist);
+	EXPECT_EQ(res[0].first[0].morph, blocked);
+
+	for (int i = 0; i < 100; ++i) kiwi.analyze(str + utf8To16(std::to_string(i)), Match::all);
+	stats = kiwi.getResultCacheStats();
+	EXPECT_LE(stats.size, 64);
+	EXPECT_GT(stats.evictions, 0);
+
+	kiwi.resetResultCacheStats();
+	EXPECT_EQ(kiwi.getResultCacheStats().hits, 0);
+	kiwi.setResultCacheSize(0);
+	kiwi.analyze(str, 3, Match::all);
+	EXPECT_EQ(kiwi.getResultCacheStats().misses, 0);
+}
+
+TEST(KiwiCpp, ChunkMemo)
+{
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 1 }.build();
+	std::u16string doc;
+	for (int i = 0; i < 5; ++i)
+	{
+		doc += u"감사합니다. 문의 사항은 고객센터로 연락 주시기 바랍니다. ";
+		doc += u"오늘은 " + utf8To16(std::to_string(i)) + u"번째 안내입니다. ";
+	}
+	auto expected = kiwi.analyze(doc, 2, Match::allWithNormalizing);
+
+	kiwi.setChunkMemoSize(64);
+	kiwi.setCollectStats(true);
+	for (int r = 0; r < 2; ++r)
+	{
+		auto res = kiwi.analyze(doc, 2, Match::allWithNormalizing);
+		ASSERT_EQ(res.size(), expected.size());
+		for (size_t i = 0; i < res.size(); ++i)
+		{
+			ASSERT_EQ(res[i].first.size(), expected[i].first.size());
+			for (size_t j = 0; j < res[i].first.size(); ++j)
+			{
+				EXPECT_EQ(res[i].first[j].str, expected[i].first[j].str);
+				EXPECT_EQ(res[i].first[j].tag, expected[i].first[j].tag);
+				EXPECT_EQ(res[i].first[j].position, expected[i].first[j].position);
+				EXPECT_EQ(res[i].first[j].length, expected[i].first[j].length);
+				EXPECT_EQ(res[i].first[j].sentPosition, expected[i].first[j].sentPosition);
+			}
+			EXPECT_FLOAT_EQ(res[i].second, expected[i].second);
+		}
+	}
+	EXPECT_GT(kiwi.getStats().numMemoHits, 0);
+
+	// modifying a blocklist in place must not reuse paths found for its old contents
+	std::unordered_set<const Morpheme*> blocklist;
+	auto unblocked = kiwi.analyze(doc, 1, Match::allWithNormalizing, &blocklist);
+	const Morpheme* blocked = unblocked[0].first[0].morph;
+	ASSERT_NE(blocked, nullptr);
+	blocklist.insert(blocked);
+	auto res = kiwi.analyze(doc, 1, Match::allWithNormalizing, &blocklist);
+	for (auto& t : res[0].first) EXPECT_NE(t.morph, blocked);
+}
+
+TEST(KiwiCpp, AnalyzeColumnar)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	ColumnarTokenResult columnar;
+	for (auto s : { u"나는 학교에 갔는데 \"선생님\"은 안 계셨다.\n(1) 새로운 줄", u"사랑해요 ㅋㅋ 오늘 날씨가 좋다!" })
+	{
+		const std::u16string str = s;
+		auto expected = kiwi.analyze(str, 3, Match::allWithNormalizing | Match::joinAffix);
+		kiwi.analyze(str, columnar, 3, Match::allWithNormalizing | Match::joinAffix);
+		const size_t input = columnar.numInputs() - 1;
+		ASSERT_EQ(columnar.inputOffsets[input + 1] - columnar.inputOffsets[input], expected.size());
+		for (size_t j = 0; j < expected.size(); ++j)
+		{
+			auto res = columnar.getResult(columnar.inputOffsets[input] + j);
+			EXPECT_EQ(res.second, expected[j].second);
+			ASSERT_EQ(res.first.size(), expected[j].first.size());
+			for (size_t k = 0; k < res.first.size(); ++k)
+			{
+				EXPECT_EQ(res.first[k].str, expected[j].first[k].str);
+				EXPECT_EQ(res.first[k].tag, expected[j].first[k].tag);
+				EXPECT_EQ(res.first[k].position, expected[j].first[k].position);
+				EXPECT_EQ(res.first[k].sentPosition, expected[j].first[k].sentPosition);
+				EXPECT_EQ(res.first[k].pairedToken, expected[j].first[k].pairedToken);
+			}
+		}
+	}
+	EXPECT_EQ(columnar.numInputs(), 2);
+}
+
+TEST(KiwiCpp, AnalyzeBatch)
+{
+	auto data = loadTestCorpus();
+	std::vector<std::u16string> strs;
+	for (auto& s : data) strs.emplace_back(utf8To16(s));
+	Kiwi kiwi = KiwiBuilder{ MODEL_PATH, 2 }.build();
+
+	auto batch = kiwi.analyzeBatch(strs, 2, Match::all);
+	EXPECT_EQ(batch.numInputs(), strs.size());
+	for (size_t i = 0; i < strs.size(); ++i)
+	{
+		auto expected = kiwi.analyze(strs[i], 2, Match::all);
+		ASSERT_EQ(batch.inputOffsets[i + 1] - batch.inputOffsets[i], expected.size());
+		for (size_t j = 0; j < expected.size(); ++j)
+		{
+			auto res = batch.getResult(batch.inputOffsets[i] + j);
+			EXPECT_EQ(res.second, expected[j].second);
+			ASSERT_EQ(res.first.size(), expected[j].first.size());
+			for (size_t k = 0; k < res.first.size(); ++k)
+			{
+				EXPECT_EQ(res.first[k].str, expected[j].first[k].str);
+				EXPECT_EQ(res.first[k].tag, expected[j].first[k].tag);
+				EXPECT_EQ(res.first[k].position, expected[j].first[k].position);
+				EXPECT_EQ(res.first[k].morph, expected[j].first[k].morph);
+			}
+		}
+	}
+
+	// 분석기의 스레드 풀 작업 안에서 호출해도 교착되지 않는다
+	auto pool = kiwi.shareThreadPool();
+	ASSERT_TRUE(pool);
+	std::vector<size_t> numInputs(pool->size() * 2);
+	utils::parallelFor(pool.get(), 0, numInputs.size(), [&](size_t, size_t i)
+	{
+		numInputs[i] = kiwi.analyzeBatch(strs, 1, Match::all).numInputs();
+	}, 1);
+	for (auto n : numInputs) EXPECT_EQ(n, strs.size());
+}
+
+TEST(KiwiCpp, ThreadPool)
+{
+	utils::ThreadPool pool{ 4, 8 };
+
+	std::vector<std::future<size_t>> futures;
+	for (size_t i = 0; i < 100; ++i)
+	{
+		futures.emplace_back(pool.enqueue([](size_t tid, size_t i) { return i * i; }, i));
+	}
+	for (size_t i = 0; i < futures.size(); ++i) EXPECT_EQ(futures[i].get(), i * i);
+
+	std::atomic<size_t> sum{ 0 };
+	utils::WaitGroup wg{ 1000 };
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		pool.submit([&, i](size_t tid)
+		{
+			EXPECT_LT(tid, pool.size());
+			sum += i;
+			wg.done();
+		});
+	}
+	wg.wait();
+	EXPECT_EQ(sum.load(), 1000 * 999 / 2);
+
+	std::vector<size_t> visited(10000);
+	utils::parallelFor(&pool, 0, visited.size(), [&](size_t tid, size_t i)
+	{
+		visited[i]++;
+	});
+	EXPECT_EQ(std::count(visited.begin(), visited.end(), 1), visited.size());
+
+	EXPECT_THROW(utils::parallelFor(&pool, 0, 100, [&](size_t tid, size_t i)
+	{
+		if (i == 50) throw std::runtime_error{ "error" };
+	}), std::runtime_error);
+
+	// 모든 작업자가 중첩된 호출을 기다리더라도 교착되지 않는다
+	std::vector<size_t> nestedVisited(pool.size() * 100);
+	std::atomic<size_t> nestedItems{ 0 };
+	utils::parallelFor(&pool, 0, pool.size(), [&](size_t, size_t i)
+	{
+		utils::parallelFor(&pool, i * 100, (i + 1) * 100, [&](size_t, size_t j) { nestedVisited[j]++; }, 1);
+		std::vector<size_t> items(10, i);
+		utils::forEach(&pool, items, [&](size_t, size_t) { nestedItems++; });
+	}, 1);
+	EXPECT_EQ(std::count(nestedVisited.begin(), nestedVisited.end(), 1), nestedVisited.size());
+	EXPECT_EQ(nestedItems.load(), pool.size() * 10);
+}
+
+TEST(KiwiCpp, ThreadPoolRunParallel)
+{
+	utils::ThreadPool pool{ 4 };
+
+	// 모든 참여자가 첫 단계를 마친 뒤에야 두번째 단계를 시작해야 한다
+	std::vector<size_t> stage(4);
+	std::atomic<size_t> violations{ 0 };
+	auto results = pool.runParallel(4, [&](size_t tid, size_t numThreads, utils::Barrier* barrier)
+	{
+		EXPECT_EQ(numThreads, 4);
+		stage[tid] = 1;
+		barrier->wait();
+		for (size_t i = 0; i < numThreads; ++i) if (stage[i] != 1) ++violations;
+		barrier->wait();
+		stage[tid] = 2;
+		return tid;
+	});
+	EXPECT_EQ(violations.load(), 0);
+	ASSERT_EQ(results.size(), 4);
+	for (size_t i = 0; i < results.size(); ++i) EXPECT_EQ(results[i].get(), i);
+
+	// 작업자 스레드 안에서 호출하면 교착 없이 혼자 실행된다
+	auto nested = pool.enqueue([&](size_t)
+	{
+		return pool.runParallel(4, [&](size_t tid, size_t numThreads, utils::Barrier* barrier)
+		{
+			return barrier ? (size_t)-1 : numThreads;
+		})[0].get();
+	});
+	EXPECT_EQ(nested.get(), 1);
+
+	// threadId 0을 맡은 호출 스레드에서 다시 호출해도 스스로를 기다리지 않고 혼자 실행된다
+	std::atomic<size_t> innerThreads{ 0 };
+	pool.runParallel(4, [&](size_t tid, size_t, utils::Barrier* barrier)
+	{
+		if (tid == 0)
+		{
+			pool.runParallel(4, [&](size_t, size_t numThreads, utils::Barrier*) { innerThreads = numThreads; });
+		}
+		barrier->wait();
+	});
+	EXPECT_EQ(innerThreads.load(), 1);
+
+	// 여러 스레드가 동시에 묶음 작업을 요청해도 교착되지 않는다
+	std::vector<std::thread> callers;
+	std::atomic<size_t> total{ 0 };
+	for (size_t c = 0; c < 4; ++c)
+	{
+		callers.emplace_back([&]()
+		{
+			for (size_t r = 0; r < 20; ++r)
+			{
+				pool.runParallel(3, [&](size_t tid, size_t numThreads, utils::Barrier* barrier)
+				{
+					barrier->wait();
+					total += tid;
+				});
+			}
+		});
+	}
+	for (auto& t : callers) t.join();
+	EXPECT_EQ(total.load(), 4 * 20 * 3);
+}
+
+TEST(KiwiCpp, SharedThreadPool)
+{
+	auto shared = utils::getSharedThreadPool();
+	ASSERT_TRUE(shared);
+	EXPECT_EQ(utils::acquireThreadPool(0), shared);
+	EXPECT_EQ(utils::acquireThreadPool(shared->size()), shared);
+	EXPECT_NE(utils::acquireThreadPool(shared->size() + 1), shared);
+
+	auto custom = std::make_shared<utils::ThreadPool>(2, 0, true);
+	std::vector<size_t> visited(1000);
+	utils::parallelFor(custom.get(), 0, visited.size(), [&](size_t, size_t i) { visited[i]++; });
+	EXPECT_EQ(std::count(visited.begin(), visited.end(), 1), visited.size());
+
+	utils::setSharedThreadPool(custom);
+	EXPECT_EQ(utils::getSharedThreadPool(), custom);
+	EXPECT_EQ(utils::acquireThreadPool(2), custom);
+	utils::setSharedThreadPool(shared);
+
+	Kiwi& kiwi = reuseKiwiInstance();
+	auto prevPool = kiwi.shareThreadPool();
+	kiwi.setThreadPool(custom);
+	EXPECT_EQ(kiwi.getNumThreads(), 2);
+	auto futures = kiwi.asyncAnalyze(std::string{ "스레드 풀을 공유하는 분석" }, 1, Match::all);
+	EXPECT_FALSE(futures.get().empty());
+	kiwi.setThreadPool(prevPool);
+}
+
 TEST(KiwiCpp, AnalyzeError01)
 {
 	Kiwi& kiwi = reuseKiwiInstance();
@@ -1235,6 +1999,26 @@ TEST(KiwiCpp, Issue181_SentenceSplitError)
 	EXPECT_EQ(res[4], std::make_pair((size_t)116, (size_t)124));
 }
 
+TEST(KiwiCpp, SplitIntoSentsFast)
+{
+	Kiwi& kiwi = reuseKiwiInstance();
+	for (auto text : {
+		u"다녀온 후기\n\n<강남 토끼정에 다녀왔습니다.> 음식도 맛있었어요 다만 역시 토끼정 본점 답죠?ㅎㅅㅎ 그 맛이 크으.. 아주 맛있었음...! ^^",
+		u"존 슈발John Schwall은 그에 꼭 들어맞는 흥미로운 사례였다. 슈발의 아버지와 할아버지는 스테이튼 아일랜드의 소방관이었다. “제 친가 쪽의 남자들은 모두 소방관이에요. 전 다 른 일을 하고 싶었죠.” 슈발이 말했다.",
+		u"특파원입니다. --지난",
+		u"특파원입니다.\n--지난",
+		u"그는 \"밥을 먹었다.\"라고 말했다. 나도 그랬다.",
+		u"",
+		u"   ",
+	})
+	{
+		EXPECT_EQ(kiwi.splitIntoSents(text), kiwi.splitIntoSentsFast(text));
+	}
+
+	std::string u8text = u8"음식도 맛있었어요 다만 역시 토끼정 본점 답죠? 그 맛이 크으..";
+	EXPECT_EQ(kiwi.splitIntoSents(u8text), kiwi.splitIntoSentsFast(u8text));
+}
+
 TEST(KiwiCpp, AddRule)
 {
 	Kiwi& okiwi = reuseKiwiInstance();
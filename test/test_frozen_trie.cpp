@@ -0,0 +1,182 @@
+#include "gtest/gtest.h"
+#include <sstream>
+#include <vector>
+#include <random>
+#include <map>
+
+#include <kiwi/ThreadPool.h>
+#include "../src/FrozenTrie.hpp"
+
+using namespace kiwi;
+
+namespace
+{
+	struct TestTrieNode : public utils::TrieNode<char16_t, const int*, utils::ConstAccess<std::map<char16_t, int32_t>>, TestTrieNode>
+	{
+	};
+
+	int valuePool[65536];
+
+	utils::ContinuousTrie<TestTrieNode> buildRandomTrie(size_t numOrphans, size_t numWords, unsigned seed)
+	{
+		std::mt19937 rng{ seed };
+		utils::ContinuousTrie<TestTrieNode> trie{ numOrphans + 1 };
+		for (size_t i = 1; i <= numOrphans; ++i) trie[i].val = &valuePool[i];
+
+		std::vector<std::u16string> words;
+		for (size_t i = 0; i < numWords; ++i)
+		{
+			std::u16string w;
+			const size_t len = 1 + rng() % 6;
+			for (size_t j = 0; j < len; ++j) w.push_back((char16_t)(u'a' + rng() % (j ? 12 : 300)));
+			words.emplace_back(std::move(w));
+		}
+		std::sort(words.begin(), words.end());
+
+		trie.reserveMore(numWords * 6);
+		decltype(trie)::CacheStore<std::u16string> cache;
+		for (size_t i = 0; i < words.size(); ++i)
+		{
+			trie.buildWithCaching(words[i], &valuePool[numOrphans + 1 + i], cache);
+		}
+		return trie;
+	}
+}
+
+template<ArchType arch, class TrieA, class TrieB>
+void expectSameMatches(const TrieA& ft, const TrieB& ct)
+{
+	std::mt19937 rng{ 7 };
+	for (size_t t = 0; t < 1000; ++t)
+	{
+		auto* a = ft.root();
+		auto* b = ct.root();
+		for (size_t k = 0; k < 40; ++k)
+		{
+			const char16_t c = (char16_t)(u'a' + rng() % (rng() % 3 ? 12 : 300));
+			auto* na = a->template nextOpt<arch>(ft, c);
+			while (!na && a->fail())
+			{
+				a = a->fail();
+				na = a->template nextOpt<arch>(ft, c);
+			}
+			auto* nb = b->template nextOpt<arch>(ct, c);
+			while (!nb && b->fail())
+			{
+				b = b->fail();
+				nb = b->template nextOpt<arch>(ct, c);
+			}
+			ASSERT_EQ(!!na, !!nb);
+			if (!na)
+			{
+				a = ft.root();
+				b = ct.root();
+				continue;
+			}
+			a = na;
+			b = nb;
+
+			auto* sa = a;
+			auto* sb = b;
+			for (; sa && sb; sa = sa->fail(), sb = sb->fail())
+			{
+				EXPECT_EQ(sa->val(ft), sb->val(ct));
+			}
+			EXPECT_EQ(!!sa, !!sb);
+		}
+	}
+}
+
+TEST(CompactFrozenTrie, SameMatchesAsFrozenTrie)
+{
+	static constexpr ArchType arch = ArchType::none;
+	static constexpr size_t numOrphans = 20;
+	auto trie = buildRandomTrie(numOrphans, 3000, 42);
+	utils::FrozenTrie<char16_t, const int*> ft{ trie, ArchTypeHolder<arch>{} };
+	utils::CompactFrozenTrie<char16_t, const int*> ct{ trie, ArchTypeHolder<arch>{} };
+
+	EXPECT_EQ(ft.size(), ct.size());
+	EXPECT_LT(ct.memorySize(), ft.memorySize());
+	for (size_t i = 0; i <= numOrphans; ++i) EXPECT_EQ(ft.value(i), ct.value(i));
+
+	expectSameMatches<arch>(ft, ct);
+}
+
+TEST(FrozenTrie, DirectTransitions)
+{
+	static constexpr ArchType arch = ArchType::none;
+	auto trie = buildRandomTrie(0, 3000, 3);
+	utils::FrozenTrie<char16_t, const int*> withTable{ trie, ArchTypeHolder<arch>{} };
+	auto withoutTable = withTable;
+	withoutTable.buildDirectTransitions(0);
+	EXPECT_GT(withTable.memorySize(), withoutTable.memorySize());
+	expectSameMatches<arch>(withTable, withoutTable);
+
+	// 예산이 부족하면 루트의 키 일부만 테이블에 담기고, 나머지는 기존 탐색으로 처리되어야 한다
+	auto smallTable = withoutTable;
+	smallTable.buildDirectTransitions(64 * sizeof(int32_t), 16);
+	EXPECT_GT(smallTable.memorySize(), withoutTable.memorySize());
+	expectSameMatches<arch>(smallTable, withoutTable);
+
+	utils::CompactFrozenTrie<char16_t, const int*> compact{ trie, ArchTypeHolder<arch>{} };
+	auto compactWithout = compact;
+	compactWithout.buildDirectTransitions(0);
+	EXPECT_GT(compact.memorySize(), compactWithout.memorySize());
+	expectSameMatches<arch>(compact, compactWithout);
+}
+
+TEST(CompactFrozenTrie, WriteAndRead)
+{
+	static constexpr ArchType arch = ArchType::none;
+	auto trie = buildRandomTrie(5, 1000, 1);
+	utils::CompactFrozenTrie<char16_t, const int*> ct{ trie, ArchTypeHolder<arch>{} };
+
+	std::stringstream ss;
+	ct.writeRaw(ss, [&](const int* v) -> uint32_t
+	{
+		if (ct.isNull(v)) return 0;
+		if (ct.hasSubmatch(v)) return (uint32_t)-1;
+		return v - valuePool + 1;
+	});
+
+	utils::CompactFrozenTrie<char16_t, const int*> restored;
+	restored.readRaw(ss, [](uint32_t v) -> const int*
+	{
+		if (v == 0) return nullptr;
+		if (v == (uint32_t)-1) return reinterpret_cast<const int*>(-1);
+		return &valuePool[v - 1];
+	});
+
+	std::vector<std::pair<const int*, std::vector<char16_t>>> orig, loaded;
+	ct.traverse([&](const int* v, const std::vector<char16_t>& prefix) { orig.emplace_back(v, prefix); });
+	restored.traverse([&](const int* v, const std::vector<char16_t>& prefix) { loaded.emplace_back(v, prefix); });
+	EXPECT_FALSE(orig.empty());
+	EXPECT_EQ(orig, loaded);
+
+	// FrozenTrie와 저장 형식이 다르므로 서로의 데이터를 읽으면 예외가 발생해야 한다
+	std::stringstream ss2;
+	utils::FrozenTrie<char16_t, const int*> ft{ trie, ArchTypeHolder<arch>{} };
+	ft.writeRaw(ss2, [&](const int* v) -> uint32_t { return ft.hasMatch(v) ? v - valuePool + 1 : 0; });
+	EXPECT_THROW(restored.readRaw(ss2, [](uint32_t) -> const int* { return nullptr; }), std::exception);
+}
+
+TEST(FrozenTrie, BuildWithThreadPool)
+{
+	static constexpr ArchType arch = ArchType::none;
+	static constexpr size_t numOrphans = 10;
+	auto trie = buildRandomTrie(numOrphans, 40000, 5);
+	utils::ThreadPool pool{ 4 };
+
+	// 스레드 풀을 사용해 생성한 결과는 단일 스레드로 생성한 것과 같아야 한다
+	utils::FrozenTrie<char16_t, const int*> ft{ trie, ArchTypeHolder<arch>{} };
+	utils::FrozenTrie<char16_t, const int*> ftPar{ trie, ArchTypeHolder<arch>{}, {}, &pool };
+	ASSERT_EQ(ft.size(), ftPar.size());
+	for (size_t i = 0; i < ft.size(); ++i) EXPECT_EQ(ft.value(i), ftPar.value(i));
+	expectSameMatches<arch>(ft, ftPar);
+
+	utils::CompactFrozenTrie<char16_t, const int*> ct{ trie, ArchTypeHolder<arch>{} };
+	utils::CompactFrozenTrie<char16_t, const int*> ctPar{ trie, ArchTypeHolder<arch>{}, {}, &pool };
+	ASSERT_EQ(ct.size(), ctPar.size());
+	for (size_t i = 0; i < ct.size(); ++i) EXPECT_EQ(ct.value(i), ctPar.value(i));
+	expectSameMatches<arch>(ct, ctPar);
+}
@@ -0,0 +1,541 @@
+#include <iostream>
+#include <fstream>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <new>
+
+#include <kiwi/Kiwi.h>
+#include <kiwi/SwTokenizer.h>
+#include <tclap/CmdLine.h>
+#include "../src/StrUtils.h"
+#include "../src/KTrie.h"
+#include "../src/PathEvaluator.hpp"
+#include "../src/search.h"
+#include "toolUtils.h"
+
+using namespace std;
+using namespace kiwi;
+
+// 분석 한 번에 일어나는 힙 할당 횟수를 세기 위해 전역 operator new를 대체한다.
+// KIWI_USE_MIMALLOC으로 빌드된 경우 Vector 등 내부 컨테이너의 할당은 mimalloc을 직접 거치므로 여기에 잡히지 않는다.
+static atomic<size_t> numHeapAllocs{ 0 };
+
+void* operator new(size_t size)
+{
+	numHeapAllocs.fetch_add(1, memory_order_relaxed);
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+namespace kiwi
+{
+	/**
+	 * @brief kiwi-bench에서 Kiwi의 내부 단계(splitByTrie, findBestPath, formTrie 탐색)를 따로 측정하기 위한 접근자
+	 */
+	class KiwiBenchmark
+	{
+	public:
+		struct Graph
+		{
+			KString normalized;
+			Vector<Vector<KGraphNode>> chunks;
+		};
+
+		static void splitByTrie(const Kiwi& kw, const u16string& str, Match matchOptions, Graph& out)
+		{
+			Vector<uint32_t> positionTable;
+			out.normalized.clear();
+			out.chunks.clear();
+			normalizeHangulWithPosition(str.begin(), str.end(), back_inserter(out.normalized), back_inserter(positionTable));
+			if (!!(matchOptions & Match::normalizeCoda)) normalizeCoda(out.normalized.begin(), out.normalized.end());
+
+			const PretokenizedSpanGroup::Span* ptFirst = nullptr;
+			size_t splitEnd = 0;
+			while (splitEnd < out.normalized.size())
+			{
+				Vector<KGraphNode> nodes;
+				splitEnd = (*reinterpret_cast<FnSplitByTrie>(kw.dfSplitByTrie))(
+					nodes,
+					kw.vocab->forms.data(),
+					kw.vocab->typoPtrs.data(),
+					kw.vocab->formTrie,
+					std::atomic_load(&kw.userOverlay).get(),
+					U16StringView{ out.normalized.data() + splitEnd, out.normalized.size() - splitEnd },
+					splitEnd,
+					matchOptions,
+					kw.maxUnkFormSize,
+					kw.spaceTolerance,
+					kw.continualTypoCost,
+					kw.lengtheningTypoCost,
+					ptFirst,
+					nullptr
+				);
+				if (nodes.size() <= 2) continue;
+				out.chunks.emplace_back(move(nodes));
+			}
+		}
+
+		static size_t findBestPath(const Kiwi& kw, const Graph& graph, size_t topN, Match matchOptions)
+		{
+			Vector<SpecialState> spStates;
+			size_t numPathes = 0;
+			for (auto& nodes : graph.chunks)
+			{
+				auto res = (*reinterpret_cast<FnFindBestPath>(kw.dfFindBestPath))(
+					&kw,
+					spStates,
+					nodes.data(),
+					nodes.size(),
+					topN,
+					false,
+					!!(matchOptions & Match::splitComplex),
+					!!(matchOptions & Match::splitSaisiot),
+					!!(matchOptions & Match::mergeSaisiot),
+					nullptr
+				);
+				spStates.clear();
+				for (auto& r : res) spStates.emplace_back(r.curState);
+				numPathes += res.size();
+			}
+			return numPathes;
+		}
+
+		static size_t formTrieBytes(const Kiwi& kw)
+		{
+			return kw.vocab->formTrie.memorySize();
+		}
+
+		static size_t findForms(const Kiwi& kw, const vector<KString>& forms)
+		{
+			size_t found = 0;
+			auto fn = reinterpret_cast<FnFindForm>(kw.dfFindForm);
+			for (auto& f : forms)
+			{
+				found += (*fn)(kw.vocab->formTrie, kw.vocab->forms.data(), f) ? 1 : 0;
+			}
+			return found;
+		}
+	};
+}
+
+struct BenchResult
+{
+	string name;
+	size_t threads = 1;
+	size_t items = 0;
+	size_t chars = 0;
+	vector<double> runs;
+	vector<double> latencies;
+	vector<pair<string, double>> extra;
+};
+
+inline double percentile(vector<double> v, double p)
+{
+	if (v.empty()) return 0;
+	sort(v.begin(), v.end());
+	const size_t idx = min((size_t)(p * (v.size() - 1) + 0.5), v.size() - 1);
+	return v[idx];
+}
+
+class Bench
+{
+	size_t warmup, repeat;
+	string filter;
+	vector<BenchResult> results;
+public:
+	Bench(size_t _warmup, size_t _repeat, const string& _filter)
+		: warmup{ _warmup }, repeat{ _repeat }, filter{ _filter }
+	{
+	}
+
+	bool enabled(const string& name) const
+	{
+		return filter.empty() || name.find(filter) != name.npos;
+	}
+
+	/**
+	 * @brief fn을 warmup번 실행한 뒤 repeat번 실행하며 각 실행 시간(ms)을 기록한다.
+	 */
+	BenchResult* run(const string& name, size_t threads, size_t items, size_t chars, const function<void()>& fn)
+	{
+		if (!enabled(name)) return nullptr;
+		BenchResult r;
+		r.name = name;
+		r.threads = threads;
+		r.items = items;
+		r.chars = chars;
+		for (size_t i = 0; i < warmup; ++i) fn();
+		for (size_t i = 0; i < repeat; ++i)
+		{
+			tutils::Timer timer;
+			fn();
+			r.runs.emplace_back(timer.getElapsed());
+		}
+		const double med = percentile(r.runs, 0.5);
+		cerr << name << " (threads=" << threads << "): " << med << " ms, "
+			<< (med > 0 ? items / (med / 1000) : 0) << " items/s" << endl;
+		results.emplace_back(move(r));
+		return &results.back();
+	}
+
+	void writeJson(ostream& out, const string& modelPath, const Kiwi& kiwi, const vector<string>& inputs, size_t numLines) const
+	{
+		out << "{\n";
+		out << "  \"version\": \"" << KIWI_VERSION_STRING << "\",\n";
+		out << "  \"model\": \"" << modelPath << "\",\n";
+		out << "  \"arch\": \"" << archToStr(kiwi.archType()) << "\",\n";
+		out << "  \"hardware_threads\": " << thread::hardware_concurrency() << ",\n";
+		out << "  \"warmup\": " << warmup << ",\n";
+		out << "  \"repeat\": " << repeat << ",\n";
+		out << "  \"inputs\": [";
+		for (size_t i = 0; i < inputs.size(); ++i) out << (i ? ", " : "") << "\"" << inputs[i] << "\"";
+		out << "],\n";
+		out << "  \"lines\": " << numLines << ",\n";
+		out << "  \"benchmarks\": [\n";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			auto& r = results[i];
+			const double med = percentile(r.runs, 0.5);
+			out << "    {\"name\": \"" << r.name << "\", \"threads\": " << r.threads
+				<< ", \"items\": " << r.items << ", \"chars\": " << r.chars
+				<< ", \"median_ms\": " << med
+				<< ", \"min_ms\": " << *min_element(r.runs.begin(), r.runs.end())
+				<< ", \"max_ms\": " << *max_element(r.runs.begin(), r.runs.end())
+				<< ", \"items_per_sec\": " << (med > 0 ? r.items / (med / 1000) : 0)
+				<< ", \"chars_per_sec\": " << (med > 0 ? r.chars / (med / 1000) : 0);
+			if (!r.latencies.empty())
+			{
+				out << ", \"latency_us\": {\"p50\": " << percentile(r.latencies, 0.5)
+					<< ", \"p90\": " << percentile(r.latencies, 0.9)
+					<< ", \"p99\": " << percentile(r.latencies, 0.99)
+					<< ", \"max\": " << percentile(r.latencies, 1) << "}";
+			}
+			for (auto& e : r.extra)
+			{
+				out << ", \"" << e.first << "\": " << e.second;
+			}
+			out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+		out << "  ]\n";
+		out << "}\n";
+	}
+};
+
+int run(const string& modelPath, const string& output, const string& tokenizerPath, const string& filter,
+	int warmup, int repeat, int maxThreads, bool sbg, const vector<string>& inputs)
+{
+	try
+	{
+		vector<string> lines;
+		size_t totalChars = 0;
+		for (auto& f : inputs)
+		{
+			ifstream in{ f };
+			if (!in) throw runtime_error{ "cannot open file: " + f };
+			for (string line; getline(in, line);)
+			{
+				// eval_data는 `문장\t정답` 형식이므로 첫번째 열만 사용한다.
+				line = line.substr(0, line.find('\t'));
+				while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+				if (line.empty()) continue;
+				lines.emplace_back(move(line));
+			}
+		}
+		if (lines.empty()) throw runtime_error{ "no input lines" };
+
+		vector<u16string> u16lines;
+		for (auto& l : lines)
+		{
+			u16lines.emplace_back(utf8To16(l));
+			totalChars += u16lines.back().size();
+		}
+
+		const Match matchOptions = Match::allWithNormalizing;
+		Bench bench{ (size_t)warmup, (size_t)repeat, filter };
+		Kiwi kiwi = KiwiBuilder{ modelPath, 1, BuildOption::default_, sbg }.build();
+		cerr << "Kiwi v" << KIWI_VERSION_STRING << ", arch: " << archToStr(kiwi.archType())
+			<< ", lines: " << lines.size() << ", chars: " << totalChars << endl;
+
+		if (bench.enabled("nst.tune"))
+		{
+			// 키 크기와 배열 길이 구간별로 가장 빠른 탐색 커널을 출력한다
+			auto tuned = nst::tuneSearch(getBestArch());
+			for (size_t w = 0; w < nst::SearchTuneResult::numKeyWidths; ++w)
+			{
+				cerr << "nst.tune (key=" << nst::SearchTuneResult::keyWidth(w) << "B):";
+				for (size_t b = 0; b < nst::SearchTuneResult::numSizeBuckets; ++b)
+				{
+					const auto a = tuned.bucketBest[w][b];
+					cerr << " " << nst::SearchTuneResult::bucketSize(b) << "=" << archToStr(a)
+						<< "(" << tuned.nsPerSearch[static_cast<size_t>(a)][w][b] << "ns)";
+				}
+				cerr << endl;
+			}
+			cerr << "nst.tune: " << archToStr(tuned.best) << " (current: " << archToStr(kiwi.archType()) << ")" << endl;
+		}
+
+		// stage benchmarks
+		{
+			deque<KiwiBenchmark::Graph> graphs;
+			for (auto& l : u16lines)
+			{
+				graphs.emplace_back();
+				KiwiBenchmark::splitByTrie(kiwi, l, matchOptions, graphs.back());
+			}
+
+			if (auto* r = bench.run("splitByTrie", 1, lines.size(), totalChars, [&]()
+			{
+				KiwiBenchmark::Graph g;
+				for (auto& l : u16lines) KiwiBenchmark::splitByTrie(kiwi, l, matchOptions, g);
+			}))
+			{
+				r->extra.emplace_back("form_trie_bytes", (double)KiwiBenchmark::formTrieBytes(kiwi));
+			}
+
+			bench.run("findBestPath", 1, lines.size(), totalChars, [&]()
+			{
+				for (auto& g : graphs) KiwiBenchmark::findBestPath(kiwi, g, 1, matchOptions);
+			});
+
+			vector<KString> eojeols;
+			size_t eojeolChars = 0;
+			for (auto& l : u16lines)
+			{
+				auto norm = normalizeHangul(l);
+				for (size_t b = 0; b < norm.size();)
+				{
+					size_t e = norm.find(u' ', b);
+					if (e == norm.npos) e = norm.size();
+					if (e > b)
+					{
+						eojeols.emplace_back(norm.substr(b, e - b));
+						eojeolChars += e - b;
+					}
+					b = e + 1;
+				}
+			}
+			bench.run("formTrie.findForm", 1, eojeols.size(), eojeolChars, [&]()
+			{
+				KiwiBenchmark::findForms(kiwi, eojeols);
+			});
+		}
+
+		vector<TokenResult> analyzed;
+		for (auto& l : u16lines) analyzed.emplace_back(kiwi.analyze(l, matchOptions));
+
+		if (bench.enabled("knlm.progress"))
+		{
+			vector<vector<uint32_t>> seqs;
+			size_t numTokens = 0;
+			for (auto& r : analyzed)
+			{
+				seqs.emplace_back();
+				for (auto& t : r.first)
+				{
+					if (t.morph) seqs.back().emplace_back(t.morph->lmMorphemeId);
+				}
+				numTokens += seqs.back().size();
+			}
+			auto* knlm = kiwi.getKnLM();
+			vector<float> scores;
+			bench.run("knlm.progress", 1, numTokens, 0, [&]()
+			{
+				for (auto& s : seqs)
+				{
+					scores.resize(s.size());
+					knlm->evaluate(s.begin(), s.end(), scores.begin());
+				}
+			});
+		}
+
+		if (bench.enabled("joiner"))
+		{
+			size_t numTokens = 0;
+			for (auto& r : analyzed) numTokens += r.first.size();
+			bench.run("joiner", 1, numTokens, totalChars, [&]()
+			{
+				for (auto& r : analyzed)
+				{
+					auto joiner = kiwi.newJoiner();
+					for (auto& t : r.first) joiner.add(t.str, t.tag);
+					joiner.getU16();
+				}
+			});
+		}
+
+		if (bench.enabled("splitIntoSents"))
+		{
+			// 여러 줄을 하나의 문서로 묶어서 문장 분리를 수행한다.
+			vector<u16string> docs;
+			for (size_t i = 0; i < u16lines.size(); i += 16)
+			{
+				docs.emplace_back();
+				for (size_t j = i; j < min(i + 16, u16lines.size()); ++j)
+				{
+					docs.back() += u16lines[j];
+					docs.back() += u' ';
+				}
+			}
+			bench.run("splitIntoSents", 1, docs.size(), totalChars, [&]()
+			{
+				for (auto& d : docs) kiwi.splitIntoSents(d, matchOptions);
+			});
+
+			if (auto* r = bench.run("splitIntoSentsFast", 1, docs.size(), totalChars, [&]()
+			{
+				for (auto& d : docs) kiwi.splitIntoSentsFast(d, matchOptions);
+			}))
+			{
+				// 전체 분석 결과와 문장 경계가 완전히 일치하는 문서의 비율
+				size_t same = 0;
+				for (auto& d : docs) same += kiwi.splitIntoSents(d, matchOptions) == kiwi.splitIntoSentsFast(d, matchOptions) ? 1 : 0;
+				r->extra.emplace_back("agreement", docs.empty() ? 0. : (double)same / docs.size());
+			}
+		}
+
+		if (!tokenizerPath.empty() && bench.enabled("swTokenizer.encode"))
+		{
+			ifstream tin{ tokenizerPath };
+			if (!tin) throw runtime_error{ "cannot open file: " + tokenizerPath };
+			auto tokenizer = SwTokenizer::load(kiwi, tin);
+			vector<uint32_t> ids;
+			bench.run("swTokenizer.encode", 1, lines.size(), totalChars, [&]()
+			{
+				for (auto& l : lines)
+				{
+					ids.clear();
+					tokenizer.encode(ids, l);
+				}
+			});
+		}
+
+		// end-to-end
+		if (bench.enabled("analyze"))
+		{
+			kiwi.resetLmCacheStats();
+			vector<double> latencies;
+			size_t runs = 0, allocs = 0, arenaAllocs = 0;
+			auto& arena = utils::Arena::local();
+			auto* r = bench.run("analyze", 1, lines.size(), totalChars, [&]()
+			{
+				const bool measured = runs++ >= (size_t)warmup;
+				for (auto& l : u16lines)
+				{
+					const size_t allocsBefore = numHeapAllocs.load(memory_order_relaxed);
+					const size_t arenaBefore = arena.heapAllocations();
+					tutils::Timer timer;
+					kiwi.analyze(l, matchOptions);
+					if (measured)
+					{
+						latencies.emplace_back(timer.getElapsed() * 1000);
+						allocs += numHeapAllocs.load(memory_order_relaxed) - allocsBefore;
+						arenaAllocs += arena.heapAllocations() - arenaBefore;
+					}
+				}
+			});
+			if (r)
+			{
+				const double numMeasured = max(latencies.size(), (size_t)1);
+				r->latencies = move(latencies);
+				r->extra.emplace_back("lm_cache_hit_rate", kiwi.getLmCacheStats().hitRate());
+				r->extra.emplace_back("allocs_per_sentence", allocs / numMeasured);
+				r->extra.emplace_back("arena_allocs_per_sentence", arenaAllocs / numMeasured);
+			}
+
+			vector<int> threadCounts;
+			for (int t = 2; t < maxThreads; t *= 2) threadCounts.emplace_back(t);
+			if (maxThreads > 1) threadCounts.emplace_back(maxThreads);
+			for (int t : threadCounts)
+			{
+				Kiwi mtKiwi = KiwiBuilder{ modelPath, (size_t)t, BuildOption::default_, sbg }.build();
+				bench.run("analyze", (size_t)t, lines.size(), totalChars, [&]()
+				{
+					size_t i = 0;
+					mtKiwi.analyzeStream(1, [&]() -> u16string
+					{
+						if (i >= u16lines.size()) return {};
+						return u16lines[i++];
+					}, [&](vector<TokenResult>&& res)
+					{
+					}, matchOptions);
+				});
+			}
+		}
+
+		if (output.empty())
+		{
+			bench.writeJson(cout, modelPath, kiwi, inputs, lines.size());
+		}
+		else
+		{
+			ofstream out{ output };
+			if (!out) throw runtime_error{ "cannot open file: " + output };
+			bench.writeJson(out, modelPath, kiwi, inputs, lines.size());
+		}
+		return 0;
+	}
+	catch (const exception& e)
+	{
+		cerr << e.what() << endl;
+		return -1;
+	}
+}
+
+using namespace TCLAP;
+
+int main(int argc, const char* argv[])
+{
+	tutils::setUTF8Output();
+
+	CmdLine cmd{ "Kiwi Benchmark", ' ', KIWI_VERSION_STRING };
+
+	ValueArg<string> model{ "m", "model", "Kiwi model path", false, "models/base", "string" };
+	ValueArg<string> output{ "o", "output", "output json path (default: stdout)", false, "", "string" };
+	ValueArg<string> tokenizer{ "", "tokenizer", "SwTokenizer json path for swTokenizer.encode benchmark", false, "", "string" };
+	ValueArg<string> filter{ "f", "filter", "run only benchmarks whose name contains this", false, "", "string" };
+	ValueArg<int> warmup{ "", "warmup", "number of warm-up runs per benchmark", false, 1, "int >= 0" };
+	ValueArg<int> repeat{ "r", "repeat", "number of measured runs per benchmark", false, 5, "int > 0" };
+	ValueArg<int> threads{ "j", "threads", "max number of threads for analyze benchmark", false, (int)std::max(std::thread::hardware_concurrency(), 1u), "int > 0" };
+	SwitchArg sbg{ "", "sbg", "use SkipBigram" };
+	UnlabeledMultiArg<string> files{ "inputs", "input files (default: eval_data/*.txt)", false, "string" };
+
+	cmd.add(model);
+	cmd.add(output);
+	cmd.add(tokenizer);
+	cmd.add(filter);
+	cmd.add(warmup);
+	cmd.add(repeat);
+	cmd.add(threads);
+	cmd.add(sbg);
+	cmd.add(files);
+
+	try
+	{
+		cmd.parse(argc, argv);
+	}
+	catch (const ArgException& e)
+	{
+		cerr << "error: " << e.error() << " for arg " << e.argId() << endl;
+		return -1;
+	}
+
+	vector<string> inputs = files.getValue();
+	if (inputs.empty())
+	{
+		inputs = { "eval_data/web.txt", "eval_data/web_with_typos.txt", "eval_data/web_with_cont_typos.txt", "eval_data/written.txt" };
+	}
+	return run(model, output, tokenizer, filter, std::max((int)warmup, 0), std::max((int)repeat, 1), std::max((int)threads, 1), sbg, inputs);
+}
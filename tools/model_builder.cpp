@@ -29,7 +29,7 @@ vector<size_t> splitMultipleInts(const string& s, const char delim = ',')
 	}
 }
 
-int run(const KiwiBuilder::ModelBuildArgs& args, const string& output, bool skipBigram)
+int run(const KiwiBuilder::ModelBuildArgs& args, const string& output, bool skipBigram, bool mappable, ArchType layout)
 {
 	try
 	{
@@ -41,7 +41,7 @@ int run(const KiwiBuilder::ModelBuildArgs& args, const string& output, bool skip
 		}
 		else
 		{
-			KiwiBuilder{ args }.saveModel(output);
+			KiwiBuilder{ args }.saveModel(output, mappable, layout);
 		}
 		double tm = timer.getElapsed();
 		cout << "Total: " << tm << " ms " << endl;
@@ -67,6 +67,8 @@ int main(int argc, const char* argv[])
 	SwitchArg quantize{ "", "quantize", "quantize LM" };
 	SwitchArg tagHistory{ "", "history", "use tag history of LM" };
 	SwitchArg skipBigram{ "", "skipbigram", "build skipbigram model" };
+	SwitchArg mappable{ "", "mappable", "save LM in memory-mappable layout" };
+	ValueArg<string> layout{ "", "layout", "key order of the mappable LM (none: eytzinger, balanced: sorted, sse2/sse4_1/avx2/avx512bw/neon: b-tree). implies --mappable", false, "", "string" };
 	ValueArg<size_t> workers{ "w", "workers", "number of workers", false, 1, "int" };
 	ValueArg<size_t> morMinCnt{ "", "morpheme_min_cnt", "min count of morpheme", false, 10, "int" };
 	ValueArg<size_t> lmOrder{ "", "order", "order of LM", false, 4, "int" };
@@ -83,6 +85,8 @@ int main(int argc, const char* argv[])
 	cmd.add(quantize);
 	cmd.add(tagHistory);
 	cmd.add(skipBigram);
+	cmd.add(mappable);
+	cmd.add(layout);
 	cmd.add(morMinCnt);
 	cmd.add(lmOrder);
 	cmd.add(lmMinCnt);
@@ -125,6 +129,20 @@ int main(int argc, const char* argv[])
 		cerr << "error: min_cnt size should be 1 or equal to order" << endl;
 		return -1;
 	}
-	return run(args, output, skipBigram);
+
+	ArchType layoutArch = ArchType::default_;
+	if (!layout.getValue().empty())
+	{
+		for (size_t i = 1; i <= static_cast<size_t>(ArchType::last); ++i)
+		{
+			if (layout.getValue() == archToStr(static_cast<ArchType>(i))) layoutArch = static_cast<ArchType>(i);
+		}
+		if (layoutArch == ArchType::default_)
+		{
+			cerr << "error: unknown layout: " << layout.getValue() << endl;
+			return -1;
+		}
+	}
+	return run(args, output, skipBigram, mappable || layoutArch != ArchType::default_, layoutArch);
 }
 
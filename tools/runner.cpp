@@ -8,9 +8,9 @@
 using namespace std;
 using namespace kiwi;
 
-void printResult(Kiwi& kw, const string& line, int topn, bool score, ostream& out)
+void printResult(const vector<TokenResult>& results, int topn, bool score, ostream& out)
 {
-	for (auto& result : kw.analyze(line, topn, Match::allWithNormalizing))
+	for (auto& result : results)
 	{
 		for (auto& t : result.first)
 		{
@@ -22,13 +22,20 @@ void printResult(Kiwi& kw, const string& line, int topn, bool score, ostream& ou
 	if (topn > 1) out << endl;
 }
 
-int run(const string& modelPath, bool benchmark, const string& output, const string& user, int topn, int tolerance, float typos, bool score, bool sbg, const vector<string>& input)
+void printResult(Kiwi& kw, const string& line, int topn, bool score, ostream& out)
+{
+	printResult(kw.analyze(line, topn, Match::allWithNormalizing), topn, score, out);
+}
+
+int run(const string& modelPath, bool benchmark, const string& output, const string& user, int topn, int tolerance, float typos, bool score, bool sbg, 
+	int threads, int window, int chunk, int cache, int memo, const vector<string>& input)
 {
 	try
 	{
 		tutils::Timer timer;
 		size_t lines = 0, bytes = 0;
-		Kiwi kw = KiwiBuilder{ modelPath, 1, BuildOption::default_, sbg }.build(typos > 0 ? DefaultTypoSet::basicTypoSet : DefaultTypoSet::withoutTypo);
+		StreamStats streamStats;
+		Kiwi kw = KiwiBuilder{ modelPath, (size_t)max(threads, 1), BuildOption::default_, sbg }.build(typos > 0 ? DefaultTypoSet::basicTypoSet : DefaultTypoSet::withoutTypo);
 
 		cout << "Kiwi v" << KIWI_VERSION_STRING << endl;
 		if (tolerance)
@@ -41,6 +48,16 @@ int run(const string& modelPath, bool benchmark, const string& output, const str
 			kw.setTypoCostWeight(typos);
 			cout << "Typo Correction Cost Weight: " << typos << endl;
 		}
+		if (cache > 0)
+		{
+			kw.setResultCacheSize(cache);
+			cout << "Result Cache Size: " << cache << endl;
+		}
+		if (memo > 0)
+		{
+			kw.setChunkMemoSize(memo);
+			cout << "Chunk Memo Size: " << memo << endl;
+		}
 
 		if (benchmark)
 		{
@@ -49,6 +66,7 @@ int run(const string& modelPath, bool benchmark, const string& output, const str
 			cout << "LM Size : " << (kw.getKnLM()->getMemory().size() / 1024. / 1024.) << " MB" << endl;
 			cout << "Mem Usage : " << (tutils::getCurrentPhysicalMemoryUsage() / 1024.) << " MB" << endl;
 			cout << "ModelType : " << (sbg ? "sbg" : "knlm") << endl;
+			kw.setCollectStats(true);
 		}
 
 		ostream* out = &cout;
@@ -89,11 +107,34 @@ int run(const string& modelPath, bool benchmark, const string& output, const str
 					throw runtime_error{ "cannot open file: " + f };
 				}
 
-				for (string line; getline(in, line);)
+				if (threads > 1)
 				{
-					printResult(kw, line, topn, score, *out);
-					++lines;
-					bytes += line.size();
+					auto stats = kw.analyzeStream(topn, [&]() -> u16string
+					{
+						string line;
+						if (!getline(in, line)) return {};
+						++lines;
+						bytes += line.size();
+						// an empty string means the end of input for the reader, so a blank line is passed as a single space
+						return line.empty() ? u" " : utf8To16(line);
+					}, [&](vector<TokenResult>&& res)
+					{
+						printResult(res, topn, score, *out);
+					}, Match::allWithNormalizing, StreamOptions{ (size_t)window, (size_t)chunk });
+					streamStats.numInputs += stats.numInputs;
+					streamStats.numChunks += stats.numChunks;
+					streamStats.numChars += stats.numChars;
+					streamStats.numStalls += stats.numStalls;
+					streamStats.maxReordered = max(streamStats.maxReordered, stats.maxReordered);
+				}
+				else
+				{
+					for (string line; getline(in, line);)
+					{
+						printResult(kw, line, topn, score, *out);
+						++lines;
+						bytes += line.size();
+					}
 				}
 			}
 		}
@@ -105,6 +146,28 @@ int run(const string& modelPath, bool benchmark, const string& output, const str
 			cout << "Elapsed per line: " << tm / lines << " ms" << endl;
 			cout << "Elapsed per KB: " << tm / (bytes / 1024.) << " ms" << endl;
 			cout << "KB per second: " << (bytes / 1024.) / (tm / 1000) << " KB" << endl;
+			if (streamStats.numInputs)
+			{
+				cout << "Threads: " << threads << ", Chunks: " << streamStats.numChunks << endl;
+				cout << "Head-of-line stalls: " << streamStats.numStalls << ", Max reordered: " << streamStats.maxReordered << endl;
+			}
+			auto stats = kw.getStats();
+			if (stats.numAnalyzed)
+			{
+				cout << "-- Stages (total " << stats.totalTime() * 1000 << " ms in " << stats.numAnalyzed << " calls)" << endl;
+				cout << "Normalize: " << stats.normalizeTime * 1000 << " ms" << endl;
+				cout << "SplitByTrie: " << stats.splitTime * 1000 << " ms, " << stats.numSplits << " graphs, "
+					<< stats.numNodes << " nodes (" << stats.numTypoNodes << " typo)" << endl;
+				cout << "FindBestPath: " << stats.pathTime * 1000 << " ms, " << stats.numPathsEvaluated << " paths evaluated, "
+					<< stats.numPathsPruned << " pruned, " << stats.numLmCalls << " LM calls (cache hit rate: " << stats.lmCache.hitRate() << ")" << endl;
+				if (memo > 0) cout << "Memoized graphs reused: " << stats.numMemoHits << " / " << stats.numSplits << endl;
+				cout << "InsertPath: " << stats.insertTime * 1000 << " ms" << endl;
+			}
+			if (cache > 0)
+			{
+				cout << "Result cache hits: " << stats.resultCache.hits << ", misses: " << stats.resultCache.misses
+					<< " (hit rate: " << stats.resultCache.hitRate() << ")" << endl;
+			}
 			cout << "====================\n" << endl;
 		}
 		return 0;
@@ -133,6 +196,11 @@ int main(int argc, const char* argv[])
 	ValueArg<float> typos{ "", "typos", "typo cost weight", false, 0.f, "float >= 0" };
 	SwitchArg sbg{ "", "sbg", "use SkipBigram" };
 	SwitchArg score{ "s", "score", "print score together" };
+	ValueArg<int> threads{ "j", "threads", "number of threads for analyzing input files", false, 1, "int > 0" };
+	ValueArg<int> window{ "", "window", "max number of lines in flight when using multiple threads", false, 0, "int >= 0" };
+	ValueArg<int> chunk{ "", "chunk", "split lines longer than this at sentence boundaries when using multiple threads", false, 0, "int >= 0" };
+	ValueArg<int> cache{ "", "cache", "max number of analysis results cached for repeated lines", false, 0, "int >= 0" };
+	ValueArg<int> memo{ "", "memo", "max number of sentence graphs whose best paths are memoized per thread", false, 0, "int >= 0" };
 	UnlabeledMultiArg<string> files{ "inputs", "input files", false, "string" };
 
 	cmd.add(model);
@@ -145,6 +213,11 @@ int main(int argc, const char* argv[])
 	cmd.add(files);
 	cmd.add(typos);
 	cmd.add(sbg);
+	cmd.add(threads);
+	cmd.add(window);
+	cmd.add(chunk);
+	cmd.add(cache);
+	cmd.add(memo);
 
 	try
 	{
@@ -155,6 +228,7 @@ int main(int argc, const char* argv[])
 		cerr << "error: " << e.error() << " for arg " << e.argId() << endl;
 		return -1;
 	}
-	return run(model, benchmark, output, user, topn, tolerance, typos, score, sbg, files.getValue());
+	return run(model, benchmark, output, user, topn, tolerance, typos, score, sbg, 
+		threads, window, chunk, cache, memo, files.getValue());
 }
 